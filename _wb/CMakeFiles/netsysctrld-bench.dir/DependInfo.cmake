@@ -0,0 +1,21 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/bench/BenchClient.cpp" "CMakeFiles/netsysctrld-bench.dir/bench/BenchClient.cpp.o" "gcc" "CMakeFiles/netsysctrld-bench.dir/bench/BenchClient.cpp.o.d"
+  "/root/repo/src/bench/FakeSysfsTree.cpp" "CMakeFiles/netsysctrld-bench.dir/bench/FakeSysfsTree.cpp.o" "gcc" "CMakeFiles/netsysctrld-bench.dir/bench/FakeSysfsTree.cpp.o.d"
+  "/root/repo/src/bench/LoadBench.cpp" "CMakeFiles/netsysctrld-bench.dir/bench/LoadBench.cpp.o" "gcc" "CMakeFiles/netsysctrld-bench.dir/bench/LoadBench.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
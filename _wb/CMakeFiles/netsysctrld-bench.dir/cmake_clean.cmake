@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/netsysctrld-bench.dir/bench/BenchClient.cpp.o"
+  "CMakeFiles/netsysctrld-bench.dir/bench/BenchClient.cpp.o.d"
+  "CMakeFiles/netsysctrld-bench.dir/bench/FakeSysfsTree.cpp.o"
+  "CMakeFiles/netsysctrld-bench.dir/bench/FakeSysfsTree.cpp.o.d"
+  "CMakeFiles/netsysctrld-bench.dir/bench/LoadBench.cpp.o"
+  "CMakeFiles/netsysctrld-bench.dir/bench/LoadBench.cpp.o.d"
+  "netsysctrld-bench"
+  "netsysctrld-bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/netsysctrld-bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
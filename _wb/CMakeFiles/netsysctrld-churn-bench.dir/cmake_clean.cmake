@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/netsysctrld-churn-bench.dir/bench/BenchClient.cpp.o"
+  "CMakeFiles/netsysctrld-churn-bench.dir/bench/BenchClient.cpp.o.d"
+  "CMakeFiles/netsysctrld-churn-bench.dir/bench/ChurnBench.cpp.o"
+  "CMakeFiles/netsysctrld-churn-bench.dir/bench/ChurnBench.cpp.o.d"
+  "netsysctrld-churn-bench"
+  "netsysctrld-churn-bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/netsysctrld-churn-bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,30 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/bench/FakeSysfsTree.cpp" "CMakeFiles/netsysctrld-gpio-bench.dir/bench/FakeSysfsTree.cpp.o" "gcc" "CMakeFiles/netsysctrld-gpio-bench.dir/bench/FakeSysfsTree.cpp.o.d"
+  "/root/repo/src/bench/GpioBench.cpp" "CMakeFiles/netsysctrld-gpio-bench.dir/bench/GpioBench.cpp.o" "gcc" "CMakeFiles/netsysctrld-gpio-bench.dir/bench/GpioBench.cpp.o.d"
+  "/root/repo/src/gpio/CachedFdGpioBackend.cpp" "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/CachedFdGpioBackend.cpp.o" "gcc" "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/CachedFdGpioBackend.cpp.o.d"
+  "/root/repo/src/gpio/GpioController.cpp" "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/GpioController.cpp.o" "gcc" "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/GpioController.cpp.o.d"
+  "/root/repo/src/gpio/GpioInputMonitor.cpp" "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/GpioInputMonitor.cpp.o" "gcc" "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/GpioInputMonitor.cpp.o.d"
+  "/root/repo/src/gpio/GpioPatternPlayer.cpp" "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/GpioPatternPlayer.cpp.o" "gcc" "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/GpioPatternPlayer.cpp.o.d"
+  "/root/repo/src/gpio/GpioStateFile.cpp" "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/GpioStateFile.cpp.o" "gcc" "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/GpioStateFile.cpp.o.d"
+  "/root/repo/src/gpio/InMemoryGpioBackend.cpp" "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/InMemoryGpioBackend.cpp.o" "gcc" "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/InMemoryGpioBackend.cpp.o.d"
+  "/root/repo/src/gpio/SoftPwmEngine.cpp" "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/SoftPwmEngine.cpp.o" "gcc" "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/SoftPwmEngine.cpp.o.d"
+  "/root/repo/src/gpio/SysfsGpioBackend.cpp" "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/SysfsGpioBackend.cpp.o" "gcc" "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/SysfsGpioBackend.cpp.o.d"
+  "/root/repo/src/metrics/MetricsRegistry.cpp" "CMakeFiles/netsysctrld-gpio-bench.dir/metrics/MetricsRegistry.cpp.o" "gcc" "CMakeFiles/netsysctrld-gpio-bench.dir/metrics/MetricsRegistry.cpp.o.d"
+  "/root/repo/src/scheduler/TimerWheel.cpp" "CMakeFiles/netsysctrld-gpio-bench.dir/scheduler/TimerWheel.cpp.o" "gcc" "CMakeFiles/netsysctrld-gpio-bench.dir/scheduler/TimerWheel.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
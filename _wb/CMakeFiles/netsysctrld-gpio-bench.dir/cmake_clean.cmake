@@ -0,0 +1,33 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/netsysctrld-gpio-bench.dir/bench/FakeSysfsTree.cpp.o"
+  "CMakeFiles/netsysctrld-gpio-bench.dir/bench/FakeSysfsTree.cpp.o.d"
+  "CMakeFiles/netsysctrld-gpio-bench.dir/bench/GpioBench.cpp.o"
+  "CMakeFiles/netsysctrld-gpio-bench.dir/bench/GpioBench.cpp.o.d"
+  "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/CachedFdGpioBackend.cpp.o"
+  "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/CachedFdGpioBackend.cpp.o.d"
+  "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/GpioController.cpp.o"
+  "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/GpioController.cpp.o.d"
+  "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/GpioInputMonitor.cpp.o"
+  "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/GpioInputMonitor.cpp.o.d"
+  "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/GpioPatternPlayer.cpp.o"
+  "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/GpioPatternPlayer.cpp.o.d"
+  "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/GpioStateFile.cpp.o"
+  "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/GpioStateFile.cpp.o.d"
+  "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/InMemoryGpioBackend.cpp.o"
+  "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/InMemoryGpioBackend.cpp.o.d"
+  "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/SoftPwmEngine.cpp.o"
+  "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/SoftPwmEngine.cpp.o.d"
+  "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/SysfsGpioBackend.cpp.o"
+  "CMakeFiles/netsysctrld-gpio-bench.dir/gpio/SysfsGpioBackend.cpp.o.d"
+  "CMakeFiles/netsysctrld-gpio-bench.dir/metrics/MetricsRegistry.cpp.o"
+  "CMakeFiles/netsysctrld-gpio-bench.dir/metrics/MetricsRegistry.cpp.o.d"
+  "CMakeFiles/netsysctrld-gpio-bench.dir/scheduler/TimerWheel.cpp.o"
+  "CMakeFiles/netsysctrld-gpio-bench.dir/scheduler/TimerWheel.cpp.o.d"
+  "netsysctrld-gpio-bench"
+  "netsysctrld-gpio-bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/netsysctrld-gpio-bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,43 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/bench/HotPathBench.cpp" "CMakeFiles/netsysctrld-hotpath-bench.dir/bench/HotPathBench.cpp.o" "gcc" "CMakeFiles/netsysctrld-hotpath-bench.dir/bench/HotPathBench.cpp.o.d"
+  "/root/repo/src/command/CommandParser.cpp" "CMakeFiles/netsysctrld-hotpath-bench.dir/command/CommandParser.cpp.o" "gcc" "CMakeFiles/netsysctrld-hotpath-bench.dir/command/CommandParser.cpp.o.d"
+  "/root/repo/src/gpio/CachedFdGpioBackend.cpp" "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/CachedFdGpioBackend.cpp.o" "gcc" "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/CachedFdGpioBackend.cpp.o.d"
+  "/root/repo/src/gpio/GpioController.cpp" "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/GpioController.cpp.o" "gcc" "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/GpioController.cpp.o.d"
+  "/root/repo/src/gpio/GpioInputMonitor.cpp" "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/GpioInputMonitor.cpp.o" "gcc" "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/GpioInputMonitor.cpp.o.d"
+  "/root/repo/src/gpio/GpioPatternPlayer.cpp" "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/GpioPatternPlayer.cpp.o" "gcc" "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/GpioPatternPlayer.cpp.o.d"
+  "/root/repo/src/gpio/GpioStateFile.cpp" "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/GpioStateFile.cpp.o" "gcc" "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/GpioStateFile.cpp.o.d"
+  "/root/repo/src/gpio/InMemoryGpioBackend.cpp" "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/InMemoryGpioBackend.cpp.o" "gcc" "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/InMemoryGpioBackend.cpp.o.d"
+  "/root/repo/src/gpio/SoftPwmEngine.cpp" "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/SoftPwmEngine.cpp.o" "gcc" "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/SoftPwmEngine.cpp.o.d"
+  "/root/repo/src/gpio/SysfsGpioBackend.cpp" "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/SysfsGpioBackend.cpp.o" "gcc" "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/SysfsGpioBackend.cpp.o.d"
+  "/root/repo/src/journal/CommandJournal.cpp" "CMakeFiles/netsysctrld-hotpath-bench.dir/journal/CommandJournal.cpp.o" "gcc" "CMakeFiles/netsysctrld-hotpath-bench.dir/journal/CommandJournal.cpp.o.d"
+  "/root/repo/src/journal/JournalFormat.cpp" "CMakeFiles/netsysctrld-hotpath-bench.dir/journal/JournalFormat.cpp.o" "gcc" "CMakeFiles/netsysctrld-hotpath-bench.dir/journal/JournalFormat.cpp.o.d"
+  "/root/repo/src/metrics/MetricsRegistry.cpp" "CMakeFiles/netsysctrld-hotpath-bench.dir/metrics/MetricsRegistry.cpp.o" "gcc" "CMakeFiles/netsysctrld-hotpath-bench.dir/metrics/MetricsRegistry.cpp.o.d"
+  "/root/repo/src/metrics/RequestTracer.cpp" "CMakeFiles/netsysctrld-hotpath-bench.dir/metrics/RequestTracer.cpp.o" "gcc" "CMakeFiles/netsysctrld-hotpath-bench.dir/metrics/RequestTracer.cpp.o.d"
+  "/root/repo/src/network/PrometheusExporter.cpp" "CMakeFiles/netsysctrld-hotpath-bench.dir/network/PrometheusExporter.cpp.o" "gcc" "CMakeFiles/netsysctrld-hotpath-bench.dir/network/PrometheusExporter.cpp.o.d"
+  "/root/repo/src/network/SocketWrapper.cpp" "CMakeFiles/netsysctrld-hotpath-bench.dir/network/SocketWrapper.cpp.o" "gcc" "CMakeFiles/netsysctrld-hotpath-bench.dir/network/SocketWrapper.cpp.o.d"
+  "/root/repo/src/network/StateJournal.cpp" "CMakeFiles/netsysctrld-hotpath-bench.dir/network/StateJournal.cpp.o" "gcc" "CMakeFiles/netsysctrld-hotpath-bench.dir/network/StateJournal.cpp.o.d"
+  "/root/repo/src/network/TcpServer.cpp" "CMakeFiles/netsysctrld-hotpath-bench.dir/network/TcpServer.cpp.o" "gcc" "CMakeFiles/netsysctrld-hotpath-bench.dir/network/TcpServer.cpp.o.d"
+  "/root/repo/src/network/TopicSubscriptions.cpp" "CMakeFiles/netsysctrld-hotpath-bench.dir/network/TopicSubscriptions.cpp.o" "gcc" "CMakeFiles/netsysctrld-hotpath-bench.dir/network/TopicSubscriptions.cpp.o.d"
+  "/root/repo/src/scheduler/TimerWheel.cpp" "CMakeFiles/netsysctrld-hotpath-bench.dir/scheduler/TimerWheel.cpp.o" "gcc" "CMakeFiles/netsysctrld-hotpath-bench.dir/scheduler/TimerWheel.cpp.o.d"
+  "/root/repo/src/system/AmixerCoprocess.cpp" "CMakeFiles/netsysctrld-hotpath-bench.dir/system/AmixerCoprocess.cpp.o" "gcc" "CMakeFiles/netsysctrld-hotpath-bench.dir/system/AmixerCoprocess.cpp.o.d"
+  "/root/repo/src/system/AmixerMixerBackend.cpp" "CMakeFiles/netsysctrld-hotpath-bench.dir/system/AmixerMixerBackend.cpp.o" "gcc" "CMakeFiles/netsysctrld-hotpath-bench.dir/system/AmixerMixerBackend.cpp.o.d"
+  "/root/repo/src/system/ExecService.cpp" "CMakeFiles/netsysctrld-hotpath-bench.dir/system/ExecService.cpp.o" "gcc" "CMakeFiles/netsysctrld-hotpath-bench.dir/system/ExecService.cpp.o.d"
+  "/root/repo/src/system/FakeMixerBackend.cpp" "CMakeFiles/netsysctrld-hotpath-bench.dir/system/FakeMixerBackend.cpp.o" "gcc" "CMakeFiles/netsysctrld-hotpath-bench.dir/system/FakeMixerBackend.cpp.o.d"
+  "/root/repo/src/system/SystemUtils.cpp" "CMakeFiles/netsysctrld-hotpath-bench.dir/system/SystemUtils.cpp.o" "gcc" "CMakeFiles/netsysctrld-hotpath-bench.dir/system/SystemUtils.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,59 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/bench/HotPathBench.cpp.o"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/bench/HotPathBench.cpp.o.d"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/command/CommandParser.cpp.o"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/command/CommandParser.cpp.o.d"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/CachedFdGpioBackend.cpp.o"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/CachedFdGpioBackend.cpp.o.d"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/GpioController.cpp.o"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/GpioController.cpp.o.d"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/GpioInputMonitor.cpp.o"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/GpioInputMonitor.cpp.o.d"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/GpioPatternPlayer.cpp.o"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/GpioPatternPlayer.cpp.o.d"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/GpioStateFile.cpp.o"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/GpioStateFile.cpp.o.d"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/InMemoryGpioBackend.cpp.o"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/InMemoryGpioBackend.cpp.o.d"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/SoftPwmEngine.cpp.o"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/SoftPwmEngine.cpp.o.d"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/SysfsGpioBackend.cpp.o"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/gpio/SysfsGpioBackend.cpp.o.d"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/journal/CommandJournal.cpp.o"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/journal/CommandJournal.cpp.o.d"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/journal/JournalFormat.cpp.o"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/journal/JournalFormat.cpp.o.d"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/metrics/MetricsRegistry.cpp.o"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/metrics/MetricsRegistry.cpp.o.d"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/metrics/RequestTracer.cpp.o"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/metrics/RequestTracer.cpp.o.d"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/network/PrometheusExporter.cpp.o"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/network/PrometheusExporter.cpp.o.d"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/network/SocketWrapper.cpp.o"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/network/SocketWrapper.cpp.o.d"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/network/StateJournal.cpp.o"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/network/StateJournal.cpp.o.d"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/network/TcpServer.cpp.o"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/network/TcpServer.cpp.o.d"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/network/TopicSubscriptions.cpp.o"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/network/TopicSubscriptions.cpp.o.d"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/scheduler/TimerWheel.cpp.o"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/scheduler/TimerWheel.cpp.o.d"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/system/AmixerCoprocess.cpp.o"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/system/AmixerCoprocess.cpp.o.d"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/system/AmixerMixerBackend.cpp.o"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/system/AmixerMixerBackend.cpp.o.d"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/system/ExecService.cpp.o"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/system/ExecService.cpp.o.d"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/system/FakeMixerBackend.cpp.o"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/system/FakeMixerBackend.cpp.o.d"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/system/SystemUtils.cpp.o"
+  "CMakeFiles/netsysctrld-hotpath-bench.dir/system/SystemUtils.cpp.o.d"
+  "netsysctrld-hotpath-bench"
+  "netsysctrld-hotpath-bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/netsysctrld-hotpath-bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
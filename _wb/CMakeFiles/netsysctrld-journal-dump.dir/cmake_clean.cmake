@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/netsysctrld-journal-dump.dir/journal/JournalFormat.cpp.o"
+  "CMakeFiles/netsysctrld-journal-dump.dir/journal/JournalFormat.cpp.o.d"
+  "CMakeFiles/netsysctrld-journal-dump.dir/tools/JournalDump.cpp.o"
+  "CMakeFiles/netsysctrld-journal-dump.dir/tools/JournalDump.cpp.o.d"
+  "netsysctrld-journal-dump"
+  "netsysctrld-journal-dump.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/netsysctrld-journal-dump.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,63 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/netsysctrld.dir/command/CommandParser.cpp.o"
+  "CMakeFiles/netsysctrld.dir/command/CommandParser.cpp.o.d"
+  "CMakeFiles/netsysctrld.dir/daemon/arg_parser/ArgParser.cpp.o"
+  "CMakeFiles/netsysctrld.dir/daemon/arg_parser/ArgParser.cpp.o.d"
+  "CMakeFiles/netsysctrld.dir/daemon/arg_parser/ArgParserFunction.cpp.o"
+  "CMakeFiles/netsysctrld.dir/daemon/arg_parser/ArgParserFunction.cpp.o.d"
+  "CMakeFiles/netsysctrld.dir/daemon/netsysctrld.cpp.o"
+  "CMakeFiles/netsysctrld.dir/daemon/netsysctrld.cpp.o.d"
+  "CMakeFiles/netsysctrld.dir/gpio/CachedFdGpioBackend.cpp.o"
+  "CMakeFiles/netsysctrld.dir/gpio/CachedFdGpioBackend.cpp.o.d"
+  "CMakeFiles/netsysctrld.dir/gpio/GpioController.cpp.o"
+  "CMakeFiles/netsysctrld.dir/gpio/GpioController.cpp.o.d"
+  "CMakeFiles/netsysctrld.dir/gpio/GpioInputMonitor.cpp.o"
+  "CMakeFiles/netsysctrld.dir/gpio/GpioInputMonitor.cpp.o.d"
+  "CMakeFiles/netsysctrld.dir/gpio/GpioPatternPlayer.cpp.o"
+  "CMakeFiles/netsysctrld.dir/gpio/GpioPatternPlayer.cpp.o.d"
+  "CMakeFiles/netsysctrld.dir/gpio/GpioStateFile.cpp.o"
+  "CMakeFiles/netsysctrld.dir/gpio/GpioStateFile.cpp.o.d"
+  "CMakeFiles/netsysctrld.dir/gpio/InMemoryGpioBackend.cpp.o"
+  "CMakeFiles/netsysctrld.dir/gpio/InMemoryGpioBackend.cpp.o.d"
+  "CMakeFiles/netsysctrld.dir/gpio/SoftPwmEngine.cpp.o"
+  "CMakeFiles/netsysctrld.dir/gpio/SoftPwmEngine.cpp.o.d"
+  "CMakeFiles/netsysctrld.dir/gpio/SysfsGpioBackend.cpp.o"
+  "CMakeFiles/netsysctrld.dir/gpio/SysfsGpioBackend.cpp.o.d"
+  "CMakeFiles/netsysctrld.dir/journal/CommandJournal.cpp.o"
+  "CMakeFiles/netsysctrld.dir/journal/CommandJournal.cpp.o.d"
+  "CMakeFiles/netsysctrld.dir/journal/JournalFormat.cpp.o"
+  "CMakeFiles/netsysctrld.dir/journal/JournalFormat.cpp.o.d"
+  "CMakeFiles/netsysctrld.dir/metrics/MetricsRegistry.cpp.o"
+  "CMakeFiles/netsysctrld.dir/metrics/MetricsRegistry.cpp.o.d"
+  "CMakeFiles/netsysctrld.dir/metrics/RequestTracer.cpp.o"
+  "CMakeFiles/netsysctrld.dir/metrics/RequestTracer.cpp.o.d"
+  "CMakeFiles/netsysctrld.dir/network/PrometheusExporter.cpp.o"
+  "CMakeFiles/netsysctrld.dir/network/PrometheusExporter.cpp.o.d"
+  "CMakeFiles/netsysctrld.dir/network/SocketWrapper.cpp.o"
+  "CMakeFiles/netsysctrld.dir/network/SocketWrapper.cpp.o.d"
+  "CMakeFiles/netsysctrld.dir/network/StateJournal.cpp.o"
+  "CMakeFiles/netsysctrld.dir/network/StateJournal.cpp.o.d"
+  "CMakeFiles/netsysctrld.dir/network/TcpServer.cpp.o"
+  "CMakeFiles/netsysctrld.dir/network/TcpServer.cpp.o.d"
+  "CMakeFiles/netsysctrld.dir/network/TopicSubscriptions.cpp.o"
+  "CMakeFiles/netsysctrld.dir/network/TopicSubscriptions.cpp.o.d"
+  "CMakeFiles/netsysctrld.dir/scheduler/TimerWheel.cpp.o"
+  "CMakeFiles/netsysctrld.dir/scheduler/TimerWheel.cpp.o.d"
+  "CMakeFiles/netsysctrld.dir/system/AmixerCoprocess.cpp.o"
+  "CMakeFiles/netsysctrld.dir/system/AmixerCoprocess.cpp.o.d"
+  "CMakeFiles/netsysctrld.dir/system/AmixerMixerBackend.cpp.o"
+  "CMakeFiles/netsysctrld.dir/system/AmixerMixerBackend.cpp.o.d"
+  "CMakeFiles/netsysctrld.dir/system/ExecService.cpp.o"
+  "CMakeFiles/netsysctrld.dir/system/ExecService.cpp.o.d"
+  "CMakeFiles/netsysctrld.dir/system/FakeMixerBackend.cpp.o"
+  "CMakeFiles/netsysctrld.dir/system/FakeMixerBackend.cpp.o.d"
+  "CMakeFiles/netsysctrld.dir/system/SystemUtils.cpp.o"
+  "CMakeFiles/netsysctrld.dir/system/SystemUtils.cpp.o.d"
+  "netsysctrld"
+  "netsysctrld.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/netsysctrld.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,294 @@
+/*
+ * BenchClient.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+// System Includes
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+// Project Includes
+#include "BenchClient.hpp"
+
+// Static Initialization
+
+const std::string BenchClient::END_OF_RESPONSE = "~EOR\n";
+
+static const std::chrono::seconds DAEMON_START_TIMEOUT{5};
+
+BenchClient::BenchClient(const std::string& host, uint16_t port):
+        socketFd(-1)
+{
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+
+    int gaiErr = getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses);
+    if (gaiErr != 0)
+    {
+        throw std::runtime_error("Unable to resolve " + host + "; " + gai_strerror(gaiErr));
+    }
+
+    int connectErrno = 0;
+    for (addrinfo* address = addresses; address != nullptr; address = address->ai_next)
+    {
+        socketFd = socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC,
+                address->ai_protocol);
+        if (socketFd < 0)
+        {
+            connectErrno = errno;
+            continue;
+        }
+        if (connect(socketFd, address->ai_addr, address->ai_addrlen) == 0)
+        {
+            break;
+        }
+        connectErrno = errno;
+        close(socketFd);
+        socketFd = -1;
+    }
+    freeaddrinfo(addresses);
+
+    if (socketFd < 0)
+    {
+        throw std::runtime_error("Unable to connect to " + host + ":" + std::to_string(port) +
+                "; " + std::strerror(connectErrno));
+    }
+
+    int noDelay = 1;
+    setsockopt(socketFd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+}
+
+BenchClient::~BenchClient()
+{
+    if (socketFd >= 0)
+    {
+        close(socketFd);
+    }
+}
+
+void BenchClient::send(const std::string& data)
+{
+    size_t sent = 0;
+    while (sent < data.length())
+    {
+        ssize_t sentNow = ::send(socketFd, data.data() + sent, data.length() - sent, MSG_NOSIGNAL);
+        if (sentNow < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw std::runtime_error(std::string("send failed; ") + std::strerror(errno));
+        }
+        sent += static_cast<size_t>(sentNow);
+    }
+}
+
+/**
+ * Appends whatever the socket has to received, blocking until it has some
+ */
+void BenchClient::receiveMore()
+{
+    char buffer[65536];
+    ssize_t receivedNow;
+    do
+    {
+        receivedNow = recv(socketFd, buffer, sizeof(buffer), 0);
+    } while (receivedNow < 0 && errno == EINTR);
+
+    if (receivedNow <= 0)
+    {
+        throw std::runtime_error(receivedNow == 0 ? std::string("connection closed by the daemon") :
+                std::string("recv failed; ") + std::strerror(errno));
+    }
+    received.append(buffer, static_cast<size_t>(receivedNow));
+}
+
+std::vector<std::string> BenchClient::receiveResponses()
+{
+    receiveMore();
+
+    std::vector<std::string> responses;
+    size_t responseStart = 0;
+    size_t searchPos = 0;
+    while ((searchPos = received.find(END_OF_RESPONSE, searchPos)) != std::string::npos)
+    {
+        // Only a whole line ends a response
+        if (searchPos == 0 || received[searchPos - 1] == '\n')
+        {
+            responses.push_back(received.substr(responseStart, searchPos - responseStart));
+            responseStart = searchPos + END_OF_RESPONSE.length();
+        }
+        searchPos += END_OF_RESPONSE.length();
+    }
+    received.erase(0, responseStart);
+
+    return responses;
+}
+
+std::string BenchClient::receiveLine()
+{
+    size_t newlinePos;
+    while ((newlinePos = received.find('\n')) == std::string::npos)
+    {
+        receiveMore();
+    }
+
+    std::string line = received.substr(0, newlinePos);
+    received.erase(0, newlinePos + 1);
+    return line;
+}
+
+void BenchClient::authenticate(const std::string& password)
+{
+    while (receiveResponses().empty())
+    {
+    }
+
+    // The daemon drops the last character before the newline, as telnet
+    // ends lines with "\r\n"
+    send(password + "\r\n");
+
+    std::vector<std::string> responses;
+    while ((responses = receiveResponses()).empty())
+    {
+    }
+    if (responses.front().find("~AUTH_SUCCESSFUL") == std::string::npos)
+    {
+        throw std::runtime_error("The daemon refused the password");
+    }
+}
+
+void BenchClient::shutdown()
+{
+    ::shutdown(socketFd, SHUT_RDWR);
+}
+
+void BenchClient::abort()
+{
+    linger resetOnClose = {1, 0};
+    setsockopt(socketFd, SOL_SOCKET, SO_LINGER, &resetOnClose, sizeof(resetOnClose));
+    close(socketFd);
+    socketFd = -1;
+}
+
+BenchDaemon::BenchDaemon(const std::string& daemonPath, const std::string& host, uint16_t port,
+        const std::vector<std::string>& args):
+        pid(-1),
+        exited(false)
+{
+    std::vector<std::string> argStrings {daemonPath, "-P", std::to_string(port)};
+    argStrings.insert(argStrings.end(), args.begin(), args.end());
+
+    pid = fork();
+    if (pid < 0)
+    {
+        throw std::runtime_error(std::string("fork failed; ") + std::strerror(errno));
+    }
+    if (pid == 0)
+    {
+        int devNull = open("/dev/null", O_WRONLY);
+        dup2(devNull, STDOUT_FILENO);
+
+        std::vector<char*> argv;
+        for (std::string& arg : argStrings)
+        {
+            argv.push_back(&arg[0]);
+        }
+        argv.push_back(nullptr);
+        execv(argv[0], argv.data());
+        std::perror("execv");
+        _exit(127);
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + DAEMON_START_TIMEOUT;
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        if (!isRunning())
+        {
+            throw std::runtime_error("The daemon exited during startup");
+        }
+
+        try
+        {
+            BenchClient probe(host, port);
+            return;
+        }
+        catch (const std::runtime_error&)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+
+    stop();
+    throw std::runtime_error("The daemon didn't accept connections within " +
+            std::to_string(DAEMON_START_TIMEOUT.count()) + "s");
+}
+
+BenchDaemon::~BenchDaemon()
+{
+    stop();
+}
+
+pid_t BenchDaemon::getPid() const
+{
+    return pid;
+}
+
+bool BenchDaemon::isRunning()
+{
+    if (!exited && waitpid(pid, nullptr, WNOHANG) == pid)
+    {
+        exited = true;
+    }
+    return !exited;
+}
+
+bool BenchDaemon::stop()
+{
+    if (!isRunning())
+    {
+        return false;
+    }
+
+    kill(pid, SIGTERM);
+    waitpid(pid, nullptr, 0);
+    exited = true;
+    return true;
+}
+
+/**
+ * Reads VmHWM from /proc/<pid>/status
+ */
+uint64_t getPeakRssKb(pid_t pid)
+{
+    std::ifstream status("/proc/" + std::to_string(pid) + "/status");
+    std::string field;
+    while (status >> field)
+    {
+        if (field == "VmHWM:")
+        {
+            uint64_t peakRssKb = 0;
+            status >> peakRssKb;
+            return peakRssKb;
+        }
+    }
+    return 0;
+}
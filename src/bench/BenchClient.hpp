@@ -0,0 +1,98 @@
+/*
+ * BenchClient.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+#ifndef BENCH_BENCHCLIENT_HPP_
+#define BENCH_BENCHCLIENT_HPP_
+
+// System Includes
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+// Project Includes
+// <none>
+
+/**
+ * A blocking client connection to a daemon, speaking its line protocol over
+ * a plain socket so that the benchmarks measure the daemon rather than a
+ * client library. Every function throws a std::runtime_error on failure,
+ * including the daemon closing the connection.
+ */
+class BenchClient
+{
+public:
+    // Connects with Nagle's algorithm off, so pipelined requests aren't held back
+    BenchClient(const std::string& host, uint16_t port);
+    ~BenchClient();
+
+    BenchClient(const BenchClient&) = delete;
+    BenchClient& operator=(const BenchClient&) = delete;
+
+    void send(const std::string& data);
+
+    // Reads once, and removes and returns each complete response received
+    std::vector<std::string> receiveResponses();
+
+    // Reads until a whole line has been received, and returns it without its
+    // newline
+    std::string receiveLine();
+
+    // Answers the daemon's password prompt
+    void authenticate(const std::string& password);
+
+    // Wakes any thread blocked receiving, which then throws
+    void shutdown();
+
+    // Closes with a reset rather than an orderly shutdown, as a client which
+    // crashed or lost its network would
+    void abort();
+
+private:
+    void receiveMore();
+
+    int socketFd;
+    std::string received;
+
+    static const std::string END_OF_RESPONSE;
+};
+
+/**
+ * A daemon started for a benchmark run, with its stdout discarded since it
+ * logs every request. Its stderr is left alone, so sanitizer reports from an
+ * instrumented build are seen. Killed on destruction.
+ */
+class BenchDaemon
+{
+public:
+    // Starts daemonPath on port with args, and waits until it accepts
+    // connections on host. Throws a std::runtime_error if it exits or
+    // doesn't start listening in time.
+    BenchDaemon(const std::string& daemonPath, const std::string& host, uint16_t port,
+            const std::vector<std::string>& args);
+    ~BenchDaemon();
+
+    BenchDaemon(const BenchDaemon&) = delete;
+    BenchDaemon& operator=(const BenchDaemon&) = delete;
+
+    pid_t getPid() const;
+
+    // False once the daemon has exited, e.g. on a sanitizer error
+    bool isRunning();
+
+    // Stops the daemon with SIGTERM; returns false if it had already exited
+    bool stop();
+
+private:
+    pid_t pid;
+    bool exited;
+};
+
+// The peak resident set size of pid in kB, or 0 if it can't be read
+uint64_t getPeakRssKb(pid_t pid);
+
+#endif /* BENCH_BENCHCLIENT_HPP_ */
@@ -0,0 +1,440 @@
+/*
+ * ChurnBench.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ *
+ * Stress harness for connection churn during broadcasts. Churn threads
+ * repeatedly connect, answer the password prompt if a password is given,
+ * subscribe with SUBSCRIBE=volume and disconnect; every other cycle resets
+ * the connection straight after subscribing, without reading the response.
+ * Meanwhile a set of long lived subscribers listen for volume events, and a
+ * broadcaster changes the volume at a fixed interval, so that clients are
+ * added to and removed from the daemon's client list while events are
+ * being sent to it.
+ *
+ * Reports the churn connect rate, the latency from each VOLUME request being
+ * sent until the last subscriber has received its event, and the daemon's
+ * peak RSS. Afterwards, CLIENTS_INFO must list exactly the subscribers and
+ * the broadcaster; any other count, a subscriber receiving anything but
+ * whole volume events, or the daemon exiting, fails the run.
+ *
+ * With -S, a daemon is started for the run with the fake mixer and its
+ * stderr left visible. Pointing -S at a daemon built with
+ * -DNETSYSCTRLD_SANITIZE=thread or address turns the run into a race and
+ * use-after-free check; an ASan error exits the daemon, and ThreadSanitizer
+ * does too with TSAN_OPTIONS=halt_on_error=1. Otherwise the daemon at -H/-P
+ * is used as is, and -r gives its pid for the peak RSS.
+ */
+
+// System Includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// Project Includes
+#include "BenchClient.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static const std::string VOLUME_EVENT_PREFIX = "~VOLUME: ";
+static const std::string CLIENT_INFO_PREFIX = "\nIP: ";
+
+// How long a broadcast may take to reach every subscriber before it's
+// counted as missed
+static const std::chrono::seconds BROADCAST_TIMEOUT{1};
+
+// How long the daemon has to notice the churned connections closing
+static const std::chrono::seconds CLIENT_LIST_SETTLE_TIMEOUT{2};
+
+struct ChurnOptions
+{
+    std::string host = "127.0.0.1";
+    uint16_t port = 2018;
+    bool usePassword = false;
+    std::string password;
+    size_t churnThreads = 8;
+    size_t subscribers = 32;
+    unsigned int broadcastIntervalMs = 20;
+    double seconds = 5.0;
+    pid_t rssPid = -1;
+    std::string daemonPath;
+};
+
+// What one subscriber has received
+struct SubscriberState
+{
+    std::atomic<int> lastVolume{-1};
+    std::atomic<int64_t> lastReceivedNs{0};
+    std::atomic<uint64_t> unexpectedLines{0};
+};
+
+static void printUsage(const char* programName)
+{
+    std::cerr << "Usage: " << programName << " [-H host] [-P port] [-p password]"
+            " [-c churnThreads] [-n subscribers] [-i broadcastIntervalMs] [-s seconds]"
+            " [-r daemonPid] [-S daemonPath]" << std::endl;
+}
+
+static int64_t nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Connects, authenticates if needed, and sends command, returning once its
+ * response has been received
+ */
+static std::unique_ptr<BenchClient> connectAndSend(const ChurnOptions& options,
+        const std::string& command)
+{
+    std::unique_ptr<BenchClient> client(new BenchClient(options.host, options.port));
+    if (options.usePassword)
+    {
+        client->authenticate(options.password);
+    }
+    client->send(command);
+    while (client->receiveResponses().empty())
+    {
+    }
+    return client;
+}
+
+/**
+ * Run on each churn thread until stopping is set
+ */
+static void churn(const ChurnOptions& options, const std::atomic<bool>& stopping,
+        std::atomic<uint64_t>& cycles, std::atomic<uint64_t>& failures)
+{
+    for (uint64_t cycle = 0; !stopping; ++cycle)
+    {
+        try
+        {
+            BenchClient client(options.host, options.port);
+            if (options.usePassword)
+            {
+                client.authenticate(options.password);
+            }
+            client.send("SUBSCRIBE=volume\n");
+
+            if (cycle & 1)
+            {
+                client.abort();
+            }
+            else
+            {
+                while (client.receiveResponses().empty())
+                {
+                }
+            }
+            ++cycles;
+        }
+        catch (const std::exception&)
+        {
+            ++failures;
+        }
+    }
+}
+
+/**
+ * Run on each subscriber's thread until its connection is shut down
+ */
+static void listen(BenchClient& client, SubscriberState& state)
+{
+    try
+    {
+        while (true)
+        {
+            std::string line = client.receiveLine();
+            if (line.compare(0, VOLUME_EVENT_PREFIX.length(), VOLUME_EVENT_PREFIX) != 0)
+            {
+                ++state.unexpectedLines;
+                continue;
+            }
+
+            state.lastReceivedNs = nowNs();
+            state.lastVolume = std::stoi(line.substr(VOLUME_EVENT_PREFIX.length()));
+        }
+    }
+    catch (const std::exception&)
+    {
+    }
+}
+
+/**
+ * Returns how many clients the daemon's CLIENTS_INFO lists
+ */
+static size_t countListedClients(BenchClient& client)
+{
+    client.send("CLIENTS_INFO\n");
+    std::vector<std::string> responses;
+    while ((responses = client.receiveResponses()).empty())
+    {
+    }
+
+    const std::string& clientsInfo = responses.front();
+    size_t listed = 0;
+    for (size_t pos = clientsInfo.find(CLIENT_INFO_PREFIX); pos != std::string::npos;
+            pos = clientsInfo.find(CLIENT_INFO_PREFIX, pos + 1))
+    {
+        ++listed;
+    }
+    return listed;
+}
+
+int main(int argc, char *argv[])
+{
+    ChurnOptions options;
+
+    try
+    {
+        int option;
+        while ((option = getopt(argc, argv, "H:P:p:c:n:i:s:r:S:")) != -1)
+        {
+            switch (option)
+            {
+            case 'H': options.host = optarg; break;
+            case 'P': options.port = static_cast<uint16_t>(std::stoul(optarg)); break;
+            case 'p': options.usePassword = true; options.password = optarg; break;
+            case 'c': options.churnThreads = std::stoul(optarg); break;
+            case 'n': options.subscribers = std::stoul(optarg); break;
+            case 'i': options.broadcastIntervalMs = std::stoul(optarg); break;
+            case 's': options.seconds = std::stod(optarg); break;
+            case 'r': options.rssPid = static_cast<pid_t>(std::stol(optarg)); break;
+            case 'S': options.daemonPath = optarg; break;
+            default:
+                printUsage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        }
+
+        if (optind != argc || options.subscribers == 0 || options.seconds <= 0)
+        {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    catch (const std::exception& err)
+    {
+        std::cerr << "Invalid argument; " << err.what() << std::endl;
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::unique_ptr<BenchDaemon> daemon;
+    if (!options.daemonPath.empty())
+    {
+        std::vector<std::string> daemonArgs {"-x", "fake"};
+        if (options.usePassword)
+        {
+            daemonArgs.push_back("-p");
+            daemonArgs.push_back(options.password);
+        }
+
+        try
+        {
+            daemon.reset(new BenchDaemon(options.daemonPath, options.host, options.port,
+                    daemonArgs));
+        }
+        catch (const std::exception& err)
+        {
+            std::cerr << "Unable to start the daemon; " << err.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+        options.rssPid = daemon->getPid();
+    }
+
+    std::cout << "netsysctrld-churn-bench; " << options.host << ":" << options.port
+            << (daemon ? " (started)" : "") << "; " << options.churnThreads
+            << " churn threads; " << options.subscribers << " subscribers; broadcast every "
+            << options.broadcastIntervalMs << "ms; " << options.seconds << "s" << std::endl;
+
+    std::vector<std::unique_ptr<BenchClient>> subscriberClients;
+    std::vector<SubscriberState> subscriberStates(options.subscribers);
+    std::vector<std::thread> subscriberThreads;
+    std::unique_ptr<BenchClient> broadcaster;
+    try
+    {
+        for (size_t subscriberIdx = 0; subscriberIdx < options.subscribers; ++subscriberIdx)
+        {
+            subscriberClients.push_back(connectAndSend(options, "SUBSCRIBE=volume\n"));
+        }
+        broadcaster = connectAndSend(options, "VOLUME=0\n");
+    }
+    catch (const std::exception& err)
+    {
+        std::cerr << "Unable to connect the subscribers; " << err.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    for (size_t subscriberIdx = 0; subscriberIdx < options.subscribers; ++subscriberIdx)
+    {
+        subscriberThreads.emplace_back(listen, std::ref(*subscriberClients[subscriberIdx]),
+                std::ref(subscriberStates[subscriberIdx]));
+    }
+
+    std::atomic<bool> stopping{false};
+    std::atomic<uint64_t> churnCycles{0};
+    std::atomic<uint64_t> churnFailures{0};
+    std::vector<std::thread> churnThreads;
+    for (size_t churnIdx = 0; churnIdx < options.churnThreads; ++churnIdx)
+    {
+        churnThreads.emplace_back(churn, std::cref(options), std::cref(stopping),
+                std::ref(churnCycles), std::ref(churnFailures));
+    }
+
+    // Each broadcast is to the last subscriber, in nanoseconds
+    std::vector<uint64_t> latenciesNs;
+    uint64_t missedBroadcasts = 0;
+    std::string failure;
+
+    Clock::time_point churnStart = Clock::now();
+    auto endTime = churnStart + std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(options.seconds));
+    try
+    {
+        for (int volume = 1; Clock::now() < endTime; volume = volume % 100 + 1)
+        {
+            int64_t sentNs = nowNs();
+            broadcaster->send("VOLUME=" + std::to_string(volume) + "\n");
+            while (broadcaster->receiveResponses().empty())
+            {
+            }
+
+            auto deadline = Clock::now() + BROADCAST_TIMEOUT;
+            bool allReceived = false;
+            while (!allReceived && Clock::now() < deadline)
+            {
+                allReceived = std::all_of(subscriberStates.begin(), subscriberStates.end(),
+                        [volume](const SubscriberState& state) { return state.lastVolume == volume; });
+                if (!allReceived)
+                {
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                }
+            }
+
+            if (!allReceived)
+            {
+                ++missedBroadcasts;
+            }
+            else
+            {
+                int64_t lastReceivedNs = 0;
+                for (const SubscriberState& state : subscriberStates)
+                {
+                    lastReceivedNs = std::max<int64_t>(lastReceivedNs, state.lastReceivedNs);
+                }
+                latenciesNs.push_back(static_cast<uint64_t>(lastReceivedNs - sentNs));
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(options.broadcastIntervalMs));
+        }
+    }
+    catch (const std::exception& err)
+    {
+        failure = std::string("Broadcaster failed; ") + err.what();
+    }
+
+    stopping = true;
+    for (std::thread& churnThread : churnThreads)
+    {
+        churnThread.join();
+    }
+    double churnSeconds = std::chrono::duration<double>(Clock::now() - churnStart).count();
+
+    // Every churned client has closed, so only the subscribers and the
+    // broadcaster should be left
+    size_t expectedClients = options.subscribers + 1;
+    size_t listedClients = 0;
+    if (failure.empty())
+    {
+        try
+        {
+            auto deadline = Clock::now() + CLIENT_LIST_SETTLE_TIMEOUT;
+            while ((listedClients = countListedClients(*broadcaster)) != expectedClients &&
+                    Clock::now() < deadline)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            }
+            if (listedClients != expectedClients)
+            {
+                failure = "CLIENTS_INFO lists " + std::to_string(listedClients) +
+                        " clients; expected " + std::to_string(expectedClients);
+            }
+        }
+        catch (const std::exception& err)
+        {
+            failure = std::string("CLIENTS_INFO failed; ") + err.what();
+        }
+    }
+
+    uint64_t peakRssKb = options.rssPid > 0 ? getPeakRssKb(options.rssPid) : 0;
+
+    for (std::unique_ptr<BenchClient>& subscriberClient : subscriberClients)
+    {
+        subscriberClient->shutdown();
+    }
+    for (std::thread& subscriberThread : subscriberThreads)
+    {
+        subscriberThread.join();
+    }
+
+    uint64_t unexpectedLines = 0;
+    for (const SubscriberState& state : subscriberStates)
+    {
+        unexpectedLines += state.unexpectedLines;
+    }
+    if (failure.empty() && unexpectedLines > 0)
+    {
+        failure = std::to_string(unexpectedLines) + " lines received by subscribers "
+                "weren't volume events";
+    }
+    if (daemon && !daemon->stop())
+    {
+        failure = "The daemon exited during the run";
+    }
+
+    std::sort(latenciesNs.begin(), latenciesNs.end());
+    auto percentileUs = [&latenciesNs](double fraction)
+    {
+        if (latenciesNs.empty())
+        {
+            return 0.0;
+        }
+        size_t rank = static_cast<size_t>(std::ceil(fraction * latenciesNs.size()));
+        rank = std::max<size_t>(1, std::min(rank, latenciesNs.size()));
+        return latenciesNs[rank - 1] / 1000.0;
+    };
+
+    std::printf("Churn: %llu connections (%.0f/s), %llu failed\n",
+            static_cast<unsigned long long>(churnCycles.load()), churnCycles / churnSeconds,
+            static_cast<unsigned long long>(churnFailures.load()));
+    std::printf("Broadcast to last of %zu subscribers: %zu delivered, %llu missed;"
+            " p50 %.1fus p99 %.1fus max %.1fus\n", options.subscribers, latenciesNs.size(),
+            static_cast<unsigned long long>(missedBroadcasts), percentileUs(0.5),
+            percentileUs(0.99), percentileUs(1.0));
+    std::printf("Clients listed after churn: %zu of %zu\n", listedClients, expectedClients);
+    if (peakRssKb > 0)
+    {
+        std::printf("Daemon peak RSS: %llu kB\n", static_cast<unsigned long long>(peakRssKb));
+    }
+
+    if (!failure.empty())
+    {
+        std::cerr << "FAILED: " << failure << std::endl;
+        return EXIT_FAILURE;
+    }
+    return missedBroadcasts == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,56 @@
+/*
+ * FakeSysfsTree.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+// System Includes
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Project Includes
+#include "FakeSysfsTree.hpp"
+
+FakeSysfsTree::FakeSysfsTree(const std::vector<uint16_t>& pinNums):
+        pinNums(pinNums)
+{
+    char rootTemplate[] = "/tmp/netsysctrld-bench-XXXXXX";
+    if (mkdtemp(rootTemplate) == nullptr)
+    {
+        throw std::runtime_error("Unable to create a temporary directory");
+    }
+
+    root = rootTemplate;
+    std::ofstream(root + "/export");
+    for (uint16_t pinNum : pinNums)
+    {
+        std::string pinDir = root + "/gpio" + std::to_string(pinNum);
+        mkdir(pinDir.c_str(), 0755);
+        std::ofstream(pinDir + "/direction") << "in";
+        std::ofstream(pinDir + "/edge") << "none";
+        std::ofstream(pinDir + "/value") << "0";
+    }
+}
+
+FakeSysfsTree::~FakeSysfsTree()
+{
+    for (uint16_t pinNum : pinNums)
+    {
+        std::string pinDir = root + "/gpio" + std::to_string(pinNum);
+        unlink((pinDir + "/direction").c_str());
+        unlink((pinDir + "/edge").c_str());
+        unlink((pinDir + "/value").c_str());
+        rmdir(pinDir.c_str());
+    }
+    unlink((root + "/export").c_str());
+    rmdir(root.c_str());
+}
+
+const std::string& FakeSysfsTree::getRoot() const
+{
+    return root;
+}
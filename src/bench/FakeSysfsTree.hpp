@@ -0,0 +1,41 @@
+/*
+ * FakeSysfsTree.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+#ifndef BENCH_FAKESYSFSTREE_HPP_
+#define BENCH_FAKESYSFSTREE_HPP_
+
+// System Includes
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Project Includes
+// <none>
+
+/**
+ * A temporary directory of regular files laid out like /sys/class/gpio, with
+ * each pin already exported, so that the sysfs backends can be benchmarked
+ * on any Linux machine. Removed on destruction.
+ */
+class FakeSysfsTree
+{
+public:
+    // Throws a std::runtime_error if the directory can't be created
+    explicit FakeSysfsTree(const std::vector<uint16_t>& pinNums);
+    ~FakeSysfsTree();
+
+    FakeSysfsTree(const FakeSysfsTree&) = delete;
+    FakeSysfsTree& operator=(const FakeSysfsTree&) = delete;
+
+    const std::string& getRoot() const;
+
+private:
+    const std::vector<uint16_t> pinNums;
+    std::string root;
+};
+
+#endif /* BENCH_FAKESYSFSTREE_HPP_ */
@@ -0,0 +1,195 @@
+/*
+ * GpioBench.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ *
+ * Measures GPIO write throughput through each layer of the GPIO stack:
+ *   - backend: single pin writes straight to a backend; "sysfs" opens and
+ *     closes the value file per write, "cached-fd" keeps it open
+ *   - OUTPUT_STATE: single pin writes through GpioController
+ *   - BUS_WRITE: bulk writes of an 8 pin group through GpioController, with
+ *     every pin changing on every write
+ * Each is run against the in-memory backend and against a fake sysfs tree of
+ * regular files in a temporary directory, so the suite runs on any Linux
+ * machine. The fake tree measures syscall and bookkeeping overhead only; to
+ * include the GPIO driver, pass a real sysfs root and 8 exported-able pins.
+ *
+ * Usage: netsysctrld-gpio-bench [secondsPerCase] [sysfsRoot pin0,...,pin7]
+ */
+
+// System Includes
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Project Includes
+#include "CachedFdGpioBackend.hpp"
+#include "FakeSysfsTree.hpp"
+#include "GpioController.hpp"
+#include "InMemoryGpioBackend.hpp"
+#include "SysfsGpioBackend.hpp"
+#include "TimerWheel.hpp"
+
+static const size_t NUM_PINS = 8;
+
+/**
+ * Executes op repeatedly for seconds, and prints how many times per second
+ * it ran. opsPerCall is the number of pin writes each call performs.
+ */
+static void runCase(const std::string& name, double seconds, size_t opsPerCall,
+        const std::function<void(uint64_t)>& op)
+{
+    // Controller paths log every write; that isn't what's being measured
+    std::ostringstream discarded;
+    std::streambuf* coutBuf = std::cout.rdbuf(discarded.rdbuf());
+
+    using Clock = std::chrono::steady_clock;
+    auto startTime = Clock::now();
+    auto endTime = startTime + std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(seconds));
+    uint64_t calls = 0;
+
+    while (Clock::now() < endTime)
+    {
+        // Check the clock every 256 calls, so it doesn't dominate fast cases
+        for (int batchIdx = 0; batchIdx < 256; ++batchIdx)
+        {
+            op(calls++);
+        }
+        if ((calls & 0xfff) == 0)
+        {
+            discarded.str("");
+        }
+    }
+
+    double elapsed = std::chrono::duration<double>(Clock::now() - startTime).count();
+    std::cout.rdbuf(coutBuf);
+
+    std::printf("%-36s %12.0f calls/s %12.0f pin writes/s\n", name.c_str(),
+            calls / elapsed, calls * opsPerCall / elapsed);
+}
+
+/**
+ * Runs the single pin backend case against backend, which must already have
+ * pinNums exported as outputs
+ */
+static void benchBackend(const std::string& name, double seconds,
+        GpioBackend& backend, const std::vector<uint16_t>& pinNums)
+{
+    runCase("backend " + name, seconds, 1, [&](uint64_t call)
+    {
+        backend.writeValue(pinNums[call % pinNums.size()], (call / pinNums.size()) & 1);
+    });
+}
+
+/**
+ * Runs the GpioController cases with a controller built on backend
+ */
+static void benchController(const std::string& name, double seconds,
+        const GpioBackendSharedPtr& backend, const std::vector<uint16_t>& pinNums)
+{
+    GpioController::Builder builder;
+    std::vector<std::string> pinNames;
+    for (size_t pinIdx = 0; pinIdx < pinNums.size(); ++pinIdx)
+    {
+        pinNames.push_back("p" + std::to_string(pinIdx));
+        builder.withNamedPin(pinNames.back(), pinNums[pinIdx]);
+    }
+
+    std::ostringstream discarded;
+    std::streambuf* coutBuf = std::cout.rdbuf(discarded.rdbuf());
+    GpioControllerSharedPtr controller = builder.withPinGroup("bus", pinNames)
+            .withGpioInitializedToOutputLow()
+            .withBackend(backend)
+            .withTimerWheel(std::make_shared<TimerWheel>())
+            .build();
+    std::cout.rdbuf(coutBuf);
+
+    // Precomputed, so command formatting isn't measured
+    std::vector<std::string> pinCommands;
+    for (const std::string& pinName : pinNames)
+    {
+        pinCommands.push_back(pinName + ":1");
+        pinCommands.push_back(pinName + ":0");
+    }
+    const std::string busCommands[] = {"bus:0x55", "bus:0xaa"};
+    std::string response;
+
+    runCase("OUTPUT_STATE " + name, seconds, 1, [&](uint64_t call)
+    {
+        controller->setPinOutputState(pinCommands[call % pinCommands.size()], &response);
+    });
+    runCase("BUS_WRITE " + name, seconds, pinNums.size(), [&](uint64_t call)
+    {
+        controller->busWriteHandler(busCommands[call & 1], &response);
+    });
+}
+
+int main(int argc, const char *argv[])
+{
+    double seconds = argc > 1 ? std::atof(argv[1]) : 1.0;
+    if (seconds <= 0)
+    {
+        std::cerr << "Usage: " << argv[0] << " [secondsPerCase] [sysfsRoot pin0,...,pin7]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::vector<uint16_t> pinNums;
+    std::string sysfsRoot;
+    std::unique_ptr<FakeSysfsTree> fakeTree;
+    if (argc <= 3)
+    {
+        for (size_t pinIdx = 0; pinIdx < NUM_PINS; ++pinIdx)
+        {
+            pinNums.push_back(static_cast<uint16_t>(pinIdx));
+        }
+        fakeTree.reset(new FakeSysfsTree(pinNums));
+        sysfsRoot = fakeTree->getRoot();
+    }
+    else
+    {
+        sysfsRoot = argv[2];
+        std::stringstream pinList(argv[3]);
+        std::string pinNum;
+        while (std::getline(pinList, pinNum, ','))
+        {
+            pinNums.push_back(static_cast<uint16_t>(std::stoul(pinNum)));
+        }
+    }
+
+    std::cout << "GPIO benchmark; " << seconds << "s per case; sysfs root: "
+            << sysfsRoot << (fakeTree ? " (fake)" : "") << std::endl;
+
+    {
+        InMemoryGpioBackend inMemoryBackend;
+        inMemoryBackend.exportPins(pinNums);
+        for (uint16_t pinNum : pinNums)
+        {
+            inMemoryBackend.writeAttribute(pinNum, "direction", "low");
+        }
+        benchBackend("in-memory", seconds, inMemoryBackend, pinNums);
+    }
+    {
+        SysfsGpioBackend sysfsBackend(sysfsRoot);
+        benchBackend("sysfs", seconds, sysfsBackend, pinNums);
+    }
+    {
+        CachedFdGpioBackend cachedFdBackend(sysfsRoot);
+        benchBackend("cached-fd", seconds, cachedFdBackend, pinNums);
+    }
+
+    benchController("in-memory", seconds, std::make_shared<InMemoryGpioBackend>(), pinNums);
+    benchController("sysfs", seconds, std::make_shared<SysfsGpioBackend>(sysfsRoot), pinNums);
+    benchController("cached-fd", seconds, std::make_shared<CachedFdGpioBackend>(sysfsRoot), pinNums);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,286 @@
+/*
+ * HotPathBench.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ *
+ * Google Benchmark microbenchmarks of the in-process request path: command
+ * parsing, dispatch through CommandParser::execute(), the HELP listing, the
+ * OUTPUT_STATE parameter parser, and terminating a response with "~EOR".
+ * Each reports ns/op and, as the allocs/op counter, the heap allocations
+ * made per operation by the benchmarking thread.
+ *
+ * The components are built as the daemon builds them, with the fake mixer
+ * and the in-memory GPIO backend. Logging to stdout is discarded while
+ * measuring, so it's only the formatting cost which is included.
+ *
+ * Usage: netsysctrld-hotpath-bench [Google Benchmark flags]
+ */
+
+// System Includes
+#include <benchmark/benchmark.h>
+#include <boost/asio.hpp>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <streambuf>
+#include <string>
+
+// Project Includes
+#include "CommandParser.hpp"
+#include "GpioController.hpp"
+#include "InMemoryGpioBackend.hpp"
+#include "SocketWrapper.hpp"
+#include "SystemUtils.hpp"
+#include "TcpServer.hpp"
+#include "TimerWheel.hpp"
+
+// Heap allocations made by the calling thread
+static thread_local uint64_t threadAllocations = 0;
+
+void* operator new(size_t size)
+{
+    ++threadAllocations;
+    void* memory = std::malloc(size ? size : 1);
+    if (!memory)
+    {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    std::free(memory);
+}
+
+/**
+ * Grants access to the private functions being measured, and to the server's
+ * topics for the benchmark's client
+ */
+class HotPathBench
+{
+public:
+    static bool parse(const CommandParser& parser, const std::string& unparsedCommand,
+            std::string& command, std::string& param)
+    {
+        return parser.parse(unparsedCommand, command, param);
+    }
+
+    static std::string getCommandStringList(const CommandParser& parser)
+    {
+        return parser.getCommandStringList();
+    }
+
+    static GpioController::PinState convertPinStateCommandToPair(GpioController& controller,
+            const std::string& pinInfo)
+    {
+        return controller.convertPinStateCommandToPair(pinInfo);
+    }
+
+    static void terminateResponse(std::string& response)
+    {
+        TcpServer::terminateResponse(response);
+    }
+
+    static TopicSubscriptionsSharedPtr getTopicSubscriptions(const TcpServer& server)
+    {
+        return server.topicSubscriptions;
+    }
+};
+
+namespace
+{
+
+// Swallows everything written to it
+class NullStreamBuf : public std::streambuf
+{
+protected:
+    int overflow(int character) override
+    {
+        return traits_type::not_eof(character);
+    }
+
+    std::streamsize xsputn(const char*, std::streamsize count) override
+    {
+        return count;
+    }
+};
+
+// Discards std::cout output for its lifetime; the benchmark reporter writes
+// to std::cout too, so only the measured loops are silenced
+class SilencedCout
+{
+public:
+    SilencedCout() : coutBuf(std::cout.rdbuf(&nullStreamBuf)) {};
+    ~SilencedCout()
+    {
+        std::cout.rdbuf(coutBuf);
+    }
+
+private:
+    NullStreamBuf nullStreamBuf;
+    std::streambuf* const coutBuf;
+};
+
+// Reports the allocations made since allocationsBefore, per iteration
+void reportAllocations(benchmark::State& state, uint64_t allocationsBefore)
+{
+    state.counters["allocs/op"] = benchmark::Counter(
+            static_cast<double>(threadAllocations - allocationsBefore),
+            benchmark::Counter::kAvgIterations);
+}
+
+/**
+ * The daemon's components, and a connected client for CLIENT_CMDS to act
+ * on. The server's port is bound but never accepted on.
+ */
+struct BenchContext
+{
+    BenchContext() :
+            tcpServer(TcpServer::Builder().withPort(0).build()),
+            gpioController(GpioController::Builder()
+                    .withNamedPin("led", 5)
+                    .withGpioInitializedToOutputLow()
+                    .withBackend(std::make_shared<InMemoryGpioBackend>())
+                    .withTimerWheel(std::make_shared<TimerWheel>())
+                    .build()),
+            systemUtils(SystemUtils::Builder().withMixerType(SystemUtils::FAKE_MIXER_TYPE).build()),
+            parser(tcpServer, systemUtils, gpioController),
+            clientAcceptor(ioService, BoostTcp::endpoint(boost::asio::ip::address_v4::loopback(), 0)),
+            clientSocket(ioService),
+            serverSocket(std::make_shared<TcpSocket>(ioService))
+    {
+        clientSocket.connect(clientAcceptor.local_endpoint());
+        clientAcceptor.accept(*serverSocket);
+        client = std::make_shared<SocketWrapper>(serverSocket,
+                HotPathBench::getTopicSubscriptions(*tcpServer));
+    }
+
+    TcpServerSharedPtr tcpServer;
+    GpioControllerSharedPtr gpioController;
+    SystemUtilsSharedPtr systemUtils;
+    CommandParser parser;
+
+    boost::asio::io_service ioService;
+    BoostTcp::acceptor clientAcceptor;
+    BoostTcp::socket clientSocket;
+    TcpSocketSharedPtr serverSocket;
+    SocketWrapperSharedPtr client;
+};
+
+BenchContext& getContext()
+{
+    static BenchContext* context = nullptr;
+    if (!context)
+    {
+        SilencedCout silencedCout;
+        context = new BenchContext();
+    }
+    return *context;
+}
+
+}
+
+static void BM_Parse(benchmark::State& state, const char* unparsedCommand)
+{
+    const CommandParser& parser = getContext().parser;
+    const std::string unparsed = unparsedCommand;
+    std::string command;
+    std::string param;
+
+    uint64_t allocationsBefore = threadAllocations;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(HotPathBench::parse(parser, unparsed, command, param));
+    }
+    reportAllocations(state, allocationsBefore);
+}
+BENCHMARK_CAPTURE(BM_Parse, no_param, "GET_PINS\r");
+BENCHMARK_CAPTURE(BM_Parse, volume, "VOLUME=50\r");
+BENCHMARK_CAPTURE(BM_Parse, output_state, "OUTPUT_STATE=led:1\r");
+BENCHMARK_CAPTURE(BM_Parse, invalid, "volume 50\r");
+
+/**
+ * The command tables are searched in order, so the position of the command
+ * determines how many entries are compared before its handler runs
+ */
+static void BM_Execute(benchmark::State& state, const char* unparsedCommand)
+{
+    BenchContext& context = getContext();
+    const std::string unparsed = unparsedCommand;
+    SilencedCout silencedCout;
+
+    uint64_t allocationsBefore = threadAllocations;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(context.parser.execute(unparsed, *context.client));
+    }
+    reportAllocations(state, allocationsBefore);
+}
+BENCHMARK_CAPTURE(BM_Execute, volume_first_table, "VOLUME=50\r");
+BENCHMARK_CAPTURE(BM_Execute, get_pins_gpio_table, "GET_PINS\r");
+BENCHMARK_CAPTURE(BM_Execute, output_state_gpio_table, "OUTPUT_STATE=led:1\r");
+BENCHMARK_CAPTURE(BM_Execute, gpio_events_last_table, "GPIO_EVENTS=0\r");
+BENCHMARK_CAPTURE(BM_Execute, unknown_command, "NO_SUCH_COMMAND\r");
+
+static void BM_GetCommandStringList(benchmark::State& state)
+{
+    const CommandParser& parser = getContext().parser;
+
+    uint64_t allocationsBefore = threadAllocations;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(HotPathBench::getCommandStringList(parser));
+    }
+    reportAllocations(state, allocationsBefore);
+}
+BENCHMARK(BM_GetCommandStringList);
+
+static void BM_ConvertPinStateCommandToPair(benchmark::State& state, const char* pinInfo)
+{
+    GpioController& controller = *getContext().gpioController;
+    const std::string pinInfoStr = pinInfo;
+
+    uint64_t allocationsBefore = threadAllocations;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(HotPathBench::convertPinStateCommandToPair(controller, pinInfoStr));
+    }
+    reportAllocations(state, allocationsBefore);
+}
+BENCHMARK_CAPTURE(BM_ConvertPinStateCommandToPair, short_name, "led:1");
+BENCHMARK_CAPTURE(BM_ConvertPinStateCommandToPair, long_name, "front_porch_light:0");
+
+/**
+ * Copies a response of the given length, as execute() would return it, and
+ * terminates it; the copy is part of what's measured
+ */
+static void BM_TerminateResponse(benchmark::State& state)
+{
+    const std::string response(static_cast<size_t>(state.range(0)), 'x');
+
+    uint64_t allocationsBefore = threadAllocations;
+    for (auto _ : state)
+    {
+        std::string terminated(response);
+        HotPathBench::terminateResponse(terminated);
+        benchmark::DoNotOptimize(terminated.data());
+    }
+    reportAllocations(state, allocationsBefore);
+}
+BENCHMARK(BM_TerminateResponse)->Arg(3)->Arg(64)->Arg(4096);
+
+BENCHMARK_MAIN();
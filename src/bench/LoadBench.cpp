@@ -0,0 +1,393 @@
+/*
+ * LoadBench.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ *
+ * Load generator for netsysctrld. Opens a number of connections, answers the
+ * password prompt if a password is given, and has each connection keep up to
+ * a pipeline depth of requests in flight, drawn from a weighted mix of
+ * commands. Reports throughput, and the latency percentiles of each command
+ * and of all of them; a request's latency runs from just before it's
+ * written to the socket until its "~EOR" has been read.
+ *
+ * With -S, a daemon is started for the run, serving a fake sysfs GPIO tree
+ * with a single output pin and the fake mixer, so runs are reproducible on
+ * any Linux machine. Otherwise the daemon at -H/-P is used as is; mixes
+ * with OUTPUT_STATE then need it to have an output pin named by -g.
+ *
+ * Mixes are comma separated command lines, each with an optional *weight,
+ * e.g. "GET_PINS*4,VOLUME=50". OUTPUT_STATE alone toggles the -g pin.
+ */
+
+// System Includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// Project Includes
+#include "BenchClient.hpp"
+#include "FakeSysfsTree.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static const char* const DEFAULT_MIX =
+        "HELP*1,SVR_INFO*1,CLIENTS_INFO*1,GET_PINS*4,OUTPUT_STATE*4";
+
+struct BenchOptions
+{
+    std::string host = "127.0.0.1";
+    uint16_t port = 2018;
+    bool usePassword = false;
+    std::string password;
+    size_t connections = 4;
+    size_t depth = 1;
+    double seconds = 5.0;
+    double warmupSeconds = 1.0;
+    std::string mix = DEFAULT_MIX;
+    std::string pinName = "bench";
+    std::string daemonPath;
+};
+
+struct MixEntry
+{
+    std::string commandLine;
+    size_t weight;
+};
+
+// What one connection measured
+struct ConnectionResult
+{
+    // Nanoseconds, indexed by mix entry
+    std::vector<std::vector<uint64_t>> latenciesNs;
+    std::vector<uint64_t> errors;
+    std::string failure;
+};
+
+static void printUsage(const char* programName)
+{
+    std::cerr << "Usage: " << programName << " [-H host] [-P port] [-p password]"
+            " [-c connections] [-d depth] [-s seconds] [-w warmupSeconds] [-m mix]"
+            " [-g pinName] [-S daemonPath]\n"
+            "Default mix: " << DEFAULT_MIX << std::endl;
+}
+
+/**
+ * Throws a std::invalid_argument if mix has no entries or a bad weight
+ */
+static std::vector<MixEntry> parseMix(const std::string& mix)
+{
+    std::vector<MixEntry> entries;
+    std::stringstream mixStream(mix);
+    std::string entry;
+
+    while (std::getline(mixStream, entry, ','))
+    {
+        size_t weightPos = entry.find('*');
+        MixEntry mixEntry{entry.substr(0, weightPos), 1};
+        if (weightPos != std::string::npos)
+        {
+            mixEntry.weight = std::stoul(entry.substr(weightPos + 1));
+        }
+        if (mixEntry.commandLine.empty() || mixEntry.weight == 0)
+        {
+            throw std::invalid_argument("Invalid mix entry: " + entry);
+        }
+        entries.push_back(mixEntry);
+    }
+
+    if (entries.empty())
+    {
+        throw std::invalid_argument("The mix has no commands");
+    }
+    return entries;
+}
+
+/**
+ * Runs one connection until stopping is set, recording latencies once
+ * measuring is set. Requests are drawn from a shuffled schedule of the mix,
+ * seeded by connectionIdx, so each run issues the same sequence.
+ */
+static void runConnection(const BenchOptions& options, const std::vector<MixEntry>& mix,
+        size_t connectionIdx, std::atomic<size_t>& connectedCount, const std::atomic<bool>& measuring,
+        const std::atomic<bool>& stopping, ConnectionResult& result)
+{
+    result.latenciesNs.resize(mix.size());
+    result.errors.resize(mix.size(), 0);
+
+    std::unique_ptr<BenchClient> client;
+    try
+    {
+        client.reset(new BenchClient(options.host, options.port));
+        if (options.usePassword)
+        {
+            client->authenticate(options.password);
+        }
+    }
+    catch (const std::exception& err)
+    {
+        result.failure = err.what();
+        ++connectedCount;
+        return;
+    }
+    ++connectedCount;
+
+    std::vector<size_t> schedule;
+    for (size_t mixIdx = 0; mixIdx < mix.size(); ++mixIdx)
+    {
+        schedule.insert(schedule.end(), mix[mixIdx].weight, mixIdx);
+    }
+    std::mt19937 randomEngine(static_cast<std::mt19937::result_type>(connectionIdx));
+    std::shuffle(schedule.begin(), schedule.end(), randomEngine);
+
+    // The send time and mix entry of each request awaiting its response
+    std::deque<std::pair<Clock::time_point, size_t>> inFlight;
+    std::string toSend;
+    uint64_t requestCount = 0;
+
+    try
+    {
+        while (!stopping)
+        {
+            toSend.clear();
+            size_t batchStart = inFlight.size();
+            while (inFlight.size() < options.depth)
+            {
+                size_t mixIdx = schedule[requestCount % schedule.size()];
+                if (mix[mixIdx].commandLine == "OUTPUT_STATE")
+                {
+                    toSend.append("OUTPUT_STATE=" + options.pinName + ":" +
+                            std::to_string(requestCount & 1) + "\n");
+                }
+                else
+                {
+                    toSend.append(mix[mixIdx].commandLine + "\n");
+                }
+                inFlight.emplace_back(Clock::time_point(), mixIdx);
+                ++requestCount;
+            }
+
+            Clock::time_point sendTime = Clock::now();
+            for (size_t inFlightIdx = batchStart; inFlightIdx < inFlight.size(); ++inFlightIdx)
+            {
+                inFlight[inFlightIdx].first = sendTime;
+            }
+            client->send(toSend);
+
+            std::vector<std::string> responses = client->receiveResponses();
+            Clock::time_point receiveTime = Clock::now();
+            for (const std::string& response : responses)
+            {
+                if (inFlight.empty())
+                {
+                    throw std::runtime_error("Received a response to no request");
+                }
+
+                if (measuring)
+                {
+                    size_t mixIdx = inFlight.front().second;
+                    result.latenciesNs[mixIdx].push_back(static_cast<uint64_t>(
+                            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            receiveTime - inFlight.front().first).count()));
+                    if (response.compare(0, 8, "~INVALID") == 0 ||
+                            response.compare(0, 9, "~NO SUCH ") == 0)
+                    {
+                        ++result.errors[mixIdx];
+                    }
+                }
+                inFlight.pop_front();
+            }
+        }
+    }
+    catch (const std::exception& err)
+    {
+        result.failure = err.what();
+    }
+}
+
+/**
+ * Prints the count, errors and latency percentiles of latenciesNs, which is
+ * sorted
+ */
+static void printLatencies(const std::string& name, const std::vector<uint64_t>& latenciesNs,
+        uint64_t errors)
+{
+    auto percentileUs = [&latenciesNs](double fraction)
+    {
+        if (latenciesNs.empty())
+        {
+            return 0.0;
+        }
+        size_t rank = static_cast<size_t>(std::ceil(fraction * latenciesNs.size()));
+        rank = std::max<size_t>(1, std::min(rank, latenciesNs.size()));
+        return latenciesNs[rank - 1] / 1000.0;
+    };
+
+    std::printf("%-28s %10zu %8llu %10.1f %10.1f %10.1f %10.1f\n", name.c_str(),
+            latenciesNs.size(), static_cast<unsigned long long>(errors), percentileUs(0.5),
+            percentileUs(0.99), percentileUs(0.999), percentileUs(1.0));
+}
+
+int main(int argc, char *argv[])
+{
+    BenchOptions options;
+    std::vector<MixEntry> mix;
+
+    try
+    {
+        int option;
+        while ((option = getopt(argc, argv, "H:P:p:c:d:s:w:m:g:S:")) != -1)
+        {
+            switch (option)
+            {
+            case 'H': options.host = optarg; break;
+            case 'P': options.port = static_cast<uint16_t>(std::stoul(optarg)); break;
+            case 'p': options.usePassword = true; options.password = optarg; break;
+            case 'c': options.connections = std::stoul(optarg); break;
+            case 'd': options.depth = std::stoul(optarg); break;
+            case 's': options.seconds = std::stod(optarg); break;
+            case 'w': options.warmupSeconds = std::stod(optarg); break;
+            case 'm': options.mix = optarg; break;
+            case 'g': options.pinName = optarg; break;
+            case 'S': options.daemonPath = optarg; break;
+            default:
+                printUsage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        }
+
+        if (optind != argc || options.connections == 0 || options.depth == 0 ||
+                options.seconds <= 0 || options.warmupSeconds < 0)
+        {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        mix = parseMix(options.mix);
+    }
+    catch (const std::exception& err)
+    {
+        std::cerr << "Invalid argument; " << err.what() << std::endl;
+        printUsage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    std::unique_ptr<FakeSysfsTree> sysfsTree;
+    std::unique_ptr<BenchDaemon> daemon;
+    if (!options.daemonPath.empty())
+    {
+        try
+        {
+            sysfsTree.reset(new FakeSysfsTree({0}));
+            std::vector<std::string> daemonArgs {"-x", "fake", "-r", sysfsTree->getRoot(),
+                    "-g", options.pinName + "=0"};
+            if (options.usePassword)
+            {
+                daemonArgs.push_back("-p");
+                daemonArgs.push_back(options.password);
+            }
+            daemon.reset(new BenchDaemon(options.daemonPath, options.host, options.port,
+                    daemonArgs));
+        }
+        catch (const std::exception& err)
+        {
+            std::cerr << "Unable to start the daemon; " << err.what() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    std::cout << "netsysctrld-bench; " << options.host << ":" << options.port
+            << (daemon ? " (started)" : "") << "; " << options.connections
+            << " connections; depth " << options.depth << "; " << options.seconds
+            << "s after " << options.warmupSeconds << "s warmup; mix: " << options.mix
+            << std::endl;
+
+    std::atomic<size_t> connectedCount{0};
+    std::atomic<bool> measuring{false};
+    std::atomic<bool> stopping{false};
+    std::vector<ConnectionResult> results(options.connections);
+    std::vector<std::thread> connectionThreads;
+
+    for (size_t connectionIdx = 0; connectionIdx < options.connections; ++connectionIdx)
+    {
+        connectionThreads.emplace_back(runConnection, std::cref(options), std::cref(mix),
+                connectionIdx, std::ref(connectedCount), std::cref(measuring),
+                std::cref(stopping), std::ref(results[connectionIdx]));
+    }
+
+    // Warmup and measurement start once every connection is established
+    while (connectedCount < options.connections)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.warmupSeconds));
+    measuring = true;
+    Clock::time_point measureStart = Clock::now();
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.seconds));
+    measuring = false;
+    double measuredSeconds = std::chrono::duration<double>(Clock::now() - measureStart).count();
+    stopping = true;
+
+    for (std::thread& connectionThread : connectionThreads)
+    {
+        connectionThread.join();
+    }
+
+    if (daemon)
+    {
+        daemon->stop();
+    }
+
+    size_t failedCount = 0;
+    for (const ConnectionResult& result : results)
+    {
+        if (!result.failure.empty())
+        {
+            ++failedCount;
+            std::cerr << "Connection failed: " << result.failure << std::endl;
+        }
+    }
+
+    std::printf("%-28s %10s %8s %10s %10s %10s %10s\n", "command", "requests", "errors",
+            "p50(us)", "p99(us)", "p999(us)", "max(us)");
+
+    std::vector<uint64_t> allLatenciesNs;
+    uint64_t allErrors = 0;
+    for (size_t mixIdx = 0; mixIdx < mix.size(); ++mixIdx)
+    {
+        std::vector<uint64_t> latenciesNs;
+        uint64_t errors = 0;
+        for (const ConnectionResult& result : results)
+        {
+            latenciesNs.insert(latenciesNs.end(), result.latenciesNs[mixIdx].begin(),
+                    result.latenciesNs[mixIdx].end());
+            errors += result.errors[mixIdx];
+        }
+        std::sort(latenciesNs.begin(), latenciesNs.end());
+        printLatencies(mix[mixIdx].commandLine, latenciesNs, errors);
+
+        allLatenciesNs.insert(allLatenciesNs.end(), latenciesNs.begin(), latenciesNs.end());
+        allErrors += errors;
+    }
+    std::sort(allLatenciesNs.begin(), allLatenciesNs.end());
+    printLatencies("all", allLatenciesNs, allErrors);
+
+    std::printf("Throughput: %.0f requests/s\n", allLatenciesNs.size() / measuredSeconds);
+
+    return failedCount == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
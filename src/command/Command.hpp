@@ -25,8 +25,10 @@ public:
     ////////////////////////////////
     // Public interface functions //
     ////////////////////////////////
-    Command(std::string commandStringParam, CommandFunction cmdFuncParam, std::string descriptionParam) :
-            commandString(commandStringParam), cmdFunc(cmdFuncParam), description(descriptionParam) {};
+    Command(std::string commandStringParam, CommandFunction cmdFuncParam, std::string descriptionParam,
+            bool mutatesStateParam = false) :
+            commandString(commandStringParam), cmdFunc(cmdFuncParam), description(descriptionParam),
+            mutatesState(mutatesStateParam) {};
 
     /**
      * Executes the function pointed to by cmdFunc with the parameter funcParam.
@@ -49,6 +51,15 @@ public:
         return description;
     }
 
+    /**
+     * Whether the command changes the state of the system or its pins, and
+     * so is recorded in the command journal
+     */
+    bool isStateMutating() const
+    {
+        return mutatesState;
+    }
+
 private:
     //////////////////////////////
     // Private member variables //
@@ -56,6 +67,7 @@ private:
     const std::string commandString;
     const CommandFunction cmdFunc;
     const std::string description;
+    const bool mutatesState;
 
 };
 
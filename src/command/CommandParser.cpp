@@ -10,83 +10,171 @@
 #include <regex>
 #include <string>
 #include <stdexcept>
+#include <vector>
 
 // Project includes
 #include "Command.hpp"
 #include "CommandParser.hpp"
+#include "RequestTracer.hpp"
 #include "SystemUtils.hpp"
 #include "SystemUtils.hpp"
 #include "TcpServer.hpp"
 #include "GpioController.hpp"
 
 // Static initialization
+
+// Marks the commands recorded in the command journal
+const bool CommandParser::MUTATES_STATE = true;
+
 const Command<SystemUtils> CommandParser::SYSTEM_UTILS_CMDS[]
 {
-    Command<SystemUtils> { SystemUtils::VOLUME_SETTER_COMMAND, &SystemUtils::setVolumeCommandHandler, "Sets the system volume. Specify as a percentage."}
+    Command<SystemUtils> { SystemUtils::VOLUME_SETTER_COMMAND, &SystemUtils::setVolumeCommandHandler, "Sets the system volume. Specify as a percentage.", MUTATES_STATE},
+    Command<SystemUtils> { "FADE", &SystemUtils::fadeVolumeCommandHandler, "Format: TargetPercent:DurationMs; Ramps the system volume to the target over the duration", MUTATES_STATE}
 };
 
 const Command<TcpServer> CommandParser::SERVER_CMDS[]
 {
     Command<TcpServer> { "SVR_INFO", &TcpServer::getAddressInfoHandler, "Gets the server's networking information"},
-    Command<TcpServer> { "CLIENTS_INFO", &TcpServer::getClientsInfoHandler, "Gets the IP and port #s of connected clients"}
+    Command<TcpServer> { "CLIENTS_INFO", &TcpServer::getClientsInfoHandler, "Gets the IP and port #s of connected clients"},
+    Command<TcpServer> { "STATS", &TcpServer::getStatsHandler, "Gets the daemon's counters and latency histograms"},
+    Command<TcpServer> { "TIMER_STATS", &TcpServer::getTimerStatsHandler, "Gets the number of pending timed commands and their timing jitter"},
+    Command<TcpServer> { "TRACE_DUMP", &TcpServer::getTraceDumpHandler, "Gets the sampled request traces, as Chrome trace event JSON"},
+    Command<TcpServer> { "TRACE_SAMPLE", &TcpServer::setTraceSampleIntervalHandler, "Format: N; Traces 1 in N requests, chosen at random; 0 stops tracing"},
+    Command<TcpServer> { "RESYNC", &TcpServer::resyncHandler, "Format: LastSeq; Gets the state deltas after LastSeq, or a snapshot if they're gone; SUBSCRIBE=state first"}
 };
 
 const Command<GpioController> CommandParser::GPIO_CMDS[]
 {
     Command<GpioController> { "GET_PINS", &GpioController::getPinMapping, "Gets the GPIO pin mapping registered with this server"},
-    Command<GpioController> { "OUTPUT_STATE", &GpioController::setPinOutputState, "Format: PinName=0(off)/1(on); Sets the output state of the named pin"},
-    Command<GpioController> { "ALL_LOW", &GpioController::setAllToOutputLow, "Sets all registered GPIO pins to low"},
+    Command<GpioController> { "OUTPUT_STATE", &GpioController::setPinOutputState, "Format: PinName=0(off)/1(on); Sets the output state of the named pin", MUTATES_STATE},
+    Command<GpioController> { "ALL_LOW", &GpioController::setAllToOutputLow, "Sets all registered GPIO pins to low", MUTATES_STATE},
+    Command<GpioController> { "INPUT_STATE", &GpioController::getInputState, "Format: PinName; Gets the current value of the named input pin"},
+    Command<GpioController> { "PULSE", &GpioController::pulsePinHandler, "Format: PinName:DurationMs; Sets the named pin high, then low after DurationMs", MUTATES_STATE},
+    Command<GpioController> { "SET_AT", &GpioController::setPinStateAtHandler, "Format: PinName:0(off)/1(on)@+DelayMs; Sets the output state of the named pin after DelayMs", MUTATES_STATE},
+    Command<GpioController> { "BUS_WRITE", &GpioController::busWriteHandler, "Format: GroupName:Value; Writes the bits of Value (decimal or 0x hex) across the named pin group, LSB first", MUTATES_STATE},
+    Command<GpioController> { "PATTERN", &GpioController::uploadPatternHandler, "Format: PatternName:GroupName:Bitmap@DelayMs,...; Stores a pattern of group bitmaps, each held for DelayMs", MUTATES_STATE},
+    Command<GpioController> { "PLAY", &GpioController::playPatternHandler, "Format: PatternName[:loop]; Plays the named pattern once, or repeatedly", MUTATES_STATE},
+    Command<GpioController> { "STOP_PATTERN", &GpioController::stopPatternHandler, "Stops the playing pattern", MUTATES_STATE},
+    Command<GpioController> { "PWM", &GpioController::setPwmHandler, "Format: PinName:DutyPercent:FrequencyHz; Runs software PWM on the named pin; duty 0 or 100 stops it", MUTATES_STATE},
+    Command<GpioController> { "PWM_STATS", &GpioController::getPwmStatsHandler, "Gets the PWM engine's achieved periods and jitter"},
+    Command<GpioController> { "GPIO_STATS", &GpioController::getGpioStatsHandler, "Gets how many OUTPUT_STATE writes were made, deferred, and saved by rate limiting"},
+    Command<GpioController> { "CANCEL_PENDING", &GpioController::cancelPendingTransitionsHandler, "Format: PinName; Cancels the named pin's pending PULSE and SET_AT transitions", MUTATES_STATE},
 
 };
 
+const Command<SocketWrapper> CommandParser::CLIENT_CMDS[]
+{
+    Command<SocketWrapper> { "SUBSCRIBE", &SocketWrapper::subscribeHandler, "Format: volume, state, gpio, or gpio:PinName; Pushes the topic's events to this client"},
+    Command<SocketWrapper> { "UNSUBSCRIBE", &SocketWrapper::unsubscribeHandler, "Format: volume, state, gpio, or gpio:PinName; Stops pushing the topic's events to this client"},
+    Command<SocketWrapper> { "GPIO_EVENTS", &SocketWrapper::setGpioInputSubscriptionHandler, "Format: 0(off)/1(on); Same as SUBSCRIBE=gpio/UNSUBSCRIBE=gpio"},
+    Command<SocketWrapper> { "VOLUME_EVENTS", &SocketWrapper::setVolumeSubscriptionHandler, "Format: 0(off)/1(on); Same as SUBSCRIBE=volume/UNSUBSCRIBE=volume"},
+};
+
 
 const size_t CommandParser::SYSTEM_UTILS_CMDS_LIST_LENGTH = sizeof(SYSTEM_UTILS_CMDS) / sizeof(Command<SystemUtils>);
 const size_t CommandParser::SERVER_CMDS_LIST_LENGTH = sizeof(SERVER_CMDS) / sizeof(Command<TcpServer>);
 const size_t CommandParser::GPIO_CMDS_LIST_LENGTH = sizeof(GPIO_CMDS) / sizeof(Command<GpioController>);
+const size_t CommandParser::CLIENT_CMDS_LIST_LENGTH = sizeof(CLIENT_CMDS) / sizeof(Command<SocketWrapper>);
 
 
 const std::string CommandParser::FUNCTION_AND_PARAM_SEPARATOR = "=";
 const std::regex CommandParser::CMD_REGEX { "^([A-Z0-9_]+)" +
-    FUNCTION_AND_PARAM_SEPARATOR + "?([-]?[0-9a-zA-Z:]*\\.?[0-9a-zA-Z:]*)"};
+    FUNCTION_AND_PARAM_SEPARATOR + "?([-]?[0-9a-zA-Z:@+,]*\\.?[0-9a-zA-Z:@+,]*)"};
 const std::string CommandParser::LIST_CMDS_COMMAND_STRING {"HELP"};
 const std::string CommandParser::INVALID_SYNTAX_STRING {"~INVALID COMMAND SYNTAX"};
 const std::string CommandParser::NO_SUCH_COMMAND_EXISTS_STRING {"~NO SUCH COMMAND EXISTS"};
 const std::string CommandParser::INVALID_PARAMETER_STRING {"~INVALID PARAMETER"};
 const std::string CommandParser::EXECUTION_OK_STRING {"~OK"};
+const std::string CommandParser::EXECUTION_FAILED_STRING {"~EXECUTION FAILED"};
 const std::string CommandParser::UNUSED_PARAM_VALUE = "default";
 
+const MetricsRegistry::Counter CommandParser::SYNTAX_ERRORS =
+        MetricsRegistry::getInstance().registerCounter("netsysctrld_command_errors_total",
+        "Commands which weren't executed, or which threw, by reason", "reason=\"syntax\"");
+const MetricsRegistry::Counter CommandParser::UNKNOWN_COMMANDS =
+        MetricsRegistry::getInstance().registerCounter("netsysctrld_command_errors_total",
+        "Commands which weren't executed, or which threw, by reason", "reason=\"unknown_command\"");
+const MetricsRegistry::Counter CommandParser::INVALID_PARAMETERS =
+        MetricsRegistry::getInstance().registerCounter("netsysctrld_command_errors_total",
+        "Commands which weren't executed, or which threw, by reason", "reason=\"invalid_parameter\"");
+const MetricsRegistry::Counter CommandParser::EXECUTION_FAILURES =
+        MetricsRegistry::getInstance().registerCounter("netsysctrld_command_errors_total",
+        "Commands which weren't executed, or which threw, by reason", "reason=\"execution_failed\"");
+const MetricsRegistry::Histogram CommandParser::COMMAND_DURATION =
+        MetricsRegistry::getInstance().registerHistogram("netsysctrld_command_duration_us",
+        "Time taken by command handlers, in microseconds");
+
+/**
+ * Registers an execution counter for every command, so that looking one up
+ * on the request path needs no lock
+ */
 CommandParser::CommandParser(const TcpServerSharedPtr& tcpServer, const SystemUtilsSharedPtr& systemUtils,
-        const GpioController& gpioController):
-    tcpServer(tcpServer), systemUtilsPtr(std::move(systemUtils)), gpioController(gpioController)
+        const GpioControllerSharedPtr& gpioControllerPtr, const CommandJournalSharedPtr& commandJournal):
+    tcpServer(tcpServer), systemUtilsPtr(std::move(systemUtils)), gpioControllerPtr(gpioControllerPtr),
+    commandJournal(commandJournal)
 {
+    std::vector<std::string> commandStrings {LIST_CMDS_COMMAND_STRING};
+    for (size_t idx = 0; idx < SYSTEM_UTILS_CMDS_LIST_LENGTH; ++idx)
+    {
+        commandStrings.push_back(SYSTEM_UTILS_CMDS[idx].getCommandString());
+    }
+    for (size_t idx = 0; idx < SERVER_CMDS_LIST_LENGTH; ++idx)
+    {
+        commandStrings.push_back(SERVER_CMDS[idx].getCommandString());
+    }
+    for (size_t idx = 0; idx < GPIO_CMDS_LIST_LENGTH; ++idx)
+    {
+        commandStrings.push_back(GPIO_CMDS[idx].getCommandString());
+    }
+    for (size_t idx = 0; idx < CLIENT_CMDS_LIST_LENGTH; ++idx)
+    {
+        commandStrings.push_back(CLIENT_CMDS[idx].getCommandString());
+    }
 
+    for (const std::string& commandString : commandStrings)
+    {
+        commandCounters.emplace(commandString, MetricsRegistry::getInstance().registerCounter(
+                "netsysctrld_commands_total", "Commands executed, by name",
+                "command=\"" + commandString + "\""));
+    }
 }
 
 /**
  * The command specified by LIST_CMDS_COMMAND_STRING will result in a list of supported
  * functions being printed. If the command was invalid or there was a parsing error, a
  * string reporting the error will be returned. If the parse operation was successful,
- * the result of the execution will be returned.
+ * the result of the execution will be returned. client is the connection
+ * which issued the command, and is the object on which CLIENT_CMDS execute.
+ * A command which throws a std::logic_error had an invalid parameter; any
+ * other exception is reported as an execution failure, and the connection
+ * carries on. State-mutating commands are journalled with their results,
+ * whether or not they succeeded.
  *
  * TODO: Throw exceptions for bad commands
  */
-std::string CommandParser::execute(const std::string& unparsedCommand)
+std::string CommandParser::execute(const std::string& unparsedCommand, SocketWrapper& client)
 {
     std::string cmd;
     std::string param;
 
+    RequestTracer::mark(RequestTracer::Mark::PARSE_START);
     bool parseResult = parse(unparsedCommand, cmd, param);
+    RequestTracer::mark(RequestTracer::Mark::PARSE_END);
     if (!parseResult)
     {
+        SYNTAX_ERRORS.increment();
         return INVALID_SYNTAX_STRING;
     }
+    RequestTracer::setCommand(cmd);
 
     if (cmd.compare(LIST_CMDS_COMMAND_STRING) == 0)
     {
+        countCommand(cmd);
         return EXECUTION_OK_STRING + getCommandStringList();
     }
 
     // Attempt to find and execute the specified command
+    bool mutatesState = false;
     try
     {
         std::string funcUpdatableString = EXECUTION_OK_STRING;
@@ -97,7 +185,16 @@ std::string CommandParser::execute(const std::string& unparsedCommand)
             if (cmd.compare(systemUtilsCmd.getCommandString()) == 0)
             {
                 std::cout << "Executing: " << cmd << "(" << param << ")" << std::endl;
+                countCommand(cmd);
+                RequestTracer::mark(RequestTracer::Mark::HANDLER_START);
+                mutatesState = systemUtilsCmd.isStateMutating();
+                MetricsRegistry::ScopedTimer handlerTimer{COMMAND_DURATION};
                 systemUtilsCmd.exec(param, &funcUpdatableString, *systemUtilsPtr);
+                RequestTracer::mark(RequestTracer::Mark::HANDLER_END);
+                if (mutatesState)
+                {
+                    journalCommand(client, cmd, param, funcUpdatableString, true);
+                }
                 return funcUpdatableString;
             }
         }
@@ -109,7 +206,16 @@ std::string CommandParser::execute(const std::string& unparsedCommand)
             if (cmd.compare(serverCmd.getCommandString()) == 0)
             {
                 std::cout << "Executing: " << cmd << "(" << param << ")" << std::endl;
+                countCommand(cmd);
+                RequestTracer::mark(RequestTracer::Mark::HANDLER_START);
+                mutatesState = serverCmd.isStateMutating();
+                MetricsRegistry::ScopedTimer handlerTimer{COMMAND_DURATION};
                 serverCmd.exec(param, &funcUpdatableString, *tcpServer);
+                RequestTracer::mark(RequestTracer::Mark::HANDLER_END);
+                if (mutatesState)
+                {
+                    journalCommand(client, cmd, param, funcUpdatableString, true);
+                }
                 return funcUpdatableString;
             }
         }
@@ -121,19 +227,97 @@ std::string CommandParser::execute(const std::string& unparsedCommand)
             if (cmd.compare(gpioCmd.getCommandString()) == 0)
             {
                 std::cout << "Executing: " << cmd << "(" << param << ")" << std::endl;
-                gpioCmd.exec(param, &funcUpdatableString, gpioController);
+                countCommand(cmd);
+                RequestTracer::mark(RequestTracer::Mark::HANDLER_START);
+                mutatesState = gpioCmd.isStateMutating();
+                MetricsRegistry::ScopedTimer handlerTimer{COMMAND_DURATION};
+                gpioCmd.exec(param, &funcUpdatableString, *gpioControllerPtr);
+                RequestTracer::mark(RequestTracer::Mark::HANDLER_END);
+                if (mutatesState)
+                {
+                    journalCommand(client, cmd, param, funcUpdatableString, true);
+                }
+                return funcUpdatableString;
+            }
+        }
+
+        // Client (per-connection) commands
+        for (size_t idx = 0; idx < CLIENT_CMDS_LIST_LENGTH; ++idx)
+        {
+            Command<SocketWrapper>clientCmd = CLIENT_CMDS[idx];
+            if (cmd.compare(clientCmd.getCommandString()) == 0)
+            {
+                std::cout << "Executing: " << cmd << "(" << param << ")" << std::endl;
+                countCommand(cmd);
+                RequestTracer::mark(RequestTracer::Mark::HANDLER_START);
+                mutatesState = clientCmd.isStateMutating();
+                MetricsRegistry::ScopedTimer handlerTimer{COMMAND_DURATION};
+                clientCmd.exec(param, &funcUpdatableString, client);
+                RequestTracer::mark(RequestTracer::Mark::HANDLER_END);
+                if (mutatesState)
+                {
+                    journalCommand(client, cmd, param, funcUpdatableString, true);
+                }
                 return funcUpdatableString;
             }
         }
     }
     catch (const std::logic_error& err)
     {
-        return INVALID_PARAMETER_STRING + "; " + err.what();
+        RequestTracer::mark(RequestTracer::Mark::HANDLER_END);
+        INVALID_PARAMETERS.increment();
+        std::string result = INVALID_PARAMETER_STRING + "; " + err.what();
+        if (mutatesState)
+        {
+            journalCommand(client, cmd, param, result, false);
+        }
+        return result;
+    }
+    catch (const std::exception& err)
+    {
+        // Failures of the system underneath, e.g. the mixer or a GPIO
+        // value file, rather than of the command
+        RequestTracer::mark(RequestTracer::Mark::HANDLER_END);
+        EXECUTION_FAILURES.increment();
+        std::cerr << "Failed to execute: " << cmd << "(" << param << "); " << err.what()
+                << std::endl;
+        std::string result = EXECUTION_FAILED_STRING + "; " + err.what();
+        if (mutatesState)
+        {
+            journalCommand(client, cmd, param, result, false);
+        }
+        return result;
     }
 
+    UNKNOWN_COMMANDS.increment();
     return NO_SUCH_COMMAND_EXISTS_STRING;
 }
 
+/**
+ * Increments command's execution counter
+ */
+void CommandParser::countCommand(const std::string& command) const
+{
+    auto counterIter = commandCounters.find(command);
+    if (counterIter != commandCounters.end())
+    {
+        counterIter->second.increment();
+    }
+}
+
+/**
+ * Does nothing unless the daemon was given a command journal
+ */
+void CommandParser::journalCommand(SocketWrapper& client, const std::string& command,
+        const std::string& param, const std::string& result, bool succeeded) const
+{
+    if (commandJournal)
+    {
+        commandJournal->record(client.getIpAddress(), client.getPortNumber(), command, param,
+                result, succeeded);
+    }
+}
+
 /**
  * Returns a list of commands supported by this interpreter.
  */
@@ -168,6 +352,15 @@ std::string CommandParser::getCommandStringList() const
         cmdList.append("\n");
     }
 
+    cmdList.append("\nCLIENT COMMANDS: \n");
+    for (size_t idx = 0; idx < CLIENT_CMDS_LIST_LENGTH; ++idx)
+    {
+        cmdList.append(CLIENT_CMDS[idx].getCommandString());
+        cmdList.append(" - ");
+        cmdList.append(CLIENT_CMDS[idx].getCommandDescription());
+        cmdList.append("\n");
+    }
+
     return cmdList;
 }
 
@@ -13,11 +13,15 @@
 #include <regex>
 #include <string>
 #include <memory>
+#include <unordered_map>
 
 // Project includes
 #include "Command.hpp"
+#include "CommandJournal.hpp"
+#include "MetricsRegistry.hpp"
 #include "SystemUtils.hpp"
 #include "GpioController.hpp"
+#include "SocketWrapper.hpp"
 
 // Forward declarations
 class TcpServer;
@@ -25,29 +29,46 @@ using TcpServerSharedPtr = std::shared_ptr<TcpServer>;
 
 class CommandParser
 {
+    // Benchmarks parse() and getCommandStringList(); see bench/HotPathBench.cpp
+    friend class HotPathBench;
+
 public:
     ////////////////////////////////
     // Public interface functions //
     ////////////////////////////////
-    std::string execute(const std::string& unparsedCommand);
+    std::string execute(const std::string& unparsedCommand, SocketWrapper& client);
 
+    // commandJournal may be null, in which case nothing is journalled
     CommandParser(const TcpServerSharedPtr& tcpServerPtr, const SystemUtilsSharedPtr& systemUtilsPtr,
-            const GpioController& gpioController);
+            const GpioControllerSharedPtr& gpioControllerPtr,
+            const CommandJournalSharedPtr& commandJournal = nullptr);
 
 private:
     const TcpServerSharedPtr tcpServer;
     const SystemUtilsSharedPtr systemUtilsPtr;
-    GpioController gpioController;
+    const GpioControllerSharedPtr gpioControllerPtr;
+    const CommandJournalSharedPtr commandJournal;
 
     bool parse(const std::string& unparsedCommand, std::string& command, std::string& param) const;
     std::string getCommandStringList() const;
+    void countCommand(const std::string& command) const;
+    void journalCommand(SocketWrapper& client, const std::string& command,
+            const std::string& param, const std::string& result, bool succeeded) const;
+
+    // Per-command execution counters, by command string. Filled in by the
+    // constructor and only read afterwards.
+    std::unordered_map<std::string, MetricsRegistry::Counter> commandCounters;
 
     /////////////////////////////
     // Private class Constants //
     /////////////////////////////
+    // Passed to the Commands which are journalled
+    static const bool MUTATES_STATE;
+
     static const Command<SystemUtils> SYSTEM_UTILS_CMDS[];
     static const Command<TcpServer> SERVER_CMDS[];
     static const Command<GpioController> GPIO_CMDS[];
+    static const Command<SocketWrapper> CLIENT_CMDS[];
 
     // The regex string used to parse commands
     static const std::regex CMD_REGEX;
@@ -65,13 +86,20 @@ private:
     static const size_t SYSTEM_UTILS_CMDS_LIST_LENGTH;
     static const size_t SERVER_CMDS_LIST_LENGTH;
     static const size_t GPIO_CMDS_LIST_LENGTH;
+    static const size_t CLIENT_CMDS_LIST_LENGTH;
 
     // Constant strings representing different parse/execution results
     static const std::string NO_SUCH_COMMAND_EXISTS_STRING;
     static const std::string INVALID_PARAMETER_STRING;
     static const std::string EXECUTION_OK_STRING;
+    static const std::string EXECUTION_FAILED_STRING;
     static const std::string INVALID_SYNTAX_STRING;
 
+    static const MetricsRegistry::Counter SYNTAX_ERRORS;
+    static const MetricsRegistry::Counter UNKNOWN_COMMANDS;
+    static const MetricsRegistry::Counter INVALID_PARAMETERS;
+    static const MetricsRegistry::Counter EXECUTION_FAILURES;
+    static const MetricsRegistry::Histogram COMMAND_DURATION;
 };
 
 #endif /* COMMAND_COMMANDPARSER_HPP_ */
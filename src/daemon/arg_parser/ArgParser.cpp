@@ -6,16 +6,19 @@
  */
 
 // System Includes
+#include <chrono>
 #include <csignal>
 #include <cstdint>
 #include <iomanip>
 #include <iostream>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 // Project Includes
 #include "ArgParser.hpp"
 #include "ArgParserFunction.hpp"
+#include "RequestTracer.hpp"
 #include "SystemUtils.hpp"
 #include "TcpServer.hpp"
 #include "GpioController.hpp"
@@ -29,14 +32,36 @@ const ArgParserFunction ArgParser::ARG_PARSER_FUNCTIONS[] =
         "Prints the arguments supported by this program"},
     ArgParserFunction {'a', "audiocontrol", &ArgParser::setAudioControlName, true,
         "Sets the audio control name used for volume control; see output of 'amixer scontrols'. Default: \"Master\""},
+    ArgParserFunction {'x', "mixer", &ArgParser::setMixerType, true,
+        "Sets how volume is controlled: alsa, amixer or fake. Default: amixer; alsa is only available if built in"},
     ArgParserFunction {'p', "password", &ArgParser::setServerPassword, true,
         "Sets the password which clients must provide to use this server. Default: no password"},
     ArgParserFunction {'P', "port", &ArgParser::setServerPort, true,
         "Set the TCP port number of this command server. Default: 2018"},
     ArgParserFunction {'g', "gpio", &ArgParser::addGpioPin, true,
         "Adds a named gpio pin; requires form \"pinName=pinNum\""},
+    ArgParserFunction {'G', "gpiogroup", &ArgParser::addGpioPinGroup, true,
+        "Adds a named group of gpio pins for BUS_WRITE; requires form \"groupName=pin0,pin1,...\", LSB first"},
     ArgParserFunction {'i', "gpioinit", &ArgParser::initGpioToOutputLow, false,
         "Initializes provided GPIO pins to output low"},
+    ArgParserFunction {'I', "gpioinput", &ArgParser::addGpioInputPin, true,
+        "Adds a named gpio input pin; requires form \"pinName=pinNum[:none|rising|falling|both]\". Default edge: both"},
+    ArgParserFunction {'l', "gpiolazy", &ArgParser::initGpioLazily, false,
+        "Like gpioinit, but starts serving immediately; pins are initialized in the background, or on first use"},
+    ArgParserFunction {'r', "gpioroot", &ArgParser::setGpioSysfsRoot, true,
+        "Sets the directory of the sysfs GPIO interface. Default: \"/sys/class/gpio\""},
+    ArgParserFunction {'s', "gpiostate", &ArgParser::setGpioStateFile, true,
+        "Saves output pin states to the given file, and restores them from it at startup"},
+    ArgParserFunction {'m', "gpiomininterval", &ArgParser::setGpioMinWriteInterval, true,
+        "Sets the minimum interval, in ms, between OUTPUT_STATE writes of a pin; the latest state wins. Default: 0 (no limit)"},
+    ArgParserFunction {'M', "metricsport", &ArgParser::setMetricsPort, true,
+        "Serves Prometheus metrics on this port of 127.0.0.1, at /metrics. Default: not served"},
+    ArgParserFunction {'T', "tracesample", &ArgParser::setTraceSampleInterval, true,
+        "Traces 1 in N client requests, chosen at random; see TRACE_DUMP. Default: 0 (no tracing)"},
+    ArgParserFunction {'t', "tracefile", &ArgParser::setTraceFile, true,
+        "Sets the file which request traces are written to on SIGUSR1. Default: \"/tmp/netsysctrld-trace.json\""},
+    ArgParserFunction {'j', "journal", &ArgParser::setCommandJournalDirectory, true,
+        "Records state-mutating commands in a binary journal in this directory; see netsysctrld-journal-dump. Default: not journalled"},
 };
 
 // Number of functions stored within ARG_PARSER_FUNCTIONS[]
@@ -328,6 +353,12 @@ void ArgParser::setAudioControlName(const std::string& audioControlName)
     systemUtilsBuilder.withAudioControlName(audioControlName.c_str());
 }
 
+void ArgParser::setMixerType(const std::string& mixerType)
+{
+    std::cout << "(ArgParser) Using mixer type: " << mixerType << std::endl;
+    systemUtilsBuilder.withMixerType(mixerType);
+}
+
 /**
  * Prints information about which arguments are supported by this program.
  * Following, this function sends a SIGTERM to the calling process, causing
@@ -432,24 +463,219 @@ void ArgParser::addGpioPin(const std::string& namedPin)
     gpioControllerBuilder.withNamedPin(name, num);
 }
 
+/**
+ * Adds a named input pin. namedInputPin must have the form
+ * "pinName=pinNum" or "pinName=pinNum:edge", where edge is one of none,
+ * rising, falling or both. If no edge is given, both is used. Syntax errors
+ * result in a std::invalid_argument being thrown.
+ */
+void ArgParser::addGpioInputPin(const std::string& namedInputPin)
+{
+    auto equalsIdx = namedInputPin.find("=");
+
+    if (equalsIdx == std::string::npos ||
+        equalsIdx == 0 ||
+        equalsIdx == namedInputPin.length()-1 ||
+        namedInputPin.find("=", equalsIdx+1) != std::string::npos)
+    {
+        throw std::invalid_argument("Named input pin: " + namedInputPin + " syntax invalid; "
+                "it must have the form \"pinName=pinNum[:edge]\"");
+    }
+
+    std::string name = namedInputPin.substr(0, equalsIdx);
+    std::string numAndEdge = namedInputPin.substr(equalsIdx+1);
+
+    GpioController::InputEdge edge = GpioController::InputEdge::BOTH;
+    auto colonIdx = numAndEdge.find(":");
+    if (colonIdx != std::string::npos)
+    {
+        edge = GpioController::convertStringToInputEdge(numAndEdge.substr(colonIdx+1));
+        numAndEdge = numAndEdge.substr(0, colonIdx);
+    }
+
+    unsigned long num;
+    try {
+        num = std::stoul(numAndEdge);
+    }
+    catch(std::invalid_argument& except)
+    {
+        throw std::invalid_argument("Named input pin: " + namedInputPin + " syntax invalid; "
+                "The number value must be an uint less than 65535");
+    }
+
+    if (num > UINT16_MAX)
+    {
+        throw std::invalid_argument("Named input pin: " + namedInputPin + " invalid; "
+                "The number value must be an uint less than 65535");
+    }
+
+    gpioControllerBuilder.withInputPin(name, num, edge);
+}
+
+/**
+ * Adds a named group of output pins. namedPinGroup must have the form
+ * "groupName=pinName0,pinName1,...", where pinName0 is driven by the least
+ * significant bit. The pins themselves may be declared before or after the
+ * group. Syntax errors result in a std::invalid_argument being thrown.
+ */
+void ArgParser::addGpioPinGroup(const std::string& namedPinGroup)
+{
+    auto equalsIdx = namedPinGroup.find("=");
+
+    if (equalsIdx == std::string::npos ||
+        equalsIdx == 0 ||
+        equalsIdx == namedPinGroup.length()-1 ||
+        namedPinGroup.find("=", equalsIdx+1) != std::string::npos)
+    {
+        throw std::invalid_argument("Pin group: " + namedPinGroup + " syntax invalid; "
+                "it must have the form \"groupName=pinName0,pinName1,...\"");
+    }
+
+    std::string groupName = namedPinGroup.substr(0, equalsIdx);
+    std::vector<std::string> pinNames;
+
+    size_t nameStartIdx = equalsIdx+1;
+    while (nameStartIdx <= namedPinGroup.length())
+    {
+        size_t commaIdx = namedPinGroup.find(",", nameStartIdx);
+        if (commaIdx == std::string::npos)
+        {
+            commaIdx = namedPinGroup.length();
+        }
+
+        if (commaIdx == nameStartIdx)
+        {
+            throw std::invalid_argument("Pin group: " + namedPinGroup + " syntax invalid; "
+                    "pin names can't be empty");
+        }
+
+        pinNames.push_back(namedPinGroup.substr(nameStartIdx, commaIdx-nameStartIdx));
+        nameStartIdx = commaIdx+1;
+    }
+
+    gpioControllerBuilder.withPinGroup(groupName, pinNames);
+}
+
 void ArgParser::initGpioToOutputLow(const std::string& UNUSED)
 {
     (void) UNUSED;
     gpioControllerBuilder.withGpioInitializedToOutputLow();
 }
 
-GpioController ArgParser::buildGpioController()
+void ArgParser::initGpioLazily(const std::string& UNUSED)
+{
+    (void) UNUSED;
+    gpioControllerBuilder.withLazyInitialization();
+}
+
+void ArgParser::setGpioSysfsRoot(const std::string& sysfsRoot)
 {
-    return gpioControllerBuilder.build();
+    std::cout << "(ArgParser) Using GPIO sysfs root: " << sysfsRoot << std::endl;
+    gpioControllerBuilder.withSysfsRoot(sysfsRoot);
+}
+
+void ArgParser::setGpioStateFile(const std::string& stateFilePath)
+{
+    std::cout << "(ArgParser) Using GPIO state file: " << stateFilePath << std::endl;
+    gpioControllerBuilder.withStateFile(stateFilePath);
+}
+
+void ArgParser::setGpioMinWriteInterval(const std::string& intervalAsStr)
+{
+    size_t charsParsed = 0;
+    unsigned long intervalMs = std::stoul(intervalAsStr, &charsParsed);
+
+    if (charsParsed != intervalAsStr.length())
+    {
+        throw std::invalid_argument("Specified GPIO write interval: " + intervalAsStr +
+                " is invalid!");
+    }
+
+    std::cout << "(ArgParser) Using minimum GPIO write interval(ms): " << intervalMs
+            << std::endl;
+
+    gpioControllerBuilder.withMinWriteInterval(std::chrono::milliseconds(intervalMs));
+}
+
+void ArgParser::setMetricsPort(const std::string& portAsStr)
+{
+    size_t charsParsed = 0;
+    unsigned long portAsUl = std::stoul(portAsStr, &charsParsed);
+
+    if (charsParsed != portAsStr.length() || portAsUl == 0 || portAsUl > UINT16_MAX)
+    {
+        throw std::invalid_argument("Specified metrics port number: " + portAsStr +
+                " is invalid!");
+    }
+
+    std::cout << "(ArgParser) Using Prometheus metrics port number: " << portAsStr
+            << std::endl;
+
+    serveMetrics = true;
+    prometheusExporterBuilder.withPort(static_cast<uint16_t>(portAsUl));
+}
+
+/**
+ * Tracing is process-wide, so this is applied to the RequestTracer directly
+ * rather than through a builder
+ */
+void ArgParser::setTraceSampleInterval(const std::string& sampleIntervalAsStr)
+{
+    size_t charsParsed = 0;
+    unsigned long sampleInterval = std::stoul(sampleIntervalAsStr, &charsParsed);
+
+    if (charsParsed != sampleIntervalAsStr.length() || sampleInterval > UINT32_MAX)
+    {
+        throw std::invalid_argument("Specified trace sample interval: " + sampleIntervalAsStr +
+                " is invalid!");
+    }
+
+    std::cout << "(ArgParser) Tracing 1 in " << sampleIntervalAsStr << " requests" << std::endl;
+    RequestTracer::getInstance().setSampleInterval(static_cast<uint32_t>(sampleInterval));
+}
+
+void ArgParser::setTraceFile(const std::string& traceFilePath)
+{
+    std::cout << "(ArgParser) Using trace file: " << traceFilePath << std::endl;
+    tcpServerBuilder.withTraceFile(traceFilePath);
+}
+
+void ArgParser::setCommandJournalDirectory(const std::string& journalDirectory)
+{
+    std::cout << "(ArgParser) Using command journal directory: " << journalDirectory << std::endl;
+
+    journalCommands = true;
+    commandJournalBuilder.withDirectory(journalDirectory);
+}
+
+GpioControllerSharedPtr ArgParser::buildGpioController()
+{
+    return gpioControllerBuilder.withTimerWheel(timerWheel).build();
 }
 
 SystemUtilsSharedPtr ArgParser::buildSystemUtils()
 {
-    return systemUtilsBuilder.build();
+    return systemUtilsBuilder.withTimerWheel(timerWheel).withExecService(execService).build();
 }
 
 TcpServerSharedPtr ArgParser::buildTcpServer()
 {
-    return tcpServerBuilder.build();
+    return tcpServerBuilder.withTimerWheel(timerWheel).build();
+}
+
+/**
+ * Returns nullptr unless a metrics port was specified
+ */
+PrometheusExporterSharedPtr ArgParser::buildPrometheusExporter()
+{
+    return serveMetrics ? prometheusExporterBuilder.build() : nullptr;
+}
+
+/**
+ * Returns nullptr unless a journal directory was specified
+ */
+CommandJournalSharedPtr ArgParser::buildCommandJournal()
+{
+    return journalCommands ? commandJournalBuilder.build() : nullptr;
 }
 
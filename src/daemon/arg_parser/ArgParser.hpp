@@ -10,12 +10,17 @@
 
 // System Includes
 #include <cstdint>
+#include <memory>
 #include <string>
 
 // Project Includes
 #include "ArgParserFunction.hpp"
+#include "ExecService.hpp"
+#include "PrometheusExporter.hpp"
+#include "CommandJournal.hpp"
 #include "TcpServer.hpp"
 #include "GpioController.hpp"
+#include "TimerWheel.hpp"
 
 class ArgParser
 {
@@ -23,9 +28,11 @@ public:
     void parse(int argc, const char *argv[]);
 
     // Get generated instances
-    GpioController buildGpioController();
+    GpioControllerSharedPtr buildGpioController();
     TcpServerSharedPtr buildTcpServer();
     SystemUtilsSharedPtr buildSystemUtils();
+    PrometheusExporterSharedPtr buildPrometheusExporter();
+    CommandJournalSharedPtr buildCommandJournal();
 
 private:
 
@@ -35,16 +42,38 @@ private:
     TcpServer::Builder tcpServerBuilder;
     GpioController::Builder gpioControllerBuilder;
     SystemUtils::Builder systemUtilsBuilder;
+    PrometheusExporter::Builder prometheusExporterBuilder;
+    bool serveMetrics = false;
+    CommandJournal::Builder commandJournalBuilder;
+    bool journalCommands = false;
+
+    // Shared by all built instances; turned by the TcpServer's event loop
+    const TimerWheelSharedPtr timerWheel = std::make_shared<TimerWheel>();
+
+    // Forks its helper process here, so the ArgParser must be constructed
+    // before any thread is started
+    const ExecServiceSharedPtr execService = ExecService::start();
 
 
     // Functions which handle their associated arguments
     void setAudioControlName(const std::string& audioControlName);
+    void setMixerType(const std::string& mixerType);
     void setAudioOutputDevice(const std::string& audioOutputDevice);
     void setServerPassword(const std::string& password);
     void setServerPort(const std::string& portAsStr);
     void addGpioPin(const std::string& namedPin);
+    void addGpioInputPin(const std::string& namedInputPin);
+    void addGpioPinGroup(const std::string& namedPinGroup);
     void printHelp(const std::string& UNUSED);
     void initGpioToOutputLow(const std::string& UNUSED);
+    void initGpioLazily(const std::string& UNUSED);
+    void setGpioSysfsRoot(const std::string& sysfsRoot);
+    void setGpioStateFile(const std::string& stateFilePath);
+    void setGpioMinWriteInterval(const std::string& intervalAsStr);
+    void setMetricsPort(const std::string& portAsStr);
+    void setTraceSampleInterval(const std::string& sampleIntervalAsStr);
+    void setTraceFile(const std::string& traceFilePath);
+    void setCommandJournalDirectory(const std::string& journalDirectory);
 
     void executeArgParserFunction(const ArgParserFunction* argParserFunc,
             const std::string& argAsStr, int& argvIdx, const int argc,
@@ -7,14 +7,19 @@
 
 // System Includes
 #include <string>
+#include <chrono>
 #include <iostream>
 #include <csignal>
 #include <cstring>
+#include <pthread.h>
 #include <stdexcept>
 
 // Project Includes
 #include "ArgParser.hpp"
+#include "CommandJournal.hpp"
 #include "CommandParser.hpp"
+#include "GpioController.hpp"
+#include "PrometheusExporter.hpp"
 #include "SystemUtils.hpp"
 #include "TcpServer.hpp"
 
@@ -52,6 +57,8 @@ void terminationSignalHandler(int sigNum)
 
 int main(int argc, const char *argv[])
 {
+    const auto startTime = std::chrono::steady_clock::now();
+
     // Execute terminationSignalHandler() in the event that any of the signals
     // below are caught
     signal(SIGTERM, terminationSignalHandler);
@@ -59,14 +66,61 @@ int main(int argc, const char *argv[])
     signal(SIGINT, terminationSignalHandler);
     signal(SIGKILL, terminationSignalHandler);
 
-    // Parse and apply the command line arguments
+    // Writes to a peer which has gone away, such as a disconnected client or
+    // an exited amixer coprocess, should fail with EPIPE rather than kill
+    // the daemon
+    signal(SIGPIPE, SIG_IGN);
+
+    // SIGUSR1 dumps request traces, and is only unblocked on the TcpServer's
+    // event loop thread, so that it can't interrupt blocking calls such as
+    // accept() on the others. Blocked before any thread is started, so that
+    // they all inherit the mask.
+    sigset_t traceDumpSignals;
+    sigemptyset(&traceDumpSignals);
+    sigaddset(&traceDumpSignals, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &traceDumpSignals, nullptr);
+
+    // Parse and apply the command line arguments. Constructed before any
+    // thread is started, since it forks the exec helper.
     ArgParser argParser{};
     argParser.parse(argc, argv);
 
     // Have the server wait for, accept, and process connections
     tcpServerPtr = argParser.buildTcpServer();
-    CommandParser cmdParser(tcpServerPtr, argParser.buildSystemUtils(),
-            argParser.buildGpioController());
+    GpioControllerSharedPtr gpioControllerPtr = argParser.buildGpioController();
+    SystemUtilsSharedPtr systemUtilsPtr = argParser.buildSystemUtils();
+    CommandJournalSharedPtr commandJournalPtr = argParser.buildCommandJournal();
+    CommandParser cmdParser(tcpServerPtr, systemUtilsPtr, gpioControllerPtr, commandJournalPtr);
+
+    // Push GPIO input edges to subscribed clients as they happen
+    gpioControllerPtr->startInputMonitor([](const GpioInputEvent& inputEvent)
+    {
+        tcpServerPtr->informSubscribedClientsOfGpioInput(inputEvent);
+    });
+
+    // Push volume changes, whether made by a client or another program
+    systemUtilsPtr->startVolumeMonitor([](uint8_t volume)
+    {
+        tcpServerPtr->informSubscribedClientsOfVolumeChange(volume);
+    });
+
+    // Push output pin changes as state deltas, and snapshot both for RESYNC
+    gpioControllerPtr->setOutputChangeCallback([](const GpioController::NamedOutputStates& changes,
+            const std::vector<std::string>& forgottenPins)
+    {
+        tcpServerPtr->informSubscribedClientsOfOutputChange(changes, forgottenPins);
+    });
+    tcpServerPtr->setStateSnapshotSources(systemUtilsPtr, gpioControllerPtr);
+
+    // Serve Prometheus scrapes on their own port and thread, if requested
+    PrometheusExporterSharedPtr prometheusExporterPtr = argParser.buildPrometheusExporter();
+
+    // The listening socket is already bound, so connections are accepted
+    // from here on
+    std::cout << "Ready to accept connections "
+              << std::chrono::duration_cast<std::chrono::microseconds>(
+                      std::chrono::steady_clock::now() - startTime).count()
+              << "us after startup" << std::endl;
 
     tcpServerPtr->run(cmdParser);
 }
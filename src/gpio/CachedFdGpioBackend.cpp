@@ -0,0 +1,61 @@
+/*
+ * CachedFdGpioBackend.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+// System Includes
+#include <cerrno>
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+#include <utility>
+
+// Project Includes
+#include "CachedFdGpioBackend.hpp"
+
+CachedFdGpioBackend::CachedFdGpioBackend(const std::string& sysfsRoot):
+        SysfsGpioBackend(sysfsRoot)
+{
+}
+
+CachedFdGpioBackend::~CachedFdGpioBackend()
+{
+    for (const auto& valueFd : valueFds)
+    {
+        close(valueFd.second);
+    }
+}
+
+/**
+ * Writes value to pinNum's cached value fd, opening it first if needed. A
+ * pin whose file can't be opened isn't cached, so it's retried on the next
+ * write.
+ */
+bool CachedFdGpioBackend::writeValue(uint16_t pinNum, uint8_t value)
+{
+    auto fdIter = valueFds.find(pinNum);
+    if (fdIter == valueFds.end())
+    {
+        std::string valuePath = getValuePath(pinNum);
+        int valueFd = open(valuePath.c_str(), O_WRONLY | O_CLOEXEC);
+        if (valueFd < 0)
+        {
+            std::cerr << "Unable to open: " << valuePath << "; errno "
+                    << errno << std::endl;
+            return false;
+        }
+        fdIter = valueFds.insert(std::make_pair(pinNum, valueFd)).first;
+    }
+
+    const char valueChar = value ? '1' : '0';
+    if (pwrite(fdIter->second, &valueChar, 1, 0) != 1)
+    {
+        std::cerr << "Unable to write pin: " << pinNum << "; errno "
+                << errno << std::endl;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,40 @@
+/*
+ * CachedFdGpioBackend.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+#ifndef GPIO_CACHEDFDGPIOBACKEND_HPP_
+#define GPIO_CACHEDFDGPIOBACKEND_HPP_
+
+// System Includes
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+// Project Includes
+#include "SysfsGpioBackend.hpp"
+
+/**
+ * A SysfsGpioBackend which opens each pin's value file on its first write
+ * and keeps it open, so that each subsequent write is a single pwrite().
+ * This is the backend GpioController uses unless told otherwise.
+ */
+class CachedFdGpioBackend : public SysfsGpioBackend
+{
+public:
+    explicit CachedFdGpioBackend(const std::string& sysfsRoot=DEFAULT_SYSFS_ROOT);
+    ~CachedFdGpioBackend();
+
+    bool writeValue(uint16_t pinNum, uint8_t value) override;
+
+    CachedFdGpioBackend(const CachedFdGpioBackend&) = delete;
+    CachedFdGpioBackend& operator=(const CachedFdGpioBackend&) = delete;
+
+private:
+    // Value file of each pin which has been written
+    std::unordered_map<uint16_t, int> valueFds;
+};
+
+#endif /* GPIO_CACHEDFDGPIOBACKEND_HPP_ */
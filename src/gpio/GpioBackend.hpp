@@ -0,0 +1,60 @@
+/*
+ * GpioBackend.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+#ifndef GPIO_GPIOBACKEND_HPP_
+#define GPIO_GPIOBACKEND_HPP_
+
+// System Includes
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Project Includes
+// <none>
+
+// Foward declaration
+class GpioBackend;
+
+// Typedefs
+using GpioBackendSharedPtr = std::shared_ptr<GpioBackend>;
+
+/**
+ * The pin-level operations which GpioController performs, so that what sits
+ * behind them (sysfs, or memory for tests and benchmarks) can be swapped.
+ * writeValue() and writeAttribute() are serialized by GpioController; the
+ * other methods may be called concurrently with them and with each other.
+ * Failures are logged by the backend and reported by returning false.
+ */
+class GpioBackend
+{
+public:
+    virtual ~GpioBackend() {}
+
+    // Makes each pin available; pins which already are aren't an error
+    virtual void exportPins(const std::vector<uint16_t>& pinNums) = 0;
+
+    // True once pinNum's attributes and value can be written
+    virtual bool isPinReady(uint16_t pinNum) = 0;
+
+    // Writes attribute ("direction" or "edge") of pinNum
+    virtual bool writeAttribute(uint16_t pinNum, const std::string& attribute,
+            const std::string& value) = 0;
+
+    // Drives output pinNum to value (0 or 1)
+    virtual bool writeValue(uint16_t pinNum, uint8_t value) = 0;
+
+    // Reads pinNum's value, as a 0 or 1, into value
+    virtual bool readValue(uint16_t pinNum, uint8_t* value) = 0;
+
+    // The file through which pinNum's value can be polled or written
+    // directly, as done by the input monitor and the PWM engine. Empty if
+    // this backend isn't file based.
+    virtual std::string getValuePath(uint16_t pinNum) const = 0;
+};
+
+#endif /* GPIO_GPIOBACKEND_HPP_ */
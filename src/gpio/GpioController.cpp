@@ -11,31 +11,193 @@
 #include <unordered_map>
 #include <utility>
 #include <cstdint>
-#include <fstream>
-#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 // Project Includes
+#include "CachedFdGpioBackend.hpp"
 #include "GpioController.hpp"
+#include "GpioInputMonitor.hpp"
+#include "GpioPatternPlayer.hpp"
+#include "GpioStateFile.hpp"
+#include "SoftPwmEngine.hpp"
+#include "TimerWheel.hpp"
 
 // Static initialization
-const char * const GpioController::EXPORT_PIN_PATH = "/sys/class/gpio/export";
-const char * const GpioController::UNEXPORT_PIN_PATH = "/sys/class/gpio/unexport";
-const char * const GpioController::PIN_DIRECTION_PATH_FORMAT = "/sys/class/gpio/gpio%u/direction";
-const char * const GpioController::PIN_VALUE_PATH_FORMAT = "/sys/class/gpio/gpio%u/value";
-const std::string GpioController::OUTPUT_DIRECTION = "out";
+const std::string GpioController::DIRECTION_ATTRIBUTE = "direction";
+const std::string GpioController::EDGE_ATTRIBUTE = "edge";
+const std::string GpioController::INPUT_DIRECTION = "in";
+const std::string GpioController::OUTPUT_LOW_DIRECTION = "low";
+const std::string GpioController::OUTPUT_HIGH_DIRECTION = "high";
+const std::chrono::milliseconds GpioController::PIN_ATTRIBUTE_TIMEOUT = std::chrono::seconds(5);
+const MetricsRegistry::Counter GpioController::GPIO_WRITES =
+        MetricsRegistry::getInstance().registerCounter("netsysctrld_gpio_writes_total",
+        "Output pin writes, other than by the PWM engine");
+const MetricsRegistry::Counter GpioController::GPIO_WRITE_FAILURES =
+        MetricsRegistry::getInstance().registerCounter("netsysctrld_gpio_write_failures_total",
+        "Output pin writes which the backend failed to make");
+const std::chrono::milliseconds GpioController::MAX_TRANSITION_DELAY = std::chrono::hours(24);
+const size_t GpioController::MAX_PATTERN_STEPS = 4096;
 
-GpioController::GpioController(const NamedPinMap& pins, bool initializeAllPinsToOutputLow): pins(pins)
+/**
+ * Input pins are always exported and configured, since they can't be read or
+ * monitored otherwise. Output pins are only touched if
+ * initializeAllPinsToOutputLow or lazyInitialization is set, or if
+ * stateFilePath names a snapshot with a saved value for them; see
+ * configurePinsLocked(). An empty stateFilePath disables snapshots. Without
+ * lazyInitialization, this blocks until every pin is initialized. With it,
+ * initialization is left to a background warm-up, and any pin which is used
+ * before the warm-up reaches it is initialized on its first use.
+ */
+GpioController::GpioController(const NamedPinMap& pins, const NamedInputPinMap& inputPins,
+        const PinGroupMap& pinGroups, const GpioBackendSharedPtr& backend,
+        const TimerWheelSharedPtr& timerWheel, const std::string& stateFilePath,
+        std::chrono::milliseconds minWriteInterval, bool initializeAllPinsToOutputLow,
+        bool lazyInitialization):
+        pins(pins), inputPins(inputPins), pinGroups(pinGroups), backend(backend),
+        timerWheel(timerWheel), minWriteInterval(minWriteInterval),
+        patternPlayer(new GpioPatternPlayer(std::bind(
+                &GpioController::writePrecomputedPinValues, this, std::placeholders::_1,
+                std::placeholders::_2)))
+{
+    std::vector<uint16_t> outputPinNums;
+    for (const NamedPin& pin : pins)
+    {
+        outputPinNums.push_back(pin.second);
+    }
+
+    if (!stateFilePath.empty())
+    {
+        stateFile.reset(new GpioStateFile(stateFilePath));
+        savedOutputValues = stateFile->getSavedValues();
+        stateFile->resetPins(outputPinNums);
+        std::cout << "GPIO state file: " << stateFilePath << " has saved values for "
+                << savedOutputValues.size() << " pins" << std::endl;
+    }
+
+    std::vector<uint16_t> pinNums;
+    for (uint16_t pinNum : outputPinNums)
+    {
+        if (initializeAllPinsToOutputLow || lazyInitialization ||
+            savedOutputValues.count(pinNum) != 0)
+        {
+            pinNums.push_back(pinNum);
+        }
+    }
+    for (const NamedInputPinMap::value_type& inputPin : inputPins)
+    {
+        pinNums.push_back(inputPin.second.pinNum);
+    }
+    uninitializedPins.insert(pinNums.begin(), pinNums.end());
+    allPinsInitialized = uninitializedPins.empty();
+
+    if (lazyInitialization)
+    {
+        warmUpThread = std::thread(&GpioController::warmUpPins, this);
+    }
+    else
+    {
+        initializePins(pinNums);
+        inputPinsReady = true;
+    }
+}
+
+/**
+ * Waits for the warm-up, if any, then stops pattern playback. The input
+ * monitor and PWM engine, if running, are stopped by their own destructors.
+ */
+GpioController::~GpioController()
+{
+    if (warmUpThread.joinable())
+    {
+        warmUpThread.join();
+    }
+
+    patternPlayer->stop();
+}
+
+/**
+ * Resolves each pin group's names into pin numbers and constructs the
+ * GpioController. Groups are resolved here rather than in withPinGroup() so
+ * that they may be declared before their pins. If a group refers to a name
+ * which isn't a registered output pin, a std::invalid_argument is thrown.
+ */
+GpioControllerSharedPtr GpioController::Builder::build()
+{
+    PinGroupMap resolvedGroups;
+    GpioBackendSharedPtr resolvedBackend = backend;
+    if (!resolvedBackend)
+    {
+        resolvedBackend = std::make_shared<CachedFdGpioBackend>(sysfsRoot.empty() ?
+                SysfsGpioBackend::DEFAULT_SYSFS_ROOT : sysfsRoot);
+    }
+
+    for (const NamedPinGroupMap::value_type& group : pinGroups)
+    {
+        std::vector<uint16_t> groupPinNums;
+        for (const std::string& pinName : group.second)
+        {
+            auto pinIter = pins.find(pinName);
+            if (pinIter == pins.end())
+            {
+                throw std::invalid_argument("Pin group: " + group.first +
+                        " refers to: " + pinName + ", which isn't a registered output pin");
+            }
+            groupPinNums.push_back(pinIter->second);
+        }
+        resolvedGroups.insert(std::make_pair(group.first, groupPinNums));
+    }
+
+    return GpioControllerSharedPtr(new GpioController(pins, inputPins,
+            resolvedGroups, resolvedBackend, timerWheel, stateFilePath, minWriteInterval,
+            initializeAllPinsToOutputLow, lazyInitialization));
+}
+
+/**
+ * Adds a group of output pins which can be written together with BUS_WRITE.
+ * pinNames is in bit order: pinNames[0] is driven by the least significant
+ * bit. A group must have between 1 and 32 pins, none repeated, and its name
+ * must be unique among groups; otherwise a std::invalid_argument is thrown.
+ */
+GpioController::Builder& GpioController::Builder::withPinGroup(const std::string& name,
+        const std::vector<std::string>& pinNames)
 {
-    if (initializeAllPinsToOutputLow)
+    if (pinGroups.count(name) != 0)
+    {
+        throw std::invalid_argument("Pin group with name: " + name +
+                " already provided; group names must be unique");
+    }
+
+    if (pinNames.empty() || pinNames.size() > 32)
+    {
+        throw std::invalid_argument("Pin group: " + name + " must have between"
+                " 1 and 32 pins");
+    }
+
+    for (size_t idx = 0; idx < pinNames.size(); ++idx)
     {
-        exportAllPinsAndSetToOutputLow();
+        if (std::find(pinNames.begin() + idx + 1, pinNames.end(), pinNames[idx]) != pinNames.end())
+        {
+            throw std::invalid_argument("Pin group: " + name + " lists pin: " +
+                    pinNames[idx] + " more than once");
+        }
     }
+
+    pinGroups.insert(std::make_pair(name, pinNames));
+    return *this;
 }
 
-GpioController GpioController::Builder::build()
+/**
+ * Returns true if name has already been used for an output or input pin
+ */
+bool GpioController::Builder::isPinNameUsed(const std::string& name) const
 {
-    GpioController controller(pins, initializeAllPinsToOutputLow);
-    return controller;
+    return pins.count(name) != 0 || inputPins.count(name) != 0;
 }
 
 /**
@@ -45,7 +207,7 @@ GpioController GpioController::Builder::build()
  */
 GpioController::Builder& GpioController::Builder::withNamedPin(const std::string& name, const uint16_t pinNum)
 {
-    if (pins.count(name) == 0)
+    if (!isPinNameUsed(name))
     {
         this->pins.insert(std::make_pair(name, pinNum));
     }
@@ -57,6 +219,72 @@ GpioController::Builder& GpioController::Builder::withNamedPin(const std::string
     return *this;
 }
 
+/**
+ * Adds an input pin, name->pinNum, which reports changes according to edge.
+ * Input and output pins share a namespace; if name is already in use, a
+ * std::invalid_argument is thrown.
+ */
+GpioController::Builder& GpioController::Builder::withInputPin(const std::string& name,
+        const uint16_t pinNum, InputEdge edge)
+{
+    if (!isPinNameUsed(name))
+    {
+        InputPin inputPin = {pinNum, edge};
+        this->inputPins.insert(std::make_pair(name, inputPin));
+    }
+    else
+    {
+        throw std::invalid_argument("Pin with name: " + name +
+                " already provided; pin names must be unique");
+    }
+    return *this;
+}
+
+/**
+ * Converts one of "none", "rising", "falling" or "both" into an InputEdge.
+ * Any other string results in a std::invalid_argument being thrown.
+ */
+GpioController::InputEdge GpioController::convertStringToInputEdge(const std::string& edgeString)
+{
+    if (edgeString == "none")
+    {
+        return InputEdge::NONE;
+    }
+    else if (edgeString == "rising")
+    {
+        return InputEdge::RISING;
+    }
+    else if (edgeString == "falling")
+    {
+        return InputEdge::FALLING;
+    }
+    else if (edgeString == "both")
+    {
+        return InputEdge::BOTH;
+    }
+    throw std::invalid_argument("Edge: " + edgeString + " invalid; it must be"
+            " one of none, rising, falling or both");
+}
+
+/**
+ * Returns the sysfs "edge" attribute value for edge
+ */
+std::string GpioController::convertInputEdgeToString(InputEdge edge)
+{
+    switch (edge)
+    {
+        case InputEdge::RISING:
+            return "rising";
+        case InputEdge::FALLING:
+            return "falling";
+        case InputEdge::BOTH:
+            return "both";
+        case InputEdge::NONE:
+        default:
+            return "none";
+    }
+}
+
 /**
  * Appends to updatableMessage a list "Name: PinNum" strings.
  */
@@ -73,6 +301,141 @@ void GpioController::getPinMapping(const std::string& UNUSED, std::string* updat
         updatableMessage->append(std::to_string(pin.second));
         updatableMessage->append("\n");
     }
+
+    for (const NamedInputPinMap::value_type& inputPin : inputPins)
+    {
+        updatableMessage->append(inputPin.first);
+        updatableMessage->append(":");
+        updatableMessage->append(std::to_string(inputPin.second.pinNum));
+        updatableMessage->append(":in:");
+        updatableMessage->append(convertInputEdgeToString(inputPin.second.edge));
+        updatableMessage->append("\n");
+    }
+
+    for (const PinGroupMap::value_type& group : pinGroups)
+    {
+        updatableMessage->append(group.first);
+        updatableMessage->append(":group:");
+        for (size_t bitIdx = 0; bitIdx < group.second.size(); ++bitIdx)
+        {
+            if (bitIdx != 0)
+            {
+                updatableMessage->append(",");
+            }
+            updatableMessage->append(getPinName(group.second[bitIdx]));
+        }
+        updatableMessage->append("\n");
+    }
+}
+
+/**
+ * Appends to updatableMessage the current value (0 or 1) of the input pin
+ * named pinName. If no input pin with that name is registered, a
+ * std::invalid_argument is thrown.
+ */
+void GpioController::getInputState(const std::string& pinName, std::string* updatableMessage)
+{
+    auto pinIter = inputPins.find(pinName);
+
+    if (pinIter == inputPins.end())
+    {
+        throw std::invalid_argument("Input pin: " + pinName + " not registered");
+    }
+
+    ensurePinInitialized(pinIter->second.pinNum);
+
+    uint8_t value = 0;
+    if (!backend->readValue(pinIter->second.pinNum, &value))
+    {
+        throw std::runtime_error("Unable to read value of pin: " + pinName);
+    }
+
+    updatableMessage->append("\n");
+    updatableMessage->append(pinName);
+    updatableMessage->append(":");
+    updatableMessage->append(std::to_string(value));
+}
+
+/**
+ * Starts watching all input pins whose edge isn't NONE, executing callback
+ * on the monitor thread for each detected edge. With lazy initialization the
+ * monitor is started once the warm-up has configured the input pins.
+ */
+void GpioController::startInputMonitor(const GpioInputMonitor::InputEventCallback& callback)
+{
+    std::lock_guard<std::mutex> lock{inputMonitorMutex};
+    inputEventCallback = callback;
+    if (inputPinsReady)
+    {
+        createInputMonitorLocked();
+    }
+}
+
+/**
+ * Replaces the output change callback. Changes made before it's set, such as
+ * restoring the state file at startup, aren't reported.
+ */
+void GpioController::setOutputChangeCallback(const OutputChangeCallback& callback)
+{
+    std::lock_guard<std::mutex> lock{pinWriteMutex};
+    outputChangeCallback = callback;
+    changedOutputPins.clear();
+}
+
+/**
+ * Pins driven by PWM, or whose last write failed, aren't included
+ */
+GpioController::NamedOutputStates GpioController::getOutputStates()
+{
+    std::lock_guard<std::mutex> lock{pinWriteMutex};
+
+    NamedOutputStates namedStates;
+    for (const NamedPin& namedPin : pins)
+    {
+        auto stateIter = outputStates.find(namedPin.second);
+        if (stateIter != outputStates.end())
+        {
+            namedStates.emplace_back(namedPin.first, stateIter->second);
+        }
+    }
+    return namedStates;
+}
+
+/**
+ * Creates the input monitor for all input pins which have an edge other than
+ * NONE, and starts its thread. If there are no such pins, nothing is started.
+ * Expects inputMonitorMutex to be held.
+ */
+void GpioController::createInputMonitorLocked()
+{
+    std::vector<GpioInputMonitor::MonitoredPin> pinsToMonitor;
+
+    for (const NamedInputPinMap::value_type& inputPin : inputPins)
+    {
+        if (inputPin.second.edge == InputEdge::NONE)
+        {
+            continue;
+        }
+        GpioInputMonitor::MonitoredPin monitoredPin;
+        monitoredPin.pinName = inputPin.first;
+        monitoredPin.pinNum = inputPin.second.pinNum;
+        monitoredPin.valuePath = backend->getValuePath(inputPin.second.pinNum);
+        if (monitoredPin.valuePath.empty())
+        {
+            std::cerr << "GPIO backend has no value files; input pins won't be monitored"
+                    << std::endl;
+            return;
+        }
+        pinsToMonitor.push_back(monitoredPin);
+    }
+
+    if (pinsToMonitor.empty())
+    {
+        return;
+    }
+
+    inputMonitor.reset(new GpioInputMonitor(pinsToMonitor, inputEventCallback));
+    inputMonitor->start();
 }
 
 /**
@@ -126,122 +489,1273 @@ GpioController::PinState GpioController::convertPinStateCommandToPair(const std:
  * Uses pinInfo, which isexpected to take the form
  * <name>:<output state (0 or 1)>, to set the output state for the pin.
  * Any deviations from this format will result in a std::invalid_argument being thrown.
+ *
+ * If a minimum write interval is configured, a pin is physically written at
+ * most once per interval. A request arriving sooner is deferred to the end
+ * of the interval, and requests arriving while one is deferred replace it,
+ * so the latest state wins and the rest count as saved writes.
  */
 void GpioController::setPinOutputState(const std::string& pinInfo, std::string* updatableMessage)
 {
     (void) updatableMessage;
 
     PinState pinState = convertPinStateCommandToPair(pinInfo);
+    uint16_t pinNum = getOutputPinNum(pinState.first);
 
-    auto pinIter = pins.find(pinState.first);
+    // Before taking pendingTransitionsMutex, so a pin waiting on udev doesn't
+    // hold up every other pin, and so a deferred write never has to wait
+    ensurePinInitialized(pinNum);
 
-    if (pinIter == pins.end())
+    std::unique_lock<std::mutex> lock{pendingTransitionsMutex};
+    ++writeLimitStats.requests;
+
+    if (minWriteInterval.count() == 0)
+    {
+        // An explicitly requested state supersedes any PULSE or SET_AT which
+        // hasn't happened yet. Without rate limiting there's no per pin
+        // state left to guard, so the write itself happens unlocked.
+        cancelPendingTransitions(pinNum);
+        stopPwm(pinNum);
+        ++writeLimitStats.immediateWrites;
+        lock.unlock();
+
+        writeOutputPin(pinNum, pinState.second);
+        return;
+    }
+
+    // Anything else which touched the pin since the deferral was scheduled,
+    // SET_AT included, would have cancelled it, so only its state needs
+    // replacing
+    LimitedPin& limitedPin = limitedPins[pinNum];
+    if (limitedPin.deferredWriteTimer != TimerWheel::INVALID_TIMER_ID)
     {
-        throw std::invalid_argument("Pin: " + pinState.first + " not registered");
+        limitedPin.deferredState = pinState.second;
+        ++writeLimitStats.writesSaved;
+        return;
     }
 
-    std::string path = insertUInt8IntoString(PIN_VALUE_PATH_FORMAT,
-            pinIter->second);
+    cancelPendingTransitions(pinNum);
+    stopPwm(pinNum);
+
+    auto now = std::chrono::steady_clock::now();
+    auto nextWriteTime = limitedPin.lastWriteTime + minWriteInterval;
+    if (limitedPin.lastWriteTime == std::chrono::steady_clock::time_point() ||
+        now >= nextWriteTime)
+    {
+        writeOutputPin(pinNum, pinState.second);
+        limitedPin.lastWriteTime = now;
+        ++writeLimitStats.immediateWrites;
+        return;
+    }
 
-    writePinState(path, pinState.second);
+    limitedPin.deferredState = pinState.second;
+    scheduleDeferredWrite(pinNum, std::chrono::duration_cast<std::chrono::milliseconds>(
+            nextWriteTime - now) + std::chrono::milliseconds(1));
 }
 
 /**
- * Writes the value, converted to a string, to the file located at filePath.
+ * Schedules the deferred OUTPUT_STATE write of rate limited pin pinNum to
+ * happen after delay. The state written is whatever deferredState holds when
+ * the timer fires. Expects pendingTransitionsMutex to be held by the caller,
+ * and pinNum to have been through ensurePinInitialized() already, so the
+ * timer wheel's thread never waits on udev.
  */
-void GpioController::writeUInt8ToFile(const std::string& filePath, uint8_t value)
+void GpioController::scheduleDeferredWrite(uint16_t pinNum, std::chrono::milliseconds delay)
 {
-    writeToFile(filePath, std::to_string(value));
+    if (!timerWheel)
+    {
+        throw std::logic_error("Rate limited GPIO writes are unavailable; no timer wheel in use");
+    }
+
+    // See scheduleTransition() for why the id is held this way
+    std::shared_ptr<TimerWheel::TimerId> timerIdHolder =
+            std::make_shared<TimerWheel::TimerId>(TimerWheel::INVALID_TIMER_ID);
+
+    *timerIdHolder = timerWheel->schedule(delay, [this, pinNum, timerIdHolder]()
+    {
+        std::lock_guard<std::mutex> lock{pendingTransitionsMutex};
+
+        LimitedPin& limitedPin = limitedPins[pinNum];
+
+        // Cancelled after the wheel had already picked it up
+        if (limitedPin.deferredWriteTimer != *timerIdHolder)
+        {
+            return;
+        }
+        limitedPin.deferredWriteTimer = TimerWheel::INVALID_TIMER_ID;
+
+        writeOutputPin(pinNum, limitedPin.deferredState);
+        limitedPin.lastWriteTime = std::chrono::steady_clock::now();
+        ++writeLimitStats.deferredWrites;
+    });
+
+    limitedPins[pinNum].deferredWriteTimer = *timerIdHolder;
 }
 
 /**
- * Writes value to the file located at filePath.
+ * For the GPIO_STATS command. Appends the configured minimum write interval
+ * and how OUTPUT_STATE requests have been handled: written immediately,
+ * written after being deferred, or superseded by a later request before
+ * being written (saved).
  */
-void GpioController::writeToFile(const std::string& filePath, const std::string& value)
+void GpioController::getGpioStatsHandler(const std::string& UNUSED, std::string* updatableMessage)
 {
-    std::cout << "Writing: " << value << " to: " << filePath << std::endl;
+    (void) UNUSED;
 
-    std::ofstream outputFileStream(filePath.c_str());
+    std::lock_guard<std::mutex> lock{pendingTransitionsMutex};
 
-    outputFileStream << value;
+    updatableMessage->append("\nMin write interval(ms): " + std::to_string(minWriteInterval.count()));
+    updatableMessage->append("\nOUTPUT_STATE requests: " + std::to_string(writeLimitStats.requests));
+    updatableMessage->append("\nWritten immediately: " + std::to_string(writeLimitStats.immediateWrites));
+    updatableMessage->append("\nWritten after deferral: " + std::to_string(writeLimitStats.deferredWrites));
+    updatableMessage->append("\nWrites saved: " + std::to_string(writeLimitStats.writesSaved));
 }
 
 /**
- * Writes outputState (internally a 0 or 1) to the file located at filePath.
+ * Returns the pin number of the output pin named pinName. If no such pin is
+ * registered, a std::invalid_argument is thrown.
  */
-void GpioController::writePinState(const std::string& filePath, OutputPinState outputState)
+uint16_t GpioController::getOutputPinNum(const std::string& pinName) const
 {
-    writeToFile(filePath, std::to_string(static_cast<uint8_t>(outputState)));
+    auto pinIter = pins.find(pinName);
+
+    if (pinIter == pins.end())
+    {
+        throw std::invalid_argument("Pin: " + pinName + " not registered");
+    }
+
+    return pinIter->second;
 }
 
 /**
- * Expects formatString to have a single "%u%" in it, and replaces that format
- * character with the the num parameter, returning the new string.
+ * For the PULSE command. pulseInfo is expected to take the form
+ * <name>:<duration in ms>. The pin is set high immediately, and set low by
+ * the timer wheel once the duration has elapsed. Any transitions already
+ * pending for the pin are cancelled first, so re-pulsing extends the pulse.
+ * Deviations from this format result in a std::invalid_argument being thrown.
  */
-std::string GpioController::insertUInt8IntoString(const char * formatString, uint8_t num)
+void GpioController::pulsePinHandler(const std::string& pulseInfo, std::string* updatableMessage)
 {
-    // uint8_t can be at most 3 chars, extra char for null term
-    size_t formattedLength = std::strlen(formatString) + 4;
-    char formatted[formattedLength] = {};
+    (void) updatableMessage;
+
+    auto colonIdx = pulseInfo.find(':');
+    if (colonIdx == std::string::npos || colonIdx == 0 ||
+        colonIdx == pulseInfo.length()-1)
+    {
+        throw std::invalid_argument("Syntax err: " + pulseInfo + "; It must have"
+                " the form \"pinName:durationMs\"");
+    }
+
+    uint16_t pinNum = getOutputPinNum(pulseInfo.substr(0, colonIdx));
+    std::chrono::milliseconds duration =
+            convertDelayToMilliseconds(pulseInfo.substr(colonIdx+1), pulseInfo);
 
-    std::sprintf(formatted, formatString, num);
+    // See setPinOutputState()
+    ensurePinInitialized(pinNum);
 
-    return std::string(formatted);
+    std::lock_guard<std::mutex> lock{pendingTransitionsMutex};
 
+    cancelPendingTransitions(pinNum);
+    stopPwm(pinNum);
+    writeOutputPin(pinNum, OutputPinState::HIGH);
+    scheduleTransition(pinNum, duration, OutputPinState::LOW);
 }
 
 /**
- * Sets all pins stored in pins mapping to output mode with value low.
+ * For the SET_AT command. delayedPinInfo is expected to take the form
+ * <name>:<output state (0 or 1)>@+<delay in ms>. The state is applied by the
+ * timer wheel once the delay has elapsed. A deferred OUTPUT_STATE write for
+ * the pin is dropped, since it was requested earlier and would otherwise
+ * override this state if it was due later. Deviations from this format
+ * result in a std::invalid_argument being thrown.
  */
-void GpioController::setAllToOutputLow(const std::string& UNUSED_IN,
+void GpioController::setPinStateAtHandler(const std::string& delayedPinInfo,
         std::string* updatableMessage)
 {
-    (void) UNUSED_IN;
+    (void) updatableMessage;
 
-    *updatableMessage += "\n";
+    auto atIdx = delayedPinInfo.find("@+");
+    if (atIdx == std::string::npos || atIdx + 2 >= delayedPinInfo.length())
+    {
+        throw std::invalid_argument("Syntax err: " + delayedPinInfo + "; It must have"
+                " the form \"pinName:0(off/low) or 1(on/high)@+delayMs\"");
+    }
 
-    for (auto namedPin : pins)
+    PinState pinState = convertPinStateCommandToPair(delayedPinInfo.substr(0, atIdx));
+    uint16_t pinNum = getOutputPinNum(pinState.first);
+    std::chrono::milliseconds delay =
+            convertDelayToMilliseconds(delayedPinInfo.substr(atIdx+2), delayedPinInfo);
+
+    // See setPinOutputState()
+    ensurePinInitialized(pinNum);
+
+    std::lock_guard<std::mutex> lock{pendingTransitionsMutex};
+    if (cancelDeferredWrite(pinNum))
     {
-        std::string path = insertUInt8IntoString(PIN_VALUE_PATH_FORMAT,
-                namedPin.second);
-        writePinState(path, OutputPinState::LOW);
-        *updatableMessage += "Pin: ";
-        *updatableMessage += namedPin.first;
-        *updatableMessage += " low\n";
+        ++writeLimitStats.writesSaved;
     }
+    scheduleTransition(pinNum, delay, pinState.second);
 }
 
 /**
- * Exports all pins in the pins mapping and sets them to output mode
- * with value low.
+ * For the CANCEL_PENDING command. Cancels every PULSE and SET_AT transition
+ * which is still pending for the output pin named pinName, and appends how
+ * many were cancelled to updatableMessage.
  */
-void GpioController::exportAllPinsAndSetToOutputLow()
+void GpioController::cancelPendingTransitionsHandler(const std::string& pinName,
+        std::string* updatableMessage)
 {
-    for (auto namedPin : pins)
+    uint16_t pinNum = getOutputPinNum(pinName);
+
+    std::lock_guard<std::mutex> lock{pendingTransitionsMutex};
+    size_t numCancelled = cancelPendingTransitions(pinNum);
+
+    updatableMessage->append("\nCancelled: " + std::to_string(numCancelled));
+}
+
+/**
+ * Schedules pinNum to be set to pinState after delay. Expects
+ * pendingTransitionsMutex to be held by the caller; see
+ * scheduleDeferredWrite() for pinNum's initialization.
+ */
+void GpioController::scheduleTransition(uint16_t pinNum, std::chrono::milliseconds delay,
+        OutputPinState pinState)
+{
+    if (!timerWheel)
+    {
+        throw std::logic_error("Timed GPIO commands are unavailable; no timer wheel in use");
+    }
+
+    // The id isn't known until schedule() returns, but the callback can't
+    // run before then since it needs pendingTransitionsMutex, which is held
+    std::shared_ptr<TimerWheel::TimerId> timerIdHolder =
+            std::make_shared<TimerWheel::TimerId>(TimerWheel::INVALID_TIMER_ID);
+
+    *timerIdHolder = timerWheel->schedule(delay, [this, pinNum, pinState, timerIdHolder]()
+    {
+        std::lock_guard<std::mutex> lock{pendingTransitionsMutex};
+
+        std::vector<TimerWheel::TimerId>& pinTimers = pendingTransitions[pinNum];
+        auto timerIter = std::find(pinTimers.begin(), pinTimers.end(), *timerIdHolder);
+
+        // Cancelled after the wheel had already picked it up
+        if (timerIter == pinTimers.end())
+        {
+            return;
+        }
+        pinTimers.erase(timerIter);
+
+        stopPwm(pinNum);
+        writeOutputPin(pinNum, pinState);
+    });
+
+    pendingTransitions[pinNum].push_back(*timerIdHolder);
+}
+
+/**
+ * Cancels all pending transitions for pinNum, including a deferred
+ * OUTPUT_STATE write, and returns how many there were. Expects
+ * pendingTransitionsMutex to be held by the caller.
+ */
+size_t GpioController::cancelPendingTransitions(uint16_t pinNum)
+{
+    size_t numCancelled = cancelDeferredWrite(pinNum) ? 1 : 0;
+
+    auto pinIter = pendingTransitions.find(pinNum);
+    if (pinIter == pendingTransitions.end())
     {
-        // Export pin
-        writeUInt8ToFile(EXPORT_PIN_PATH, namedPin.second);
-        std::cout << "Exported pin: Name=" << namedPin.first << "; Num=" << namedPin.second << std::endl;
+        return numCancelled;
+    }
 
-        // Set to output direction
-        std::string directionPath = insertUInt8IntoString(PIN_DIRECTION_PATH_FORMAT,
-                   namedPin.second);
-        writeToFile(directionPath, OUTPUT_DIRECTION);
-        std::cout << "Set pin: Name=" << namedPin.first << "; Num=" << namedPin.second <<
-                " to direction:" << OUTPUT_DIRECTION << std::endl;
+    numCancelled += pinIter->second.size();
+    for (TimerWheel::TimerId timerId : pinIter->second)
+    {
+        timerWheel->cancel(timerId);
+    }
+    pendingTransitions.erase(pinIter);
 
-        // Set low
-        std::string valuePath = insertUInt8IntoString(PIN_VALUE_PATH_FORMAT,
-                   namedPin.second);
-        writePinState(valuePath, OutputPinState::LOW);
-        std::cout << "Set pin: Name=" << namedPin.first << "; Num=" << namedPin.second <<
-                " to value LOW" << std::endl;
+    return numCancelled;
+}
 
+/**
+ * Cancels pinNum's deferred OUTPUT_STATE write, if it has one, and returns
+ * whether it had. Expects pendingTransitionsMutex to be held by the caller.
+ */
+bool GpioController::cancelDeferredWrite(uint16_t pinNum)
+{
+    auto limitedIter = limitedPins.find(pinNum);
+    if (limitedIter == limitedPins.end() ||
+        limitedIter->second.deferredWriteTimer == TimerWheel::INVALID_TIMER_ID)
+    {
+        return false;
     }
+
+    timerWheel->cancel(limitedIter->second.deferredWriteTimer);
+    limitedIter->second.deferredWriteTimer = TimerWheel::INVALID_TIMER_ID;
+    return true;
 }
 
-GpioController::Builder& GpioController::Builder::withGpioInitializedToOutputLow()
+/**
+ * For the BUS_WRITE command. busInfo is expected to take the form
+ * <group name>:<value>, where value may be decimal or 0x-prefixed hex. Bit i
+ * of value is written to the group's i-th pin. All of the group's pins are
+ * written in one locked pass, and pins already in the requested state are
+ * skipped. Deviations from this format, or a value wider than the group,
+ * result in a std::invalid_argument being thrown.
+ */
+void GpioController::busWriteHandler(const std::string& busInfo, std::string* updatableMessage)
 {
-    initializeAllPinsToOutputLow = true;
+    (void) updatableMessage;
+
+    auto colonIdx = busInfo.find(':');
+    if (colonIdx == std::string::npos || colonIdx == 0 ||
+        colonIdx == busInfo.length()-1)
+    {
+        throw std::invalid_argument("Syntax err: " + busInfo + "; It must have"
+                " the form \"groupName:value\"");
+    }
+
+    std::string groupName = busInfo.substr(0, colonIdx);
+    auto groupIter = pinGroups.find(groupName);
+    if (groupIter == pinGroups.end())
+    {
+        throw std::invalid_argument("Pin group: " + groupName + " not registered");
+    }
+
+    std::string valueString = busInfo.substr(colonIdx+1);
+    unsigned long long value;
+    size_t charsParsed = 0;
+    try
+    {
+        value = std::stoull(valueString, &charsParsed, 0);
+    }
+    catch (std::logic_error& except)
+    {
+        throw std::invalid_argument("Syntax err: " + busInfo + "; the value"
+                " must be a decimal or 0x-prefixed hex number");
+    }
+
+    const std::vector<uint16_t>& groupPins = groupIter->second;
+    if (charsParsed != valueString.length() || (value >> groupPins.size()) != 0)
+    {
+        throw std::invalid_argument("Value: " + valueString + " doesn't fit in"
+                " the " + std::to_string(groupPins.size()) + " pins of group: " + groupName);
+    }
+
+    std::vector<PinNumState> pinStates;
+    for (size_t bitIdx = 0; bitIdx < groupPins.size(); ++bitIdx)
+    {
+        pinStates.push_back(PinNumState(groupPins[bitIdx],
+                ((value >> bitIdx) & 1) ? OutputPinState::HIGH : OutputPinState::LOW));
+    }
+
+    // See setPinOutputState()
+    ensurePinsInitialized(groupPins);
+
+    std::lock_guard<std::mutex> lock{pendingTransitionsMutex};
+    for (const PinNumState& pinState : pinStates)
+    {
+        cancelPendingTransitions(pinState.first);
+        stopPwm(pinState.first);
+    }
+
+    writeOutputPins(pinStates);
+}
+
+/**
+ * For the PATTERN command. patternInfo is expected to take the form
+ * <pattern name>:<group name>:<bitmap>@<delay ms>,<bitmap>@<delay ms>,...
+ * where each bitmap (decimal or 0x hex) is applied to the group's pins as
+ * with BUS_WRITE and then held for its delay. The pattern is compiled into
+ * per-step writes immediately and stored under its name, replacing any
+ * pattern of the same name. Deviations from this format result in a
+ * std::invalid_argument being thrown.
+ */
+void GpioController::uploadPatternHandler(const std::string& patternInfo,
+        std::string* updatableMessage)
+{
+    auto firstColonIdx = patternInfo.find(':');
+    auto secondColonIdx = firstColonIdx == std::string::npos ?
+            std::string::npos : patternInfo.find(':', firstColonIdx+1);
+
+    if (firstColonIdx == std::string::npos || secondColonIdx == std::string::npos ||
+        firstColonIdx == 0 || secondColonIdx == firstColonIdx+1 ||
+        secondColonIdx == patternInfo.length()-1)
+    {
+        throw std::invalid_argument("Syntax err: " + patternInfo + "; It must have"
+                " the form \"patternName:groupName:bitmap@delayMs,...\"");
+    }
+
+    std::string patternName = patternInfo.substr(0, firstColonIdx);
+    std::string groupName = patternInfo.substr(firstColonIdx+1, secondColonIdx-firstColonIdx-1);
+
+    auto groupIter = pinGroups.find(groupName);
+    if (groupIter == pinGroups.end())
+    {
+        throw std::invalid_argument("Pin group: " + groupName + " not registered");
+    }
+    const std::vector<uint16_t>& groupPins = groupIter->second;
+
+    std::vector<GpioPatternPlayer::PatternStep> steps;
+    size_t stepStartIdx = secondColonIdx+1;
+    while (stepStartIdx <= patternInfo.length())
+    {
+        size_t commaIdx = patternInfo.find(',', stepStartIdx);
+        if (commaIdx == std::string::npos)
+        {
+            commaIdx = patternInfo.length();
+        }
+        std::string step = patternInfo.substr(stepStartIdx, commaIdx-stepStartIdx);
+        stepStartIdx = commaIdx+1;
+
+        auto atIdx = step.find('@');
+        if (atIdx == std::string::npos || atIdx == 0 || atIdx == step.length()-1)
+        {
+            throw std::invalid_argument("Syntax err: step \"" + step + "\"; each"
+                    " step must have the form \"bitmap@delayMs\"");
+        }
+
+        std::string bitmapString = step.substr(0, atIdx);
+        unsigned long long bitmap;
+        size_t charsParsed = 0;
+        try
+        {
+            bitmap = std::stoull(bitmapString, &charsParsed, 0);
+        }
+        catch (std::logic_error& except)
+        {
+            throw std::invalid_argument("Syntax err: step \"" + step + "\"; the"
+                    " bitmap must be a decimal or 0x-prefixed hex number");
+        }
+        if (charsParsed != bitmapString.length() || (bitmap >> groupPins.size()) != 0)
+        {
+            throw std::invalid_argument("Bitmap: " + bitmapString + " doesn't fit in"
+                    " the " + std::to_string(groupPins.size()) + " pins of group: " + groupName);
+        }
+
+        steps.push_back(GpioPatternPlayer::PatternStep(static_cast<uint32_t>(bitmap),
+                convertDelayToMilliseconds(step.substr(atIdx+1), step)));
+
+        if (steps.size() > MAX_PATTERN_STEPS)
+        {
+            throw std::invalid_argument("Patterns may have at most " +
+                    std::to_string(MAX_PATTERN_STEPS) + " steps");
+        }
+    }
+
+    GpioPatternPlayer::CompiledPatternSharedPtr compiled =
+            GpioPatternPlayer::compile(groupPins, steps);
+
+    std::lock_guard<std::mutex> lock{patternsMutex};
+    patterns[patternName] = compiled;
+
+    updatableMessage->append("\nPattern: " + patternName + " steps: " +
+            std::to_string(steps.size()));
+}
+
+/**
+ * For the PLAY command. playInfo is expected to be <pattern name> to play a
+ * pattern once, or <pattern name>:loop to repeat it until STOP_PATTERN.
+ * Any pattern already playing is replaced. The pins of the pattern's group
+ * have their pending transitions cancelled and PWM stopped before the first
+ * step is written.
+ */
+void GpioController::playPatternHandler(const std::string& playInfo,
+        std::string* updatableMessage)
+{
+    (void) updatableMessage;
+
+    std::string patternName = playInfo;
+    bool loop = false;
+
+    auto colonIdx = playInfo.find(':');
+    if (colonIdx != std::string::npos)
+    {
+        if (playInfo.substr(colonIdx+1) != "loop")
+        {
+            throw std::invalid_argument("Syntax err: " + playInfo + "; It must have"
+                    " the form \"patternName\" or \"patternName:loop\"");
+        }
+        patternName = playInfo.substr(0, colonIdx);
+        loop = true;
+    }
+
+    GpioPatternPlayer::CompiledPatternSharedPtr pattern;
+    {
+        std::lock_guard<std::mutex> lock{patternsMutex};
+        auto patternIter = patterns.find(patternName);
+        if (patternIter == patterns.end())
+        {
+            throw std::invalid_argument("Pattern: " + patternName + " not uploaded");
+        }
+        pattern = patternIter->second;
+    }
+
+    std::lock_guard<std::mutex> lock{pendingTransitionsMutex};
+    for (const std::pair<uint16_t, uint8_t>& pinValue : pattern->steps.front().writes)
+    {
+        cancelPendingTransitions(pinValue.first);
+        stopPwm(pinValue.first);
+    }
+
+    patternPlayer->play(patternName, pattern, loop);
+}
+
+/**
+ * For the STOP_PATTERN command. Stops the playing pattern, if any, leaving
+ * its pins in the state of the last step written.
+ */
+void GpioController::stopPatternHandler(const std::string& UNUSED,
+        std::string* updatableMessage)
+{
+    (void) UNUSED;
+
+    std::string playingName = patternPlayer->getPlayingName();
+    if (patternPlayer->stop())
+    {
+        updatableMessage->append("\nStopped: " + playingName);
+    }
+    else
+    {
+        updatableMessage->append("\nNo pattern playing");
+    }
+}
+
+/**
+ * Writes pinValues exactly as given, without consulting or logging against
+ * the state cache beforehand. Used by the pattern player, whose steps were
+ * already reduced to the pins which change. Nothing is written if
+ * stepCheck reports, under pinWriteMutex, that the pattern has been stopped
+ * or replaced meanwhile, so a step can't land after ALL_LOW's writes.
+ */
+void GpioController::writePrecomputedPinValues(const PinValueList& pinValues,
+        const GpioPatternPlayer::StepCheck& stepCheck)
+{
+    if (!allPinsInitialized.load(std::memory_order_acquire))
+    {
+        std::vector<uint16_t> pinNums;
+        for (const std::pair<uint16_t, uint8_t>& pinValue : pinValues)
+        {
+            pinNums.push_back(pinValue.first);
+        }
+        ensurePinsInitialized(pinNums);
+    }
+
+    std::lock_guard<std::mutex> lock{pinWriteMutex};
+    if (!stepCheck())
+    {
+        return;
+    }
+    for (const std::pair<uint16_t, uint8_t>& pinValue : pinValues)
+    {
+        writeOutputPinLocked(pinValue.first,
+                pinValue.second ? OutputPinState::HIGH : OutputPinState::LOW);
+    }
+    publishOutputChangesLocked();
+}
+
+/**
+ * For the PWM command. pwmInfo is expected to take the form
+ * <name>:<duty cycle percent>:<frequency Hz>. A duty cycle of 0 or 100 stops
+ * PWM on the pin and leaves it low or high respectively. Any pending PULSE or
+ * SET_AT transitions on the pin are cancelled. Deviations from this format
+ * result in a std::invalid_argument being thrown.
+ */
+void GpioController::setPwmHandler(const std::string& pwmInfo, std::string* updatableMessage)
+{
+    (void) updatableMessage;
+
+    auto firstColonIdx = pwmInfo.find(':');
+    auto secondColonIdx = firstColonIdx == std::string::npos ?
+            std::string::npos : pwmInfo.find(':', firstColonIdx+1);
+
+    if (firstColonIdx == std::string::npos || secondColonIdx == std::string::npos ||
+        firstColonIdx == 0 || secondColonIdx == pwmInfo.length()-1 ||
+        pwmInfo.find(':', secondColonIdx+1) != std::string::npos)
+    {
+        throw std::invalid_argument("Syntax err: " + pwmInfo + "; It must have"
+                " the form \"pinName:dutyPercent:frequencyHz\"");
+    }
+
+    uint16_t pinNum = getOutputPinNum(pwmInfo.substr(0, firstColonIdx));
+
+    double dutyPercent;
+    double frequencyHz;
+    try
+    {
+        dutyPercent = std::stod(pwmInfo.substr(firstColonIdx+1, secondColonIdx-firstColonIdx-1));
+        frequencyHz = std::stod(pwmInfo.substr(secondColonIdx+1));
+    }
+    catch (std::logic_error& except)
+    {
+        throw std::invalid_argument("Syntax err: " + pwmInfo + "; the duty cycle"
+                " and frequency must be numbers");
+    }
+
+    if (dutyPercent < 0.0 || dutyPercent > 100.0)
+    {
+        throw std::invalid_argument("Syntax err: " + pwmInfo + "; the duty cycle"
+                " must be between 0 and 100");
+    }
+
+    // See setPinOutputState()
+    ensurePinInitialized(pinNum);
+
+    std::lock_guard<std::mutex> lock{pendingTransitionsMutex};
+    cancelPendingTransitions(pinNum);
+
+    if (dutyPercent == 0.0 || dutyPercent == 100.0)
+    {
+        stopPwm(pinNum);
+        writeOutputPin(pinNum, dutyPercent == 0.0 ? OutputPinState::LOW : OutputPinState::HIGH);
+        return;
+    }
+
+    // The engine drives the value file itself
+    std::string valuePath = backend->getValuePath(pinNum);
+    if (valuePath.empty())
+    {
+        throw std::invalid_argument("PWM isn't supported by this GPIO backend");
+    }
+
+    // The engine writes the pin behind the state cache's back
+    forgetOutputState(pinNum);
+
+    std::lock_guard<std::mutex> pwmLock{pwmEngineMutex};
+    if (!pwmEngine)
+    {
+        pwmEngine.reset(new SoftPwmEngine());
+    }
+    pwmEngine->setChannel(pinNum, valuePath, dutyPercent, frequencyHz);
+}
+
+/**
+ * For the PWM_STATS command. Appends the PWM engine's wakeup lateness and,
+ * per running channel, its nominal and achieved period, the worst single
+ * period error, and how many periods were skipped because the engine fell
+ * behind. Missed periods mean the engine is saturated.
+ */
+void GpioController::getPwmStatsHandler(const std::string& UNUSED, std::string* updatableMessage)
+{
+    (void) UNUSED;
+
+    std::lock_guard<std::mutex> pwmLock{pwmEngineMutex};
+    if (!pwmEngine)
+    {
+        updatableMessage->append("\nPWM engine not started");
+        return;
+    }
+
+    SoftPwmEngine::EngineStats stats = pwmEngine->getStats();
+
+    updatableMessage->append("\nRealtime: ");
+    updatableMessage->append(stats.realtime ? "yes" : "no");
+    updatableMessage->append("\nWakeups: " + std::to_string(stats.wakeups));
+    updatableMessage->append("\nLateness mean(us): " + std::to_string(stats.meanLatenessNs / 1000.0));
+    updatableMessage->append("\nLateness max(us): " + std::to_string(stats.maxLatenessNs / 1000.0));
+
+    for (const SoftPwmEngine::ChannelStats& channel : stats.channels)
+    {
+        updatableMessage->append("\n" + getPinName(channel.pinNum) + ":");
+        updatableMessage->append(" duty=" + std::to_string(channel.dutyPercent) + "%");
+        updatableMessage->append(" freq=" + std::to_string(channel.frequencyHz) + "Hz");
+        updatableMessage->append(" period(us)=" + std::to_string(channel.nominalPeriodNs / 1000.0));
+        updatableMessage->append(" achieved(us)=" + std::to_string(channel.achievedPeriodNs / 1000.0));
+        updatableMessage->append(" jitter max(us)=" + std::to_string(channel.maxPeriodErrorNs / 1000.0));
+        updatableMessage->append(" periods=" + std::to_string(channel.periods));
+        updatableMessage->append(" missed=" + std::to_string(channel.missedPeriods));
+    }
+}
+
+/**
+ * Stops PWM on pinNum, if it's running, so that a directly written state
+ * isn't overwritten by the engine's next edge
+ */
+void GpioController::stopPwm(uint16_t pinNum)
+{
+    std::lock_guard<std::mutex> pwmLock{pwmEngineMutex};
+    if (pwmEngine)
+    {
+        pwmEngine->stopChannel(pinNum);
+    }
+}
+
+/**
+ * Returns the name of the output pin with number pinNum, or the number
+ * itself if it isn't registered
+ */
+std::string GpioController::getPinName(uint16_t pinNum) const
+{
+    for (const NamedPin& pin : pins)
+    {
+        if (pin.second == pinNum)
+        {
+            return pin.first;
+        }
+    }
+    return std::to_string(pinNum);
+}
+
+/**
+ * Converts delay, a positive number of milliseconds no greater than
+ * MAX_TRANSITION_DELAY, into a std::chrono::milliseconds. fullParam is only
+ * used for error messages. Invalid values result in a std::invalid_argument.
+ */
+std::chrono::milliseconds GpioController::convertDelayToMilliseconds(const std::string& delay,
+        const std::string& fullParam)
+{
+    unsigned long delayMs;
+    size_t charsParsed = 0;
+    try
+    {
+        delayMs = std::stoul(delay, &charsParsed);
+    }
+    catch (std::logic_error& except)
+    {
+        throw std::invalid_argument("Syntax err: " + fullParam + "; the delay"
+                " must be a number of milliseconds");
+    }
+
+    if (charsParsed != delay.length() || delayMs == 0 ||
+        std::chrono::milliseconds(delayMs) > MAX_TRANSITION_DELAY)
+    {
+        throw std::invalid_argument("Syntax err: " + fullParam + "; the delay"
+                " must be between 1 and " + std::to_string(MAX_TRANSITION_DELAY.count()) + "ms");
+    }
+
+    return std::chrono::milliseconds(delayMs);
+}
+
+/**
+ * Writes pinState (internally a 0 or 1) to the value file of output pin
+ * pinNum, and records it in outputStates.
+ */
+void GpioController::writeOutputPin(uint16_t pinNum, OutputPinState pinState)
+{
+    ensurePinInitialized(pinNum);
+
+    std::lock_guard<std::mutex> lock{pinWriteMutex};
+    writeOutputPinLocked(pinNum, pinState);
+    publishOutputChangesLocked();
+}
+
+/**
+ * Writes every entry of pinStates while holding pinWriteMutex, so no other
+ * write from this process can land in between. Pins which are already known
+ * to be in their requested state aren't written.
+ */
+void GpioController::writeOutputPins(const std::vector<PinNumState>& pinStates)
+{
+    if (!allPinsInitialized.load(std::memory_order_acquire))
+    {
+        std::vector<uint16_t> pinNums;
+        for (const PinNumState& pinState : pinStates)
+        {
+            pinNums.push_back(pinState.first);
+        }
+        ensurePinsInitialized(pinNums);
+    }
+
+    std::lock_guard<std::mutex> lock{pinWriteMutex};
+
+    size_t numWritten = 0;
+    for (const PinNumState& pinState : pinStates)
+    {
+        auto stateIter = outputStates.find(pinState.first);
+        if (stateIter != outputStates.end() && stateIter->second == pinState.second)
+        {
+            continue;
+        }
+        writeOutputPinLocked(pinState.first, pinState.second);
+        ++numWritten;
+    }
+    publishOutputChangesLocked();
+
+    std::cout << "Bulk write: " << numWritten << " of " << pinStates.size()
+            << " pins changed" << std::endl;
+}
+
+/**
+ * Writes pinState to pinNum through the backend. Failures are logged by the
+ * backend rather than thrown, and leave the pin's state unknown. Expects
+ * pinWriteMutex to be held, and pinNum to have been through
+ * ensurePinsInitialized() before it was taken.
+ */
+void GpioController::writeOutputPinLocked(uint16_t pinNum, OutputPinState pinState)
+{
+    GPIO_WRITES.increment();
+    if (!backend->writeValue(pinNum, static_cast<uint8_t>(pinState)))
+    {
+        GPIO_WRITE_FAILURES.increment();
+        forgetOutputStateLocked(pinNum);
+        return;
+    }
+
+    recordOutputStateLocked(pinNum, pinState);
+}
+
+/**
+ * Records pinState as pinNum's state, in outputStates and in the state file
+ * if there is one. Expects pinWriteMutex to be held.
+ */
+void GpioController::recordOutputStateLocked(uint16_t pinNum, OutputPinState pinState)
+{
+    auto stateIter = outputStates.find(pinNum);
+    if ((stateIter == outputStates.end() || stateIter->second != pinState) &&
+        std::find(changedOutputPins.begin(), changedOutputPins.end(), pinNum) ==
+        changedOutputPins.end())
+    {
+        changedOutputPins.push_back(pinNum);
+    }
+
+    outputStates[pinNum] = pinState;
+    if (stateFile)
+    {
+        stateFile->setValue(pinNum, static_cast<uint8_t>(pinState));
+    }
+}
+
+/**
+ * Marks pinNum's state as unknown, in outputStates and in the state file if
+ * there is one, and if it was known, has that published with the next
+ * changes. Expects pinWriteMutex to be held.
+ */
+void GpioController::forgetOutputStateLocked(uint16_t pinNum)
+{
+    if (outputStates.erase(pinNum) != 0 &&
+        std::find(changedOutputPins.begin(), changedOutputPins.end(), pinNum) ==
+        changedOutputPins.end())
+    {
+        changedOutputPins.push_back(pinNum);
+    }
+    if (stateFile)
+    {
+        stateFile->clearValue(pinNum);
+    }
+}
+
+/**
+ * Executes the output change callback, if there is one, with the pins in
+ * changedOutputPins, and clears it. Pins whose state has since been
+ * forgotten are reported as unknown. Expects pinWriteMutex to be held.
+ */
+void GpioController::publishOutputChangesLocked()
+{
+    if (changedOutputPins.empty())
+    {
+        return;
+    }
+
+    NamedOutputStates changes;
+    std::vector<std::string> forgottenPins;
+    for (uint16_t pinNum : changedOutputPins)
+    {
+        auto stateIter = outputStates.find(pinNum);
+        if (stateIter != outputStates.end())
+        {
+            changes.emplace_back(getPinName(pinNum), stateIter->second);
+        }
+        else
+        {
+            forgottenPins.push_back(getPinName(pinNum));
+        }
+    }
+    changedOutputPins.clear();
+
+    if (outputChangeCallback)
+    {
+        outputChangeCallback(changes, forgottenPins);
+    }
+}
+
+/**
+ * Marks pinNum's state as unknown, so the next bulk write will write it
+ * regardless of what was last written
+ */
+void GpioController::forgetOutputState(uint16_t pinNum)
+{
+    std::lock_guard<std::mutex> lock{pinWriteMutex};
+    forgetOutputStateLocked(pinNum);
+    publishOutputChangesLocked();
+}
+
+/**
+ * Sets all pins stored in pins mapping to output mode with value low.
+ */
+void GpioController::setAllToOutputLow(const std::string& UNUSED_IN,
+        std::string* updatableMessage)
+{
+    (void) UNUSED_IN;
+
+    patternPlayer->stop();
+
+    // See setPinOutputState()
+    std::vector<uint16_t> pinNums;
+    for (const NamedPin& pin : pins)
+    {
+        pinNums.push_back(pin.second);
+    }
+    ensurePinsInitialized(pinNums);
+
+    std::lock_guard<std::mutex> lock{pendingTransitionsMutex};
+
+    {
+        std::lock_guard<std::mutex> pwmLock{pwmEngineMutex};
+        if (pwmEngine)
+        {
+            pwmEngine->stopAllChannels();
+        }
+    }
+
+    *updatableMessage += "\n";
+
+    std::vector<PinNumState> pinStates;
+    for (auto namedPin : pins)
+    {
+        cancelPendingTransitions(namedPin.second);
+        pinStates.push_back(PinNumState(namedPin.second, OutputPinState::LOW));
+        *updatableMessage += "Pin: ";
+        *updatableMessage += namedPin.first;
+        *updatableMessage += " low\n";
+    }
+
+    // Every pin is written, since PWM may have left any of them high
+    {
+        std::lock_guard<std::mutex> writeLock{pinWriteMutex};
+        for (const PinNumState& pinState : pinStates)
+        {
+            forgetOutputStateLocked(pinState.first);
+        }
+    }
+    writeOutputPins(pinStates);
+}
+
+/**
+ * Brings the pins in pinNums into their configured state. Rather than
+ * walking the pins one at a time, each phase is applied to all pins before
+ * the next begins:
+ *   1. every pin is written to the export file
+ *   2. all pins' attribute files are waited on together, since udev creates
+ *      them (and fixes their permissions) asynchronously after export
+ *   3. every pin's direction and, for inputs, edge is written; see
+ *      configurePinsLocked()
+ * Only the last phase holds pinWriteMutex, so commands aren't held up while
+ * waiting on udev. The time taken by each phase is logged.
+ */
+void GpioController::initializePins(const std::vector<uint16_t>& pinNums)
+{
+    if (pinNums.empty())
+    {
+        return;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    // Phase 1: exports
+    backend->exportPins(pinNums);
+    auto exportedTime = std::chrono::steady_clock::now();
+
+    // Phase 2: wait for the attribute files
+    std::vector<uint16_t> pinsNotReady = waitForPinAttributes(pinNums);
+    auto readyTime = std::chrono::steady_clock::now();
+
+    // Phase 3: directions, output values and edges
+    {
+        std::lock_guard<std::mutex> lock{pinWriteMutex};
+        configurePinsLocked(pinNums, pinsNotReady);
+    }
+    auto endTime = std::chrono::steady_clock::now();
+
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+    std::cout << "GPIO init: " << pinNums.size() - pinsNotReady.size() << " of "
+            << pinNums.size() << " pins initialized in "
+            << duration_cast<microseconds>(endTime - startTime).count() << "us (export "
+            << duration_cast<microseconds>(exportedTime - startTime).count() << "us, wait "
+            << duration_cast<microseconds>(readyTime - exportedTime).count() << "us, configure "
+            << duration_cast<microseconds>(endTime - readyTime).count() << "us)" << std::endl;
+}
+
+/**
+ * Writes the direction of each pin in pinNums which is still in
+ * uninitializedPins, then the edge of each such input pin, and removes them
+ * from uninitializedPins. Outputs use the "high" direction if the state file
+ * saved them as high, and "low" otherwise; either sets the direction and
+ * drives the pin in a single glitch-free write, so restoring a snapshot
+ * doesn't disturb a pin which is already in its saved state. Pins listed
+ * in pinsNotReady are reported and removed without being written, so that a
+ * missing pin is only waited on once. Pins no longer in uninitializedPins
+ * were configured by someone else (e.g. on first use) and may since have been
+ * written, so they're left alone. Expects pinWriteMutex to be held.
+ */
+void GpioController::configurePinsLocked(const std::vector<uint16_t>& pinNums,
+        const std::vector<uint16_t>& pinsNotReady)
+{
+    std::vector<const InputPin*> inputsToConfigure;
+
+    for (uint16_t pinNum : pinNums)
+    {
+        if (uninitializedPins.erase(pinNum) == 0)
+        {
+            continue;
+        }
+
+        if (std::find(pinsNotReady.begin(), pinsNotReady.end(), pinNum) != pinsNotReady.end())
+        {
+            std::cerr << "GPIO init: pin " << pinNum << " attributes didn't appear within "
+                    << PIN_ATTRIBUTE_TIMEOUT.count() << "ms; it won't be configured" << std::endl;
+            continue;
+        }
+
+        auto inputIter = std::find_if(inputPins.begin(), inputPins.end(),
+                [pinNum](const NamedInputPinMap::value_type& inputPin)
+                {
+                    return inputPin.second.pinNum == pinNum;
+                });
+
+        if (inputIter != inputPins.end())
+        {
+            if (backend->writeAttribute(pinNum, DIRECTION_ATTRIBUTE, INPUT_DIRECTION))
+            {
+                inputsToConfigure.push_back(&inputIter->second);
+            }
+        }
+        else
+        {
+            auto savedIter = savedOutputValues.find(pinNum);
+            OutputPinState pinState = savedIter != savedOutputValues.end() && savedIter->second ?
+                    OutputPinState::HIGH : OutputPinState::LOW;
+
+            if (backend->writeAttribute(pinNum, DIRECTION_ATTRIBUTE,
+                    pinState == OutputPinState::HIGH ? OUTPUT_HIGH_DIRECTION : OUTPUT_LOW_DIRECTION))
+            {
+                recordOutputStateLocked(pinNum, pinState);
+            }
+        }
+    }
+
+    for (const InputPin* inputPin : inputsToConfigure)
+    {
+        backend->writeAttribute(inputPin->pinNum, EDGE_ATTRIBUTE,
+                convertInputEdgeToString(inputPin->edge));
+    }
+
+    if (uninitializedPins.empty())
+    {
+        allPinsInitialized.store(true, std::memory_order_release);
+    }
+}
+
+/**
+ * Initializes pinNum now if it hasn't been yet; see ensurePinsInitialized()
+ */
+void GpioController::ensurePinInitialized(uint16_t pinNum)
+{
+    ensurePinsInitialized(std::vector<uint16_t>{pinNum});
+}
+
+/**
+ * With lazy initialization, exports and configures those of pinNums which
+ * the warm-up hasn't reached yet, so their first use only waits on them.
+ * Like initializePins(), the export and the wait for udev happen without
+ * pinWriteMutex, so writes to pins which are already initialized carry on
+ * meanwhile. If the warm-up or another first use gets to a pin first,
+ * configurePinsLocked() leaves it to them. Does nothing once every pin is
+ * initialized, which is the common case. Mustn't be called with
+ * pinWriteMutex held.
+ */
+void GpioController::ensurePinsInitialized(const std::vector<uint16_t>& pinNums)
+{
+    if (allPinsInitialized.load(std::memory_order_acquire))
+    {
+        return;
+    }
+
+    std::vector<uint16_t> pinsToInitialize;
+    {
+        std::lock_guard<std::mutex> lock{pinWriteMutex};
+        for (uint16_t pinNum : pinNums)
+        {
+            if (uninitializedPins.count(pinNum) != 0 &&
+                    std::find(pinsToInitialize.begin(), pinsToInitialize.end(), pinNum) ==
+                    pinsToInitialize.end())
+            {
+                pinsToInitialize.push_back(pinNum);
+            }
+        }
+    }
+    if (pinsToInitialize.empty())
+    {
+        return;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    backend->exportPins(pinsToInitialize);
+    std::vector<uint16_t> pinsNotReady = waitForPinAttributes(pinsToInitialize);
+    {
+        std::lock_guard<std::mutex> lock{pinWriteMutex};
+        configurePinsLocked(pinsToInitialize, pinsNotReady);
+    }
+
+    std::cout << "GPIO init: " << pinsToInitialize.size() << " pins initialized on first use in "
+            << std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - startTime).count()
+            << "us" << std::endl;
+}
+
+/**
+ * Executed by warmUpThread. Initializes the input pins, starts the input
+ * monitor if it has been requested, and then initializes the output pins.
+ * Pins which were initialized on first use in the meantime are skipped.
+ */
+void GpioController::warmUpPins()
+{
+    std::vector<uint16_t> inputPinNums;
+    for (const NamedInputPinMap::value_type& inputPin : inputPins)
+    {
+        inputPinNums.push_back(inputPin.second.pinNum);
+    }
+    initializePins(inputPinNums);
+
+    {
+        std::lock_guard<std::mutex> lock{inputMonitorMutex};
+        inputPinsReady = true;
+        if (inputEventCallback)
+        {
+            // Nobody is left to handle a failure here, so it's logged
+            // rather than thrown; outputs are still initialized
+            try
+            {
+                createInputMonitorLocked();
+            }
+            catch (std::exception& err)
+            {
+                std::cerr << "Unable to start GPIO input monitor: " << err.what() << std::endl;
+            }
+        }
+    }
+
+    std::vector<uint16_t> outputPinNums;
+    for (const NamedPin& pin : pins)
+    {
+        outputPinNums.push_back(pin.second);
+    }
+    initializePins(outputPinNums);
+}
+
+/**
+ * Polls, with exponential backoff, until the backend reports every pin in
+ * pinNums as ready, or PIN_ATTRIBUTE_TIMEOUT elapses. All pins are checked
+ * on each round, so the total wait is that of the slowest pin rather than
+ * the sum over all pins. Returns the pins which never became ready. (sysfs
+ * doesn't generate inotify events for its attribute files, so polling is the
+ * only portable option.)
+ */
+std::vector<uint16_t> GpioController::waitForPinAttributes(const std::vector<uint16_t>& pinNums)
+{
+    std::vector<uint16_t> pendingPins = pinNums;
+    auto deadline = std::chrono::steady_clock::now() + PIN_ATTRIBUTE_TIMEOUT;
+    std::chrono::microseconds backoff(250);
+
+    while (true)
+    {
+        auto pinIter = pendingPins.begin();
+        while (pinIter != pendingPins.end())
+        {
+            if (backend->isPinReady(*pinIter))
+            {
+                pinIter = pendingPins.erase(pinIter);
+            }
+            else
+            {
+                ++pinIter;
+            }
+        }
+
+        if (pendingPins.empty() || std::chrono::steady_clock::now() >= deadline)
+        {
+            return pendingPins;
+        }
+
+        std::this_thread::sleep_for(backoff);
+        backoff = std::min(backoff * 2, std::chrono::microseconds(20000));
+    }
+}
+
+/**
+ * Has the GpioController initialize its pins in the background rather than
+ * in its constructor, so the daemon can start serving immediately. Output
+ * pins are driven low as if withGpioInitializedToOutputLow() were also set.
+ */
+GpioController::Builder& GpioController::Builder::withLazyInitialization()
+{
+    lazyInitialization = true;
+    return *this;
+}
+
+GpioController::Builder& GpioController::Builder::withGpioInitializedToOutputLow()
+{
+    initializeAllPinsToOutputLow = true;
+    return *this;
+}
+
+/**
+ * Sets the directory of the sysfs GPIO interface used by the default
+ * backend, in place of SysfsGpioBackend::DEFAULT_SYSFS_ROOT. Ignored if
+ * withBackend() is used.
+ */
+GpioController::Builder& GpioController::Builder::withSysfsRoot(const std::string& sysfsRoot)
+{
+    this->sysfsRoot = sysfsRoot;
+    return *this;
+}
+
+/**
+ * Specifies the backend through which pins are accessed, in place of the
+ * default CachedFdGpioBackend
+ */
+GpioController::Builder& GpioController::Builder::withBackend(const GpioBackendSharedPtr& backend)
+{
+    this->backend = backend;
+    return *this;
+}
+
+/**
+ * Has the GpioController record every output pin's state in the file at
+ * stateFilePath, and restore the states saved there at startup
+ */
+GpioController::Builder& GpioController::Builder::withStateFile(const std::string& stateFilePath)
+{
+    this->stateFilePath = stateFilePath;
+    return *this;
+}
+
+/**
+ * Limits OUTPUT_STATE to physically writing each pin at most once per
+ * minWriteInterval; see setPinOutputState(). Zero, the default, disables
+ * limiting. An interval above MAX_TRANSITION_DELAY results in a
+ * std::invalid_argument being thrown.
+ */
+GpioController::Builder& GpioController::Builder::withMinWriteInterval(
+        std::chrono::milliseconds minWriteInterval)
+{
+    if (minWriteInterval.count() < 0 || minWriteInterval > MAX_TRANSITION_DELAY)
+    {
+        throw std::invalid_argument("Minimum GPIO write interval must be between 0 and " +
+                std::to_string(MAX_TRANSITION_DELAY.count()) + "ms");
+    }
+
+    this->minWriteInterval = minWriteInterval;
+    return *this;
+}
+
+/**
+ * Specifies the TimerWheel on which PULSE and SET_AT transitions are
+ * scheduled
+ */
+GpioController::Builder& GpioController::Builder::withTimerWheel(const TimerWheelSharedPtr& timerWheel)
+{
+    this->timerWheel = timerWheel;
     return *this;
 }
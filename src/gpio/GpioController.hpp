@@ -10,11 +10,26 @@
 
 // System Includes
 #include <unordered_map>
+#include <atomic>
 #include <string>
+#include <chrono>
 #include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 
 // Project Includes
+#include "GpioBackend.hpp"
+#include "GpioInputMonitor.hpp"
+#include "GpioPatternPlayer.hpp"
+#include "GpioStateFile.hpp"
+#include "MetricsRegistry.hpp"
+#include "SoftPwmEngine.hpp"
+#include "TimerWheel.hpp"
 
 
 // Foward declaration
@@ -24,55 +39,271 @@ enum class OutputPinState;
 // Typedefs
 using NamedPinMap = std::unordered_map<std::string, const uint16_t>;
 using NamedPin = std::pair<const std::string, const uint16_t>;
+using GpioControllerSharedPtr = std::shared_ptr<GpioController>;
+using NamedPinGroupMap = std::unordered_map<std::string, std::vector<std::string>>;
 
 class GpioController
 {
+    // Benchmarks convertPinStateCommandToPair(); see bench/HotPathBench.cpp
+    friend class HotPathBench;
+
 public:
     enum class OutputPinState
     {
         LOW = 0, HIGH = 1
     };
 
+    // Which transitions of an input pin generate an event; maps directly
+    // onto the values accepted by the sysfs "edge" attribute
+    enum class InputEdge
+    {
+        NONE, RISING, FALLING, BOTH
+    };
+
+    struct InputPin
+    {
+        uint16_t pinNum;
+        InputEdge edge;
+    };
+    using NamedInputPinMap = std::unordered_map<std::string, InputPin>;
+
+    // Output pin names and states
+    using NamedOutputStates = std::vector<std::pair<std::string, OutputPinState>>;
+    // The pins whose known state changed, and the names of those whose
+    // state is no longer known
+    using OutputChangeCallback = std::function<void(const NamedOutputStates&,
+            const std::vector<std::string>&)>;
+
     // Used for constructing a GpioController instance
     class Builder
     {
     public:
         Builder() {};
         Builder& withNamedPin(const std::string& name, const uint16_t pinNum);
+        Builder& withInputPin(const std::string& name, const uint16_t pinNum,
+                InputEdge edge);
+        Builder& withPinGroup(const std::string& name,
+                const std::vector<std::string>& pinNames);
         Builder& withGpioInitializedToOutputLow();
-        GpioController build();
+        Builder& withLazyInitialization();
+        Builder& withSysfsRoot(const std::string& sysfsRoot);
+        Builder& withBackend(const GpioBackendSharedPtr& backend);
+        Builder& withStateFile(const std::string& stateFilePath);
+        Builder& withMinWriteInterval(std::chrono::milliseconds minWriteInterval);
+        Builder& withTimerWheel(const TimerWheelSharedPtr& timerWheel);
+        GpioControllerSharedPtr build();
     private:
+        bool isPinNameUsed(const std::string& name) const;
+
         NamedPinMap pins;
+        NamedInputPinMap inputPins;
+        NamedPinGroupMap pinGroups;
+        TimerWheelSharedPtr timerWheel;
+        GpioBackendSharedPtr backend;
+        std::string sysfsRoot;
+        std::string stateFilePath;
+        std::chrono::milliseconds minWriteInterval{0};
         bool initializeAllPinsToOutputLow = false;
+        bool lazyInitialization = false;
     };
 
     void getPinMapping(const std::string& UNUSED, std::string* updatableMessage);
     void setPinOutputState(const std::string& pinInfo, std::string* updatableMessage);
     void setAllToOutputLow(const std::string& UNUSED_IN, std::string* updatableMessage);
+    void getInputState(const std::string& pinName, std::string* updatableMessage);
+    void getGpioStatsHandler(const std::string& UNUSED, std::string* updatableMessage);
+
+    // Timed transitions, executed by the timer wheel
+    void pulsePinHandler(const std::string& pulseInfo, std::string* updatableMessage);
+    void setPinStateAtHandler(const std::string& delayedPinInfo, std::string* updatableMessage);
+    void cancelPendingTransitionsHandler(const std::string& pinName, std::string* updatableMessage);
+
+    // Pin groups
+    void busWriteHandler(const std::string& busInfo, std::string* updatableMessage);
+
+    // Pattern playback
+    void uploadPatternHandler(const std::string& patternInfo, std::string* updatableMessage);
+    void playPatternHandler(const std::string& playInfo, std::string* updatableMessage);
+    void stopPatternHandler(const std::string& UNUSED, std::string* updatableMessage);
+
+    // Software PWM
+    void setPwmHandler(const std::string& pwmInfo, std::string* updatableMessage);
+    void getPwmStatsHandler(const std::string& UNUSED, std::string* updatableMessage);
+
+    // Starts watching all input pins whose edge isn't NONE; callback is
+    // executed on the monitor thread for each detected edge
+    void startInputMonitor(const GpioInputMonitor::InputEventCallback& callback);
+
+    // callback is executed with the pins whose known state each write
+    // changed, and those whose state it left unknown (a failed write, or
+    // PWM taking the pin over), while other writes are held off, so that changes are
+    // reported in the order they were made. It mustn't block, as every GPIO
+    // write waits on it.
+    void setOutputChangeCallback(const OutputChangeCallback& callback);
+
+    // The output pins whose state is known
+    NamedOutputStates getOutputStates();
+
+    static InputEdge convertStringToInputEdge(const std::string& edgeString);
+    static std::string convertInputEdgeToString(InputEdge edge);
+
+    ~GpioController();
+
+    GpioController(const GpioController&) = delete;
+    GpioController& operator=(const GpioController&) = delete;
 
 private:
     using PinState = std::pair<std::string, GpioController::OutputPinState>;
-    GpioController(const NamedPinMap& pins, bool initializeAllPinsToOutputLow=false);
+    using PinNumState = std::pair<uint16_t, GpioController::OutputPinState>;
+
+    // A group's pin numbers, in bit order; element 0 is driven by bit 0
+    using PinGroupMap = std::unordered_map<std::string, std::vector<uint16_t>>;
+
+    GpioController(const NamedPinMap& pins, const NamedInputPinMap& inputPins,
+            const PinGroupMap& pinGroups, const GpioBackendSharedPtr& backend,
+            const TimerWheelSharedPtr& timerWheel, const std::string& stateFilePath,
+            std::chrono::milliseconds minWriteInterval,
+            bool initializeAllPinsToOutputLow=false, bool lazyInitialization=false);
+
+    uint16_t getOutputPinNum(const std::string& pinName) const;
 
-    // File IO
-    static void writeToFile(const std::string& filePath, const std::string& value);
-    static void writeUInt8ToFile(const std::string& filePath, uint8_t value);
-    static void writePinState(const std::string& filePath, OutputPinState pinState);
+    // Timed transitions
+    void scheduleTransition(uint16_t pinNum, std::chrono::milliseconds delay,
+            OutputPinState pinState);
+    size_t cancelPendingTransitions(uint16_t pinNum);
+    bool cancelDeferredWrite(uint16_t pinNum);
+    void scheduleDeferredWrite(uint16_t pinNum, std::chrono::milliseconds delay);
+    // Software PWM
+    void stopPwm(uint16_t pinNum);
+    std::string getPinName(uint16_t pinNum) const;
+
+    static std::chrono::milliseconds convertDelayToMilliseconds(const std::string& delay,
+            const std::string& fullParam);
+
+    // Output pin writes, through the backend
+    void writeOutputPin(uint16_t pinNum, OutputPinState pinState);
+    void writeOutputPins(const std::vector<PinNumState>& pinStates);
+    void writeOutputPinLocked(uint16_t pinNum, OutputPinState pinState);
+    void forgetOutputState(uint16_t pinNum);
+    void recordOutputStateLocked(uint16_t pinNum, OutputPinState pinState);
+    void forgetOutputStateLocked(uint16_t pinNum);
+    void publishOutputChangesLocked();
+    void writePrecomputedPinValues(const PinValueList& pinValues,
+            const GpioPatternPlayer::StepCheck& stepCheck);
 
     PinState convertPinStateCommandToPair(const std::string& pinInfo);
 
-    static std::string insertUInt8IntoString(const char * formatString, uint8_t num);
+    // Startup initialization
+    void initializePins(const std::vector<uint16_t>& pinNums);
+    void configurePinsLocked(const std::vector<uint16_t>& pinNums,
+            const std::vector<uint16_t>& pinsNotReady);
+    void ensurePinInitialized(uint16_t pinNum);
+    void ensurePinsInitialized(const std::vector<uint16_t>& pinNums);
+    void warmUpPins();
+    void createInputMonitorLocked();
+    std::vector<uint16_t> waitForPinAttributes(const std::vector<uint16_t>& pinNums);
+
+    static const std::string DIRECTION_ATTRIBUTE;
+    static const std::string EDGE_ATTRIBUTE;
+    static const std::string INPUT_DIRECTION;
+    static const std::string OUTPUT_LOW_DIRECTION;
+    static const std::string OUTPUT_HIGH_DIRECTION;
 
-    void exportAllPinsAndSetToOutputLow();
+    // How long initializePins() waits for udev to create the attribute
+    // files of newly exported pins
+    static const std::chrono::milliseconds PIN_ATTRIBUTE_TIMEOUT;
 
-    static const char * const EXPORT_PIN_PATH;
-    static const char * const  UNEXPORT_PIN_PATH;
-    static const char * const  PIN_DIRECTION_PATH_FORMAT;
-    static const char * const PIN_VALUE_PATH_FORMAT;
+    // The longest delay accepted by PULSE, SET_AT and pattern steps
+    static const std::chrono::milliseconds MAX_TRANSITION_DELAY;
 
-    static const std::string OUTPUT_DIRECTION;
+    static const size_t MAX_PATTERN_STEPS;
+
+    static const MetricsRegistry::Counter GPIO_WRITES;
+    static const MetricsRegistry::Counter GPIO_WRITE_FAILURES;
 
     const NamedPinMap pins;
+    const NamedInputPinMap inputPins;
+    const PinGroupMap pinGroups;
+
+    // Through which every pin is exported, configured, read and written
+    const GpioBackendSharedPtr backend;
+
+    // The last state written to each output pin; pins whose state isn't
+    // known (never written, or driven by the PWM engine) have no entry
+    std::unordered_map<uint16_t, OutputPinState> outputStates;
+
+    // Mirrors outputStates across restarts, if a state file was requested.
+    // savedOutputValues holds what it contained at startup.
+    std::unique_ptr<GpioStateFile> stateFile;
+    std::unordered_map<uint16_t, uint8_t> savedOutputValues;
+
+    // Pins whose known state has changed since the output change callback
+    // was last executed; guarded by pinWriteMutex, as is the callback
+    std::vector<uint16_t> changedOutputPins;
+    OutputChangeCallback outputChangeCallback;
+
+    // Guards outputStates, stateFile and backend writes, and makes each bulk
+    // write appear as a single operation to all other writers in this process
+    std::mutex pinWriteMutex;
+
+    // Pins which are still to be exported and configured. Only non-empty
+    // during startup, or while lazy initialization's warm-up is running.
+    // Guarded by pinWriteMutex.
+    std::unordered_set<uint16_t> uninitializedPins;
+
+    // Set once uninitializedPins is empty, so that writers can skip looking
+    // in it without taking pinWriteMutex
+    std::atomic<bool> allPinsInitialized{false};
+
+    // With lazy initialization, exports and configures the pins which
+    // haven't yet been used, in the background
+    std::thread warmUpThread;
+
+    // The input monitor can't be created until the input pins are
+    // configured; with lazy initialization that's after startInputMonitor()
+    // may have been called, so its callback is kept until then
+    std::unique_ptr<GpioInputMonitor> inputMonitor;
+    GpioInputMonitor::InputEventCallback inputEventCallback;
+    bool inputPinsReady = false;
+    std::mutex inputMonitorMutex;
+
+    // Executes PULSE and SET_AT transitions
+    const TimerWheelSharedPtr timerWheel;
+
+    // The timers of every not-yet-executed transition, per pin number. A
+    // transition whose id is no longer listed here won't write its pin.
+    std::unordered_map<uint16_t, std::vector<TimerWheel::TimerId>> pendingTransitions;
+    std::mutex pendingTransitionsMutex;
+
+    // OUTPUT_STATE rate limiting; guarded by pendingTransitionsMutex. A pin
+    // has at most one deferred write, whose state is replaced by each
+    // request that arrives before it's written.
+    struct LimitedPin
+    {
+        std::chrono::steady_clock::time_point lastWriteTime;
+        TimerWheel::TimerId deferredWriteTimer = TimerWheel::INVALID_TIMER_ID;
+        OutputPinState deferredState = OutputPinState::LOW;
+    };
+    struct WriteLimitStats
+    {
+        uint64_t requests = 0;
+        uint64_t immediateWrites = 0;
+        uint64_t deferredWrites = 0;
+        uint64_t writesSaved = 0;
+    };
+    const std::chrono::milliseconds minWriteInterval;
+    std::unordered_map<uint16_t, LimitedPin> limitedPins;
+    WriteLimitStats writeLimitStats;
+
+    // Uploaded patterns by name, and the player which executes them
+    std::unordered_map<std::string, GpioPatternPlayer::CompiledPatternSharedPtr> patterns;
+    std::mutex patternsMutex;
+    std::unique_ptr<GpioPatternPlayer> patternPlayer;
+
+    // Created on the first PWM command, so the engine's thread only exists
+    // if PWM is used
+    std::unique_ptr<SoftPwmEngine> pwmEngine;
+    std::mutex pwmEngineMutex;
 };
 
 
@@ -0,0 +1,210 @@
+/*
+ * GpioInputMonitor.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+// System Includes
+#include <cerrno>
+#include <cstdint>
+#include <fcntl.h>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <system_error>
+#include <unistd.h>
+#include <vector>
+
+// Project Includes
+#include "GpioInputMonitor.hpp"
+
+// Static initialization
+const int GpioInputMonitor::MAX_EVENTS_PER_WAKEUP = 16;
+
+/**
+ * Opens the value file of every pin in pinsToMonitor and registers it with a
+ * new epoll instance. The pins are expected to already be exported, set to
+ * the "in" direction, and have their "edge" attribute configured.
+ * std::system_error is thrown if any of the fds can't be opened or registered.
+ */
+GpioInputMonitor::GpioInputMonitor(const std::vector<MonitoredPin>& pinsToMonitor,
+        const InputEventCallback& callback) :
+        pins(pinsToMonitor), callback(callback), epollFd(-1), stopEventFd(-1)
+{
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0)
+    {
+        throw std::system_error(errno, std::system_category(),
+                "Error creating epoll instance for GPIO input monitoring");
+    }
+
+    stopEventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (stopEventFd < 0)
+    {
+        int savedErrno = errno;
+        close(epollFd);
+        throw std::system_error(savedErrno, std::system_category(),
+                "Error creating stop eventfd for GPIO input monitoring");
+    }
+
+    // The stop fd is tagged with an index one past the last pin
+    epoll_event stopEvent = {};
+    stopEvent.events = EPOLLIN;
+    stopEvent.data.u32 = static_cast<uint32_t>(pins.size());
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, stopEventFd, &stopEvent) != 0)
+    {
+        int savedErrno = errno;
+        stop();
+        throw std::system_error(savedErrno, std::system_category(),
+                "Error registering the stop eventfd for GPIO input monitoring with epoll");
+    }
+
+    for (size_t idx = 0; idx < pins.size(); ++idx)
+    {
+        int fd = open(pins[idx].valuePath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            int savedErrno = errno;
+            stop();
+            throw std::system_error(savedErrno, std::system_category(),
+                    "Error opening " + pins[idx].valuePath + " for monitoring");
+        }
+        valueFds.push_back(fd);
+
+        // sysfs reports a pending event right after open(); reading the value
+        // once clears it so the first wakeup corresponds to a real edge
+        (void) readValueFromFd(fd);
+
+        epoll_event pinEvent = {};
+        pinEvent.events = EPOLLPRI | EPOLLERR;
+        pinEvent.data.u32 = static_cast<uint32_t>(idx);
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &pinEvent) != 0)
+        {
+            int savedErrno = errno;
+            stop();
+            throw std::system_error(savedErrno, std::system_category(),
+                    "Error registering " + pins[idx].valuePath + " with epoll");
+        }
+    }
+}
+
+GpioInputMonitor::~GpioInputMonitor()
+{
+    stop();
+}
+
+/**
+ * Starts the monitor thread. Has no effect if it's already running.
+ */
+void GpioInputMonitor::start()
+{
+    if (monitorThread.joinable())
+    {
+        return;
+    }
+    monitorThread = std::thread(&GpioInputMonitor::monitorLoop, this);
+}
+
+/**
+ * Wakes the monitor thread, waits for it to exit, and closes all fds owned by
+ * this instance.
+ */
+void GpioInputMonitor::stop()
+{
+    if (monitorThread.joinable())
+    {
+        uint64_t one = 1;
+        (void) write(stopEventFd, &one, sizeof(one));
+        monitorThread.join();
+    }
+
+    for (int fd : valueFds)
+    {
+        close(fd);
+    }
+    valueFds.clear();
+
+    if (stopEventFd >= 0)
+    {
+        close(stopEventFd);
+        stopEventFd = -1;
+    }
+    if (epollFd >= 0)
+    {
+        close(epollFd);
+        epollFd = -1;
+    }
+}
+
+/**
+ * Executed by monitorThread. Blocks in epoll_wait() until either an edge
+ * occurs on one of the monitored pins or stop() is called.
+ */
+void GpioInputMonitor::monitorLoop()
+{
+    std::cout << "GPIO input monitor started for " << pins.size() << " pin(s)" << std::endl;
+
+    epoll_event events[MAX_EVENTS_PER_WAKEUP];
+
+    while (true)
+    {
+        int numEvents = epoll_wait(epollFd, events, MAX_EVENTS_PER_WAKEUP, -1);
+        if (numEvents < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            std::cerr << "GPIO input monitor: epoll_wait() failed with errno "
+                    << errno << "; exiting" << std::endl;
+            return;
+        }
+
+        // Take the timestamp before any reads so it's as close to the edge
+        // as possible
+        timespec timestamp;
+        clock_gettime(CLOCK_REALTIME, &timestamp);
+
+        for (int eventIdx = 0; eventIdx < numEvents; ++eventIdx)
+        {
+            uint32_t pinIdx = events[eventIdx].data.u32;
+            if (pinIdx == pins.size())
+            {
+                return;
+            }
+
+            GpioInputEvent inputEvent;
+            inputEvent.pinName = pins[pinIdx].pinName;
+            inputEvent.pinNum = pins[pinIdx].pinNum;
+            inputEvent.value = readValueFromFd(valueFds[pinIdx]);
+            inputEvent.timestamp = timestamp;
+
+            try
+            {
+                callback(inputEvent);
+            }
+            catch (const std::exception& err)
+            {
+                std::cerr << "GPIO input monitor: callback for pin "
+                        << inputEvent.pinName << " threw: " << err.what() << std::endl;
+            }
+        }
+    }
+}
+
+/**
+ * Re-reads a sysfs value file from its start and returns 0 or 1. Reading is
+ * also what acknowledges a pending POLLPRI event.
+ */
+uint8_t GpioInputMonitor::readValueFromFd(int fd)
+{
+    char valueChar = '0';
+    if (pread(fd, &valueChar, 1, 0) != 1)
+    {
+        return 0;
+    }
+    return valueChar == '1' ? 1 : 0;
+}
@@ -0,0 +1,83 @@
+/*
+ * GpioInputMonitor.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+#ifndef GPIO_GPIOINPUTMONITOR_HPP_
+#define GPIO_GPIOINPUTMONITOR_HPP_
+
+// System Includes
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Project Includes
+// <none>
+
+/**
+ * A single edge detected on a monitored input pin. timestamp is taken from
+ * CLOCK_REALTIME as soon as epoll_wait() returns, before the value is read.
+ */
+struct GpioInputEvent
+{
+    std::string pinName;
+    uint16_t pinNum;
+    uint8_t value;
+    timespec timestamp;
+};
+
+/**
+ * Waits on the sysfs value files of all monitored input pins with a single
+ * epoll instance, on a single thread. The kernel signals an edge (as
+ * configured through the pin's "edge" attribute) with POLLPRI/POLLERR; each
+ * such wakeup results in the pin's value being re-read and handed to the
+ * InputEventCallback.
+ */
+class GpioInputMonitor
+{
+public:
+    using InputEventCallback = std::function<void(const GpioInputEvent&)>;
+
+    struct MonitoredPin
+    {
+        std::string pinName;
+        uint16_t pinNum;
+        std::string valuePath;
+    };
+
+    GpioInputMonitor(const std::vector<MonitoredPin>& pinsToMonitor,
+            const InputEventCallback& callback);
+    ~GpioInputMonitor();
+
+    GpioInputMonitor(const GpioInputMonitor&) = delete;
+    GpioInputMonitor& operator=(const GpioInputMonitor&) = delete;
+
+    void start();
+    void stop();
+
+private:
+    void monitorLoop();
+    static uint8_t readValueFromFd(int fd);
+
+    const std::vector<MonitoredPin> pins;
+    const InputEventCallback callback;
+
+    // One fd per entry in pins, indices match
+    std::vector<int> valueFds;
+
+    int epollFd;
+
+    // Written to by stop() to wake monitorLoop() out of epoll_wait()
+    int stopEventFd;
+
+    std::thread monitorThread;
+
+    static const int MAX_EVENTS_PER_WAKEUP;
+};
+
+#endif /* GPIO_GPIOINPUTMONITOR_HPP_ */
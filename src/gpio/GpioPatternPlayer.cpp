@@ -0,0 +1,212 @@
+/*
+ * GpioPatternPlayer.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+// System Includes
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Project Includes
+#include "GpioPatternPlayer.hpp"
+
+/**
+ * Starts the player thread, which idles until play() is called
+ */
+GpioPatternPlayer::GpioPatternPlayer(const Writer& writer) :
+        writer(writer), looping(false), playGeneration(0), running(true)
+{
+    playerThread = std::thread(&GpioPatternPlayer::playerLoop, this);
+}
+
+GpioPatternPlayer::~GpioPatternPlayer()
+{
+    {
+        std::lock_guard<std::mutex> lock{playerMutex};
+        running = false;
+    }
+    playerCondition.notify_all();
+    playerThread.join();
+}
+
+/**
+ * Starts playing pattern from its first step, replacing whatever was
+ * playing. If loop is true, the pattern repeats until stop() is called.
+ */
+void GpioPatternPlayer::play(const std::string& name, const CompiledPatternSharedPtr& pattern,
+        bool loop)
+{
+    {
+        std::lock_guard<std::mutex> lock{playerMutex};
+        currentPattern = pattern;
+        currentName = name;
+        looping = loop;
+        ++playGeneration;
+    }
+    playerCondition.notify_all();
+}
+
+/**
+ * Stops the playing pattern, leaving the pins in the state of the last step
+ * written. Returns true if a pattern was playing.
+ */
+bool GpioPatternPlayer::stop()
+{
+    bool wasPlaying;
+    {
+        std::lock_guard<std::mutex> lock{playerMutex};
+        wasPlaying = currentPattern != nullptr;
+        currentPattern = nullptr;
+        currentName.clear();
+        ++playGeneration;
+    }
+    playerCondition.notify_all();
+    return wasPlaying;
+}
+
+/**
+ * Returns the name of the playing pattern, or an empty string if none is
+ */
+std::string GpioPatternPlayer::getPlayingName()
+{
+    std::lock_guard<std::mutex> lock{playerMutex};
+    return currentName;
+}
+
+/**
+ * Compiles steps into a CompiledPattern for a group whose bit i drives
+ * groupPins[i]. The first step writes every pin of the group, each later
+ * step only the pins which change, and loopWrites the pins which change
+ * going from the last step back to the first. steps must not be empty.
+ */
+GpioPatternPlayer::CompiledPatternSharedPtr GpioPatternPlayer::compile(
+        const std::vector<uint16_t>& groupPins, const std::vector<PatternStep>& steps)
+{
+    if (steps.empty())
+    {
+        throw std::invalid_argument("A pattern must have at least one step");
+    }
+
+    std::shared_ptr<CompiledPattern> pattern = std::make_shared<CompiledPattern>();
+
+    uint32_t previousBitmap = 0;
+    for (size_t stepIdx = 0; stepIdx < steps.size(); ++stepIdx)
+    {
+        uint32_t bitmap = steps[stepIdx].first;
+
+        CompiledStep compiledStep;
+        compiledStep.delay = steps[stepIdx].second;
+        for (size_t bitIdx = 0; bitIdx < groupPins.size(); ++bitIdx)
+        {
+            uint8_t value = (bitmap >> bitIdx) & 1;
+            if (stepIdx == 0 || value != ((previousBitmap >> bitIdx) & 1))
+            {
+                compiledStep.writes.push_back(std::make_pair(groupPins[bitIdx], value));
+            }
+        }
+        pattern->steps.push_back(compiledStep);
+        previousBitmap = bitmap;
+    }
+
+    uint32_t firstBitmap = steps.front().first;
+    for (size_t bitIdx = 0; bitIdx < groupPins.size(); ++bitIdx)
+    {
+        uint8_t value = (firstBitmap >> bitIdx) & 1;
+        if (value != ((previousBitmap >> bitIdx) & 1))
+        {
+            pattern->loopWrites.push_back(std::make_pair(groupPins[bitIdx], value));
+        }
+    }
+
+    return pattern;
+}
+
+/**
+ * Executed by playerThread. Waits for a pattern, then writes its steps at
+ * their deadlines until it finishes, is replaced, or is stopped. If a step's
+ * write overran the next deadline, that deadline is moved to now, so a late
+ * step delays the rest of the pattern rather than being followed by a burst
+ * of catch-up steps.
+ */
+void GpioPatternPlayer::playerLoop()
+{
+    std::unique_lock<std::mutex> lock{playerMutex};
+
+    while (running)
+    {
+        if (!currentPattern)
+        {
+            playerCondition.wait(lock);
+            continue;
+        }
+
+        const CompiledPatternSharedPtr pattern = currentPattern;
+        const uint64_t generation = playGeneration;
+        const bool loop = looping;
+
+        auto replacedOrStopped = [this, generation]()
+        {
+            return !running || playGeneration != generation;
+        };
+
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now();
+        size_t stepIdx = 0;
+        bool firstIteration = true;
+
+        auto stepCheck = [this, generation]()
+        {
+            std::lock_guard<std::mutex> checkLock{playerMutex};
+            return running && playGeneration == generation;
+        };
+
+        while (!replacedOrStopped())
+        {
+            const CompiledStep& step = pattern->steps[stepIdx];
+
+            lock.unlock();
+            try
+            {
+                writer((stepIdx == 0 && !firstIteration) ? pattern->loopWrites : step.writes,
+                        stepCheck);
+            }
+            catch (const std::exception& err)
+            {
+                std::cerr << "Pattern player: write failed: " << err.what() << std::endl;
+            }
+            lock.lock();
+
+            if (replacedOrStopped())
+            {
+                break;
+            }
+
+            if (++stepIdx == pattern->steps.size())
+            {
+                if (!loop)
+                {
+                    currentPattern = nullptr;
+                    currentName.clear();
+                    break;
+                }
+                stepIdx = 0;
+                firstIteration = false;
+            }
+
+            deadline += step.delay;
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            if (deadline < now)
+            {
+                deadline = now;
+            }
+            playerCondition.wait_until(lock, deadline, replacedOrStopped);
+        }
+    }
+}
@@ -0,0 +1,108 @@
+/*
+ * GpioPatternPlayer.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+#ifndef GPIO_GPIOPATTERNPLAYER_HPP_
+#define GPIO_GPIOPATTERNPLAYER_HPP_
+
+// System Includes
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Project Includes
+// <none>
+
+// A list of (pin number, value 0/1) pairs to be written together
+using PinValueList = std::vector<std::pair<uint16_t, uint8_t>>;
+
+/**
+ * Replays patterns: sequences of pin-group bitmaps, each held for a fixed
+ * delay. Patterns are compiled once, when uploaded, into the exact list of
+ * pin writes each step needs (only the pins which differ from the previous
+ * step), so playback does no parsing or diffing. Steps are timed against
+ * absolute deadlines on the steady clock, so delays don't accumulate error.
+ *
+ * One pattern plays at a time, on the player's own thread. Writes are
+ * performed through the Writer supplied at construction, without the
+ * player's lock held, so play() and stop() never wait on a step's write.
+ */
+class GpioPatternPlayer
+{
+public:
+    // Returns whether the step being written still belongs to the playing
+    // pattern, i.e. neither play() nor stop() has been called since
+    using StepCheck = std::function<bool()>;
+
+    // Writes a step's pins. The Writer calls the StepCheck once it holds
+    // whatever serializes it against other writers, and skips the write if
+    // it returns false, so nothing is written once stop() has returned.
+    using Writer = std::function<void(const PinValueList&, const StepCheck&)>;
+
+    struct CompiledStep
+    {
+        PinValueList writes;
+        std::chrono::milliseconds delay;
+    };
+
+    struct CompiledPattern
+    {
+        std::vector<CompiledStep> steps;
+
+        // Replaces steps[0].writes on every loop iteration after the first,
+        // since the pins are then coming from the last step's state
+        PinValueList loopWrites;
+    };
+    using CompiledPatternSharedPtr = std::shared_ptr<const CompiledPattern>;
+
+    // A bitmap over a group's pins (bit i drives groupPins[i]) and how long
+    // to hold it
+    using PatternStep = std::pair<uint32_t, std::chrono::milliseconds>;
+
+    explicit GpioPatternPlayer(const Writer& writer);
+    ~GpioPatternPlayer();
+
+    GpioPatternPlayer(const GpioPatternPlayer&) = delete;
+    GpioPatternPlayer& operator=(const GpioPatternPlayer&) = delete;
+
+    void play(const std::string& name, const CompiledPatternSharedPtr& pattern, bool loop);
+    bool stop();
+    std::string getPlayingName();
+
+    static CompiledPatternSharedPtr compile(const std::vector<uint16_t>& groupPins,
+            const std::vector<PatternStep>& steps);
+
+private:
+    void playerLoop();
+
+    const Writer writer;
+
+    CompiledPatternSharedPtr currentPattern;
+    std::string currentName;
+    bool looping;
+
+    // Bumped by every play() and stop(), so the player thread can tell that
+    // the pattern it's playing has been replaced or stopped
+    uint64_t playGeneration;
+
+    bool running;
+
+    // Guards everything above. Not held by the player thread while it
+    // writes a step; see Writer.
+    std::mutex playerMutex;
+    std::condition_variable playerCondition;
+
+    std::thread playerThread;
+};
+
+#endif /* GPIO_GPIOPATTERNPLAYER_HPP_ */
@@ -0,0 +1,198 @@
+/*
+ * GpioStateFile.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+// System Includes
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Project Includes
+#include "GpioStateFile.hpp"
+
+// Static initialization
+const uint32_t GpioStateFile::MAGIC = 0x4753434e; // "NCSG"
+const uint32_t GpioStateFile::VERSION = 1;
+const size_t GpioStateFile::MAX_SLOTS = 1024;
+const size_t GpioStateFile::FILE_SIZE = sizeof(Header) + MAX_SLOTS * sizeof(Slot);
+
+/**
+ * Only a new or empty file is sized; anything else must already be a
+ * snapshot, so that a mistyped path can't truncate and overwrite some
+ * other file
+ */
+GpioStateFile::GpioStateFile(const std::string& path):
+        path(path)
+{
+    fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Unable to open GPIO state file: " + path +
+                "; " + std::strerror(errno));
+    }
+
+    try
+    {
+        checkExistingContents();
+    }
+    catch (const std::runtime_error&)
+    {
+        close(fd);
+        throw;
+    }
+
+    mapping = mmap(nullptr, FILE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        int mmapErrno = errno;
+        close(fd);
+        throw std::runtime_error("Unable to map GPIO state file: " + path +
+                "; " + std::strerror(mmapErrno));
+    }
+
+    header = static_cast<Header*>(mapping);
+    slots = reinterpret_cast<Slot*>(header + 1);
+
+    loadSavedValues();
+}
+
+/**
+ * Sizes an empty file, or throws a std::runtime_error unless the file is
+ * exactly a snapshot's size and starts with a snapshot's magic number, or
+ * with zeroes as one which was created but never written does
+ */
+void GpioStateFile::checkExistingContents()
+{
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0)
+    {
+        throw std::runtime_error("Unable to stat GPIO state file: " + path +
+                "; " + std::strerror(errno));
+    }
+
+    if (fileStat.st_size == 0)
+    {
+        if (ftruncate(fd, FILE_SIZE) != 0)
+        {
+            throw std::runtime_error("Unable to size GPIO state file: " + path +
+                    "; " + std::strerror(errno));
+        }
+        return;
+    }
+
+    Header existingHeader;
+    if (!S_ISREG(fileStat.st_mode) || static_cast<size_t>(fileStat.st_size) != FILE_SIZE ||
+        pread(fd, &existingHeader, sizeof(existingHeader), 0) !=
+                static_cast<ssize_t>(sizeof(existingHeader)) ||
+        (existingHeader.magic != MAGIC && existingHeader.magic != 0))
+    {
+        throw std::runtime_error("Refusing to use " + path + " as the GPIO state file;"
+                " it already exists and isn't a GPIO state snapshot");
+    }
+}
+
+/**
+ * Flushes the snapshot to disk and unmaps it
+ */
+GpioStateFile::~GpioStateFile()
+{
+    msync(mapping, FILE_SIZE, MS_SYNC);
+    munmap(mapping, FILE_SIZE);
+    close(fd);
+}
+
+const std::unordered_map<uint16_t, uint8_t>& GpioStateFile::getSavedValues() const
+{
+    return savedValues;
+}
+
+/**
+ * A new file (all zeroes), or one written by an incompatible version, has
+ * no saved values. Files which aren't snapshots at all never get this far.
+ */
+void GpioStateFile::loadSavedValues()
+{
+    if (header->magic != MAGIC || header->version != VERSION ||
+        header->slotCount > MAX_SLOTS)
+    {
+        if (header->magic != 0)
+        {
+            std::cerr << "GPIO state file: " << path << " isn't a valid snapshot;"
+                    " ignoring its contents" << std::endl;
+        }
+        return;
+    }
+
+    for (size_t slotIdx = 0; slotIdx < header->slotCount; ++slotIdx)
+    {
+        if (slots[slotIdx].value == LOW || slots[slotIdx].value == HIGH)
+        {
+            savedValues[slots[slotIdx].pinNum] = slots[slotIdx].value == HIGH ? 1 : 0;
+        }
+    }
+}
+
+/**
+ * The slot count is zeroed while the table is rewritten, so a crash part way
+ * through leaves an empty snapshot rather than a corrupt one. Pins beyond
+ * MAX_SLOTS aren't recorded.
+ */
+void GpioStateFile::resetPins(const std::vector<uint16_t>& pinNums)
+{
+    header->slotCount = 0;
+    slotIndexes.clear();
+
+    size_t slotIdx = 0;
+    for (uint16_t pinNum : pinNums)
+    {
+        if (slotIdx == MAX_SLOTS)
+        {
+            std::cerr << "GPIO state file: only " << MAX_SLOTS << " pins can be"
+                    " recorded; pin " << pinNum << " and later won't be" << std::endl;
+            break;
+        }
+        if (slotIndexes.count(pinNum) != 0)
+        {
+            continue;
+        }
+
+        auto savedIter = savedValues.find(pinNum);
+        slots[slotIdx].pinNum = pinNum;
+        slots[slotIdx].value = savedIter == savedValues.end() ? UNKNOWN :
+                (savedIter->second ? HIGH : LOW);
+        slots[slotIdx].reserved = 0;
+        slotIndexes[pinNum] = slotIdx++;
+    }
+
+    header->magic = MAGIC;
+    header->version = VERSION;
+    header->reserved = 0;
+    __atomic_store_n(&header->slotCount, static_cast<uint32_t>(slotIdx), __ATOMIC_RELEASE);
+}
+
+void GpioStateFile::setValue(uint16_t pinNum, uint8_t value)
+{
+    setSlotValue(pinNum, value ? HIGH : LOW);
+}
+
+void GpioStateFile::clearValue(uint16_t pinNum)
+{
+    setSlotValue(pinNum, UNKNOWN);
+}
+
+void GpioStateFile::setSlotValue(uint16_t pinNum, SlotValue value)
+{
+    auto slotIter = slotIndexes.find(pinNum);
+    if (slotIter != slotIndexes.end())
+    {
+        slots[slotIter->second].value = value;
+    }
+}
@@ -0,0 +1,98 @@
+/*
+ * GpioStateFile.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+#ifndef GPIO_GPIOSTATEFILE_HPP_
+#define GPIO_GPIOSTATEFILE_HPP_
+
+// System Includes
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Project Includes
+// <none>
+
+/**
+ * A snapshot of the last value written to each output pin, kept in a small
+ * memory-mapped file so it survives daemon restarts. Recording a value is a
+ * single store into the mapping; the kernel writes the page back, so the
+ * snapshot survives the daemon exiting or crashing (but not necessarily a
+ * power loss). The file holds a header followed by a fixed-size table of
+ * (pin number, value) slots, one per output pin of the current
+ * configuration. Not thread safe; GpioController serializes all use with
+ * its pinWriteMutex.
+ */
+class GpioStateFile
+{
+public:
+    // The values a slot can hold
+    enum SlotValue : uint8_t
+    {
+        UNKNOWN = 0, LOW = 1, HIGH = 2
+    };
+
+    // Opens or creates the file at path and maps it. If path holds a valid
+    // snapshot, its values are loaded; see getSavedValues(). Throws a
+    // std::runtime_error if the file can't be created or mapped, or if it's
+    // a non-empty file which isn't a snapshot.
+    explicit GpioStateFile(const std::string& path);
+    ~GpioStateFile();
+
+    // The known pin values found in the file when it was opened
+    const std::unordered_map<uint16_t, uint8_t>& getSavedValues() const;
+
+    // Lays the table out for pinNums, keeping the saved value of each pin
+    // which had one. Pins which aren't listed are dropped.
+    void resetPins(const std::vector<uint16_t>& pinNums);
+
+    // Records pinNum's value (0 or 1), or that it's unknown. Pins not given
+    // to resetPins() are ignored.
+    void setValue(uint16_t pinNum, uint8_t value);
+    void clearValue(uint16_t pinNum);
+
+    GpioStateFile(const GpioStateFile&) = delete;
+    GpioStateFile& operator=(const GpioStateFile&) = delete;
+
+private:
+    struct Header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t slotCount;
+        uint32_t reserved;
+    };
+
+    struct Slot
+    {
+        uint16_t pinNum;
+        uint8_t value;
+        uint8_t reserved;
+    };
+
+    void checkExistingContents();
+    void loadSavedValues();
+    void setSlotValue(uint16_t pinNum, SlotValue value);
+
+    static const uint32_t MAGIC;
+    static const uint32_t VERSION;
+    static const size_t MAX_SLOTS;
+    static const size_t FILE_SIZE;
+
+    const std::string path;
+    int fd = -1;
+    void* mapping = nullptr;
+    Header* header = nullptr;
+    Slot* slots = nullptr;
+
+    // Index into slots of each pin given to resetPins()
+    std::unordered_map<uint16_t, size_t> slotIndexes;
+    std::unordered_map<uint16_t, uint8_t> savedValues;
+};
+
+#endif /* GPIO_GPIOSTATEFILE_HPP_ */
@@ -0,0 +1,122 @@
+/*
+ * InMemoryGpioBackend.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+// System Includes
+#include <iostream>
+
+// Project Includes
+#include "InMemoryGpioBackend.hpp"
+
+void InMemoryGpioBackend::exportPins(const std::vector<uint16_t>& pinNums)
+{
+    std::lock_guard<std::mutex> lock{attributesMutex};
+    for (uint16_t pinNum : pinNums)
+    {
+        // Exporting an exported pin leaves its attributes alone
+        pinAttributes[pinNum];
+    }
+}
+
+bool InMemoryGpioBackend::isPinReady(uint16_t pinNum)
+{
+    std::lock_guard<std::mutex> lock{attributesMutex};
+    return pinAttributes.count(pinNum) != 0;
+}
+
+/**
+ * Accepts the values sysfs does for "direction" (in, out, low, high) and
+ * "edge" (none, rising, falling, both); anything else fails, as does
+ * writing a pin which isn't exported.
+ */
+bool InMemoryGpioBackend::writeAttribute(uint16_t pinNum, const std::string& attribute,
+        const std::string& value)
+{
+    std::lock_guard<std::mutex> lock{attributesMutex};
+    auto pinIter = pinAttributes.find(pinNum);
+    if (pinIter == pinAttributes.end())
+    {
+        std::cerr << "In-memory GPIO: pin " << pinNum << " isn't exported" << std::endl;
+        return false;
+    }
+
+    if (attribute == "direction")
+    {
+        if (value == "in")
+        {
+            pinIter->second.direction = value;
+            return true;
+        }
+        else if (value == "out" || value == "low" || value == "high")
+        {
+            pinIter->second.direction = "out";
+            if (value != "out")
+            {
+                pinIter->second.value = value == "high" ? 1 : 0;
+            }
+            return true;
+        }
+    }
+    else if (attribute == "edge" &&
+            (value == "none" || value == "rising" || value == "falling" || value == "both"))
+    {
+        pinIter->second.edge = value;
+        return true;
+    }
+
+    std::cerr << "In-memory GPIO: can't write: " << value << " to: " << attribute
+            << " of pin " << pinNum << std::endl;
+    return false;
+}
+
+bool InMemoryGpioBackend::writeValue(uint16_t pinNum, uint8_t value)
+{
+    std::lock_guard<std::mutex> lock{attributesMutex};
+    auto pinIter = pinAttributes.find(pinNum);
+    if (pinIter == pinAttributes.end() || pinIter->second.direction != "out")
+    {
+        std::cerr << "In-memory GPIO: pin " << pinNum << " isn't an exported output" << std::endl;
+        return false;
+    }
+
+    pinIter->second.value = value ? 1 : 0;
+    ++valueWriteCount;
+    return true;
+}
+
+bool InMemoryGpioBackend::readValue(uint16_t pinNum, uint8_t* value)
+{
+    std::lock_guard<std::mutex> lock{attributesMutex};
+    auto pinIter = pinAttributes.find(pinNum);
+    if (pinIter == pinAttributes.end())
+    {
+        return false;
+    }
+
+    *value = pinIter->second.value;
+    return true;
+}
+
+std::string InMemoryGpioBackend::getValuePath(uint16_t pinNum) const
+{
+    (void) pinNum;
+    return "";
+}
+
+/**
+ * Sets pinNum's value regardless of its direction, exporting it if needed
+ */
+void InMemoryGpioBackend::setInputValue(uint16_t pinNum, uint8_t value)
+{
+    std::lock_guard<std::mutex> lock{attributesMutex};
+    pinAttributes[pinNum].value = value ? 1 : 0;
+}
+
+uint64_t InMemoryGpioBackend::getValueWriteCount()
+{
+    std::lock_guard<std::mutex> lock{attributesMutex};
+    return valueWriteCount;
+}
@@ -0,0 +1,59 @@
+/*
+ * InMemoryGpioBackend.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+#ifndef GPIO_INMEMORYGPIOBACKEND_HPP_
+#define GPIO_INMEMORYGPIOBACKEND_HPP_
+
+// System Includes
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Project Includes
+#include "GpioBackend.hpp"
+
+/**
+ * Keeps each pin's attributes in memory, modelling the sysfs rules which
+ * GpioController relies on: a pin must be exported before it's used,
+ * writing "low" or "high" to direction also sets the value, and only
+ * outputs can be written. Intended for tests and benchmarks; it has no
+ * value files, so input monitoring and PWM aren't available with it.
+ */
+class InMemoryGpioBackend : public GpioBackend
+{
+public:
+    void exportPins(const std::vector<uint16_t>& pinNums) override;
+    bool isPinReady(uint16_t pinNum) override;
+    bool writeAttribute(uint16_t pinNum, const std::string& attribute,
+            const std::string& value) override;
+    bool writeValue(uint16_t pinNum, uint8_t value) override;
+    bool readValue(uint16_t pinNum, uint8_t* value) override;
+    std::string getValuePath(uint16_t pinNum) const override;
+
+    // Sets the value of pinNum as if driven externally, e.g. an input
+    void setInputValue(uint16_t pinNum, uint8_t value);
+
+    // Number of successful writeValue() calls
+    uint64_t getValueWriteCount();
+
+private:
+    struct PinAttributes
+    {
+        std::string direction = "in";
+        std::string edge = "none";
+        uint8_t value = 0;
+    };
+
+    // Exported pins
+    std::unordered_map<uint16_t, PinAttributes> pinAttributes;
+    uint64_t valueWriteCount = 0;
+    std::mutex attributesMutex;
+};
+
+#endif /* GPIO_INMEMORYGPIOBACKEND_HPP_ */
@@ -0,0 +1,354 @@
+/*
+ * SoftPwmEngine.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+// System Includes
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <fcntl.h>
+#include <iostream>
+#include <mutex>
+#include <pthread.h>
+#include <sched.h>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+
+// Project Includes
+#include "SoftPwmEngine.hpp"
+
+// Static initialization
+const double SoftPwmEngine::MAX_FREQUENCY_HZ = 10000.0;
+const int64_t SoftPwmEngine::MAX_SLEEP_NS = 20 * 1000 * 1000;
+const int SoftPwmEngine::REALTIME_PRIORITY = 50;
+
+/**
+ * Starts the engine thread, which idles until the first channel is set
+ */
+SoftPwmEngine::SoftPwmEngine() :
+        running(true), realtime(false), lastGeneration(0), wakeups(0),
+        totalLatenessNs(0), maxLatenessNs(0)
+{
+    engineThread = std::thread(&SoftPwmEngine::engineLoop, this);
+}
+
+/**
+ * Stops the engine thread and closes every channel's value file. The pins
+ * are left at whatever level they were last driven to.
+ */
+SoftPwmEngine::~SoftPwmEngine()
+{
+    {
+        std::lock_guard<std::mutex> lock{engineMutex};
+        running = false;
+    }
+    scheduleChanged.notify_all();
+    engineThread.join();
+
+    for (auto& channel : channels)
+    {
+        closeChannel(channel.second);
+    }
+}
+
+/**
+ * Starts, or reconfigures, PWM on pinNum. dutyPercent must be strictly
+ * between 0 and 100, and frequencyHz greater than 0 and at most
+ * MAX_FREQUENCY_HZ; otherwise a std::invalid_argument is thrown. Constant
+ * levels should be written directly after stopChannel() instead. If
+ * valuePath can't be opened, a std::system_error is thrown.
+ */
+void SoftPwmEngine::setChannel(uint16_t pinNum, const std::string& valuePath,
+        double dutyPercent, double frequencyHz)
+{
+    if (!(dutyPercent > 0.0 && dutyPercent < 100.0))
+    {
+        throw std::invalid_argument("PWM duty cycle must be between 0 and 100 exclusive");
+    }
+    if (!(frequencyHz > 0.0 && frequencyHz <= MAX_FREQUENCY_HZ))
+    {
+        throw std::invalid_argument("PWM frequency must be greater than 0 and at most " +
+                std::to_string(static_cast<int>(MAX_FREQUENCY_HZ)) + "Hz");
+    }
+
+    std::lock_guard<std::mutex> lock{engineMutex};
+
+    auto channelIter = channels.find(pinNum);
+    if (channelIter == channels.end())
+    {
+        int valueFd = open(valuePath.c_str(), O_WRONLY | O_CLOEXEC);
+        if (valueFd < 0)
+        {
+            throw std::system_error(errno, std::system_category(),
+                    "Error opening " + valuePath + " for PWM");
+        }
+
+        Channel newChannel = {};
+        newChannel.valueFd = valueFd;
+        channelIter = channels.insert(std::make_pair(pinNum, newChannel)).first;
+    }
+
+    Channel& channel = channelIter->second;
+    channel.dutyPercent = dutyPercent;
+    channel.frequencyHz = frequencyHz;
+    channel.periodNs = static_cast<int64_t>(1e9 / frequencyHz);
+    channel.highNs = static_cast<int64_t>(channel.periodNs * dutyPercent / 100.0);
+    channel.cycleStartNs = getMonotonicNs();
+    channel.isHigh = false;
+    channel.lastRiseNs = 0;
+    channel.totalPeriodNs = 0;
+    channel.maxPeriodErrorNs = 0;
+    channel.periods = 0;
+    channel.missedPeriods = 0;
+    channel.generation = ++lastGeneration;
+
+    bool wasEmpty = schedule.empty();
+    schedule.push(ScheduledEdge{channel.cycleStartNs, pinNum, channel.generation});
+
+    if (wasEmpty)
+    {
+        scheduleChanged.notify_all();
+    }
+}
+
+/**
+ * Stops PWM on pinNum and closes its value file. Returns true if the pin had
+ * a running channel. Once this returns, the engine won't write the pin again.
+ */
+bool SoftPwmEngine::stopChannel(uint16_t pinNum)
+{
+    std::lock_guard<std::mutex> lock{engineMutex};
+
+    auto channelIter = channels.find(pinNum);
+    if (channelIter == channels.end())
+    {
+        return false;
+    }
+
+    // Its remaining heap entries no longer match any channel, and are
+    // discarded by the engine thread as they come up
+    closeChannel(channelIter->second);
+    channels.erase(channelIter);
+    return true;
+}
+
+/**
+ * Stops PWM on every pin
+ */
+void SoftPwmEngine::stopAllChannels()
+{
+    std::lock_guard<std::mutex> lock{engineMutex};
+
+    for (auto& channel : channels)
+    {
+        closeChannel(channel.second);
+    }
+    channels.clear();
+    schedule = decltype(schedule)();
+}
+
+/**
+ * Returns the engine's wakeup lateness and, for each channel, the average
+ * period actually achieved between rising edges and the largest deviation of
+ * a single period from nominal. A channel's missedPeriods counts whole
+ * periods skipped because the engine fell more than a period behind, which
+ * indicates the engine is saturated.
+ */
+SoftPwmEngine::EngineStats SoftPwmEngine::getStats()
+{
+    std::lock_guard<std::mutex> lock{engineMutex};
+
+    EngineStats stats;
+    stats.realtime = realtime;
+    stats.wakeups = wakeups;
+    stats.meanLatenessNs = wakeups ? static_cast<double>(totalLatenessNs) / wakeups : 0.0;
+    stats.maxLatenessNs = maxLatenessNs;
+
+    for (const auto& channelEntry : channels)
+    {
+        const Channel& channel = channelEntry.second;
+
+        ChannelStats channelStats;
+        channelStats.pinNum = channelEntry.first;
+        channelStats.dutyPercent = channel.dutyPercent;
+        channelStats.frequencyHz = channel.frequencyHz;
+        channelStats.nominalPeriodNs = channel.periodNs;
+        channelStats.achievedPeriodNs = channel.periods ?
+                static_cast<double>(channel.totalPeriodNs) / channel.periods : 0.0;
+        channelStats.maxPeriodErrorNs = channel.maxPeriodErrorNs;
+        channelStats.periods = channel.periods;
+        channelStats.missedPeriods = channel.missedPeriods;
+        stats.channels.push_back(channelStats);
+    }
+
+    return stats;
+}
+
+/**
+ * Executed by engineThread. Sleeps until the earliest scheduled edge, then
+ * processes every edge which has come due, and repeats.
+ */
+void SoftPwmEngine::engineLoop()
+{
+    bool gotRealtime = requestRealtimePriority();
+
+    std::unique_lock<std::mutex> lock{engineMutex};
+    realtime = gotRealtime;
+
+    while (running)
+    {
+        if (schedule.empty())
+        {
+            scheduleChanged.wait(lock);
+            continue;
+        }
+
+        ScheduledEdge nextEdge = schedule.top();
+        auto channelIter = channels.find(nextEdge.pinNum);
+        if (channelIter == channels.end() ||
+            channelIter->second.generation != nextEdge.generation)
+        {
+            schedule.pop();
+            continue;
+        }
+
+        int64_t nowNs = getMonotonicNs();
+        if (nextEdge.deadlineNs > nowNs)
+        {
+            int64_t sleepUntilNs = std::min(nextEdge.deadlineNs, nowNs + MAX_SLEEP_NS);
+            lock.unlock();
+            sleepUntil(sleepUntilNs);
+            lock.lock();
+            continue;
+        }
+
+        ++wakeups;
+        int64_t latenessNs = nowNs - nextEdge.deadlineNs;
+        totalLatenessNs += latenessNs;
+        maxLatenessNs = std::max(maxLatenessNs, latenessNs);
+
+        // Everything due by now is handled in this wakeup
+        while (!schedule.empty() && schedule.top().deadlineNs <= nowNs)
+        {
+            ScheduledEdge dueEdge = schedule.top();
+            schedule.pop();
+
+            channelIter = channels.find(dueEdge.pinNum);
+            if (channelIter == channels.end() ||
+                channelIter->second.generation != dueEdge.generation)
+            {
+                continue;
+            }
+            processEdge(channelIter->second, dueEdge, nowNs);
+        }
+    }
+}
+
+/**
+ * Drives channel to the level following edge, and schedules its next edge.
+ * Expects engineMutex to be held.
+ */
+void SoftPwmEngine::processEdge(Channel& channel, const ScheduledEdge& edge, int64_t nowNs)
+{
+    if (!channel.isHigh)
+    {
+        (void) pwrite(channel.valueFd, "1", 1, 0);
+        channel.isHigh = true;
+
+        int64_t actualRiseNs = getMonotonicNs();
+        if (channel.lastRiseNs != 0)
+        {
+            int64_t actualPeriodNs = actualRiseNs - channel.lastRiseNs;
+            channel.totalPeriodNs += actualPeriodNs;
+            channel.maxPeriodErrorNs = std::max(channel.maxPeriodErrorNs,
+                    std::abs(actualPeriodNs - channel.periodNs));
+            ++channel.periods;
+        }
+        channel.lastRiseNs = actualRiseNs;
+
+        schedule.push(ScheduledEdge{channel.cycleStartNs + channel.highNs,
+                edge.pinNum, channel.generation});
+    }
+    else
+    {
+        (void) pwrite(channel.valueFd, "0", 1, 0);
+        channel.isHigh = false;
+
+        channel.cycleStartNs += channel.periodNs;
+
+        // If more than a whole period has been lost, skip ahead rather than
+        // emitting a burst of short catch-up periods
+        if (channel.cycleStartNs + channel.periodNs <= nowNs)
+        {
+            int64_t periodsBehind = (nowNs - channel.cycleStartNs) / channel.periodNs;
+            channel.cycleStartNs += periodsBehind * channel.periodNs;
+            channel.missedPeriods += periodsBehind;
+            // The period spanning the gap isn't representative
+            channel.lastRiseNs = 0;
+        }
+
+        schedule.push(ScheduledEdge{channel.cycleStartNs, edge.pinNum,
+                channel.generation});
+    }
+}
+
+/**
+ * Expects engineMutex to be held
+ */
+void SoftPwmEngine::closeChannel(Channel& channel)
+{
+    if (channel.valueFd >= 0)
+    {
+        close(channel.valueFd);
+        channel.valueFd = -1;
+    }
+}
+
+int64_t SoftPwmEngine::getMonotonicNs()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+}
+
+/**
+ * Sleeps until the absolute CLOCK_MONOTONIC time deadlineNs
+ */
+void SoftPwmEngine::sleepUntil(int64_t deadlineNs)
+{
+    timespec deadline;
+    deadline.tv_sec = deadlineNs / 1000000000;
+    deadline.tv_nsec = deadlineNs % 1000000000;
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR)
+    {
+    }
+}
+
+/**
+ * Attempts to move the calling thread to SCHED_FIFO. Returns true on success.
+ */
+bool SoftPwmEngine::requestRealtimePriority()
+{
+    sched_param schedParam = {};
+    schedParam.sched_priority = REALTIME_PRIORITY;
+
+    int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &schedParam);
+    if (result != 0)
+    {
+        std::cout << "PWM engine: unable to use SCHED_FIFO (error " << result
+                << "); running at normal priority" << std::endl;
+        return false;
+    }
+
+    std::cout << "PWM engine: running with SCHED_FIFO priority "
+            << REALTIME_PRIORITY << std::endl;
+    return true;
+}
@@ -0,0 +1,151 @@
+/*
+ * SoftPwmEngine.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+#ifndef GPIO_SOFTPWMENGINE_HPP_
+#define GPIO_SOFTPWMENGINE_HPP_
+
+// System Includes
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Project Includes
+// <none>
+
+/**
+ * Generates software PWM on any number of GPIO pins from a single thread.
+ * Every pending edge of every channel is kept in one time-sorted schedule
+ * (a min-heap keyed on its absolute CLOCK_MONOTONIC deadline), and the
+ * engine thread sleeps until the earliest one with clock_nanosleep() and
+ * TIMER_ABSTIME, so errors don't accumulate from period to period.
+ *
+ * Each channel's value file is opened once, when the channel is set, and
+ * written with pwrite() on every edge. The engine thread requests SCHED_FIFO
+ * scheduling; if that isn't permitted it runs at normal priority and says so
+ * in its stats.
+ */
+class SoftPwmEngine
+{
+public:
+    struct ChannelStats
+    {
+        uint16_t pinNum;
+        double dutyPercent;
+        double frequencyHz;
+        int64_t nominalPeriodNs;
+        double achievedPeriodNs;
+        int64_t maxPeriodErrorNs;
+        uint64_t periods;
+        uint64_t missedPeriods;
+    };
+
+    struct EngineStats
+    {
+        bool realtime;
+        uint64_t wakeups;
+        double meanLatenessNs;
+        int64_t maxLatenessNs;
+        std::vector<ChannelStats> channels;
+    };
+
+    SoftPwmEngine();
+    ~SoftPwmEngine();
+
+    SoftPwmEngine(const SoftPwmEngine&) = delete;
+    SoftPwmEngine& operator=(const SoftPwmEngine&) = delete;
+
+    void setChannel(uint16_t pinNum, const std::string& valuePath,
+            double dutyPercent, double frequencyHz);
+    bool stopChannel(uint16_t pinNum);
+    void stopAllChannels();
+
+    EngineStats getStats();
+
+    static const double MAX_FREQUENCY_HZ;
+
+private:
+    struct Channel
+    {
+        int valueFd;
+        double dutyPercent;
+        double frequencyHz;
+        int64_t periodNs;
+        int64_t highNs;
+
+        // Deadline of the rising edge which started the current period
+        int64_t cycleStartNs;
+        bool isHigh;
+
+        // Assigned from lastGeneration on every (re)configuration; heap
+        // entries carrying any other generation are discarded when they
+        // reach the top
+        uint32_t generation;
+
+        // Stats
+        int64_t lastRiseNs;
+        int64_t totalPeriodNs;
+        int64_t maxPeriodErrorNs;
+        uint64_t periods;
+        uint64_t missedPeriods;
+    };
+
+    struct ScheduledEdge
+    {
+        int64_t deadlineNs;
+        uint16_t pinNum;
+        uint32_t generation;
+
+        bool operator>(const ScheduledEdge& other) const
+        {
+            return deadlineNs > other.deadlineNs;
+        }
+    };
+
+    void engineLoop();
+    void processEdge(Channel& channel, const ScheduledEdge& edge, int64_t nowNs);
+    void closeChannel(Channel& channel);
+
+    static int64_t getMonotonicNs();
+    static void sleepUntil(int64_t deadlineNs);
+    static bool requestRealtimePriority();
+
+    std::map<uint16_t, Channel> channels;
+    std::priority_queue<ScheduledEdge, std::vector<ScheduledEdge>,
+            std::greater<ScheduledEdge>> schedule;
+
+    bool running;
+    bool realtime;
+    uint32_t lastGeneration;
+
+    // Stats
+    uint64_t wakeups;
+    int64_t totalLatenessNs;
+    int64_t maxLatenessNs;
+
+    // Guards everything above. The engine thread holds it while processing
+    // due edges, never while sleeping, so once stopChannel() returns the pin
+    // won't be written by the engine again.
+    std::mutex engineMutex;
+
+    // Signalled when the schedule goes from empty to non-empty, or on stop
+    std::condition_variable scheduleChanged;
+
+    std::thread engineThread;
+
+    // The engine never sleeps longer than this, so that newly added channels
+    // start promptly even if a slow channel's next edge is far away
+    static const int64_t MAX_SLEEP_NS;
+    static const int REALTIME_PRIORITY;
+};
+
+#endif /* GPIO_SOFTPWMENGINE_HPP_ */
@@ -0,0 +1,134 @@
+/*
+ * SysfsGpioBackend.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+// System Includes
+#include <cerrno>
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+
+// Project Includes
+#include "SysfsGpioBackend.hpp"
+
+// Static initialization
+const std::string SysfsGpioBackend::DEFAULT_SYSFS_ROOT = "/sys/class/gpio";
+
+SysfsGpioBackend::SysfsGpioBackend(const std::string& sysfsRoot):
+        sysfsRoot(sysfsRoot)
+{
+}
+
+/**
+ * Writes every pin in pinNums to the export file through a single open fd.
+ * Pins which are already exported are rejected by the kernel with EBUSY,
+ * which is expected and ignored.
+ */
+void SysfsGpioBackend::exportPins(const std::vector<uint16_t>& pinNums)
+{
+    std::string exportPath = sysfsRoot + "/export";
+    int exportFd = open(exportPath.c_str(), O_WRONLY | O_CLOEXEC);
+    if (exportFd < 0)
+    {
+        std::cerr << "Unable to open: " << exportPath << "; errno "
+                << errno << std::endl;
+        return;
+    }
+
+    for (uint16_t pinNum : pinNums)
+    {
+        std::string pinNumString = std::to_string(pinNum);
+        if (write(exportFd, pinNumString.c_str(), pinNumString.length()) < 0 &&
+            errno != EBUSY)
+        {
+            std::cerr << "Unable to export pin: " << pinNum << "; errno "
+                    << errno << std::endl;
+        }
+    }
+
+    close(exportFd);
+}
+
+/**
+ * A pin is ready once udev has created its direction and value files and
+ * made them writable by this process
+ */
+bool SysfsGpioBackend::isPinReady(uint16_t pinNum)
+{
+    return access(getAttributePath(pinNum, "direction").c_str(), W_OK) == 0 &&
+           access(getValuePath(pinNum).c_str(), W_OK) == 0;
+}
+
+bool SysfsGpioBackend::writeAttribute(uint16_t pinNum, const std::string& attribute,
+        const std::string& value)
+{
+    return writeStringToPath(getAttributePath(pinNum, attribute), value);
+}
+
+bool SysfsGpioBackend::writeValue(uint16_t pinNum, uint8_t value)
+{
+    return writeStringToPath(getValuePath(pinNum), value ? "1" : "0");
+}
+
+bool SysfsGpioBackend::readValue(uint16_t pinNum, uint8_t* value)
+{
+    std::string valuePath = getValuePath(pinNum);
+    int fd = open(valuePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        std::cerr << "Unable to open: " << valuePath << "; errno " << errno << std::endl;
+        return false;
+    }
+
+    char valueChar = '0';
+    bool read = pread(fd, &valueChar, 1, 0) == 1;
+    if (!read)
+    {
+        std::cerr << "Unable to read: " << valuePath << "; errno " << errno << std::endl;
+    }
+
+    close(fd);
+    *value = valueChar == '1' ? 1 : 0;
+    return read;
+}
+
+std::string SysfsGpioBackend::getValuePath(uint16_t pinNum) const
+{
+    return getAttributePath(pinNum, "value");
+}
+
+/**
+ * Returns the path of attribute for pinNum, e.g. <root>/gpio17/direction
+ */
+std::string SysfsGpioBackend::getAttributePath(uint16_t pinNum, const std::string& attribute) const
+{
+    return sysfsRoot + "/gpio" + std::to_string(pinNum) + "/" + attribute;
+}
+
+/**
+ * Writes value to the file at filePath with a single write(). Returns false,
+ * after logging the error, if the file couldn't be opened or written.
+ */
+bool SysfsGpioBackend::writeStringToPath(const std::string& filePath, const std::string& value)
+{
+    int fd = open(filePath.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        std::cerr << "Unable to open: " << filePath << "; errno " << errno << std::endl;
+        return false;
+    }
+
+    bool written = write(fd, value.c_str(), value.length()) ==
+            static_cast<ssize_t>(value.length());
+    if (!written)
+    {
+        std::cerr << "Unable to write: " << value << " to: " << filePath
+                << "; errno " << errno << std::endl;
+    }
+
+    close(fd);
+    return written;
+}
@@ -0,0 +1,49 @@
+/*
+ * SysfsGpioBackend.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+#ifndef GPIO_SYSFSGPIOBACKEND_HPP_
+#define GPIO_SYSFSGPIOBACKEND_HPP_
+
+// System Includes
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Project Includes
+#include "GpioBackend.hpp"
+
+/**
+ * Drives pins through the sysfs GPIO interface rooted at sysfsRoot (normally
+ * DEFAULT_SYSFS_ROOT). Every access opens, uses, and closes the attribute's
+ * file; see CachedFdGpioBackend for a backend which keeps value files open.
+ * Pointing sysfsRoot at a directory of regular files allows this backend to
+ * be exercised without GPIO hardware.
+ */
+class SysfsGpioBackend : public GpioBackend
+{
+public:
+    explicit SysfsGpioBackend(const std::string& sysfsRoot=DEFAULT_SYSFS_ROOT);
+
+    void exportPins(const std::vector<uint16_t>& pinNums) override;
+    bool isPinReady(uint16_t pinNum) override;
+    bool writeAttribute(uint16_t pinNum, const std::string& attribute,
+            const std::string& value) override;
+    bool writeValue(uint16_t pinNum, uint8_t value) override;
+    bool readValue(uint16_t pinNum, uint8_t* value) override;
+    std::string getValuePath(uint16_t pinNum) const override;
+
+    static const std::string DEFAULT_SYSFS_ROOT;
+
+protected:
+    std::string getAttributePath(uint16_t pinNum, const std::string& attribute) const;
+
+    static bool writeStringToPath(const std::string& filePath, const std::string& value);
+
+    const std::string sysfsRoot;
+};
+
+#endif /* GPIO_SYSFSGPIOBACKEND_HPP_ */
@@ -0,0 +1,387 @@
+/*
+ * CommandJournal.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+// System Includes
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <iostream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Project Includes
+#include "CommandJournal.hpp"
+
+// Static initialization
+const size_t CommandJournal::DEFAULT_SEGMENT_SIZE = 4 * 1024 * 1024;
+const size_t CommandJournal::MIN_SEGMENT_SIZE = 64 * 1024;
+const size_t CommandJournal::MAX_SEGMENT_SIZE = 1024 * 1024 * 1024;
+const std::chrono::milliseconds CommandJournal::DEFAULT_SYNC_INTERVAL = std::chrono::seconds(1);
+const size_t CommandJournal::MAPPED_SEGMENTS;
+const uint64_t CommandJournal::NOT_SEALED = UINT64_MAX;
+
+const MetricsRegistry::Counter CommandJournal::RECORDS =
+        MetricsRegistry::getInstance().registerCounter("netsysctrld_journal_records_total",
+        "Commands written to the command journal");
+const MetricsRegistry::Counter CommandJournal::DROPPED_RECORDS =
+        MetricsRegistry::getInstance().registerCounter("netsysctrld_journal_dropped_records_total",
+        "Commands which couldn't be journalled, as a new segment couldn't be created");
+const MetricsRegistry::Counter CommandJournal::SEGMENTS_CREATED =
+        MetricsRegistry::getInstance().registerCounter("netsysctrld_journal_segments_total",
+        "Command journal segments created");
+
+static_assert(sizeof(JournalFormat::SegmentHeader) % 8 == 0 &&
+        sizeof(JournalFormat::RecordHeader) % 8 == 0,
+        "Journal headers must keep records 8 byte aligned");
+
+CommandJournal::Builder& CommandJournal::Builder::withDirectory(const std::string& directory)
+{
+    this->directory = directory;
+    return *this;
+}
+
+CommandJournal::Builder& CommandJournal::Builder::withSegmentSize(size_t segmentSize)
+{
+    this->segmentSize = segmentSize;
+    return *this;
+}
+
+CommandJournal::Builder& CommandJournal::Builder::withSyncInterval(
+        std::chrono::milliseconds syncInterval)
+{
+    this->syncInterval = syncInterval;
+    return *this;
+}
+
+CommandJournalSharedPtr CommandJournal::Builder::build() const
+{
+    if (directory.empty())
+    {
+        throw std::invalid_argument("A command journal directory must be specified");
+    }
+    if (segmentSize < MIN_SEGMENT_SIZE || segmentSize > MAX_SEGMENT_SIZE)
+    {
+        throw std::invalid_argument("Command journal segment size: " + std::to_string(segmentSize) +
+                " must be between " + std::to_string(MIN_SEGMENT_SIZE) + " and " +
+                std::to_string(MAX_SEGMENT_SIZE) + " bytes");
+    }
+    if (syncInterval.count() <= 0)
+    {
+        throw std::invalid_argument("The command journal's sync interval must be positive");
+    }
+
+    if (mkdir(directory.c_str(), 0755) != 0 && errno != EEXIST)
+    {
+        throw std::runtime_error("Unable to create command journal directory: " + directory +
+                "; " + std::strerror(errno));
+    }
+
+    return CommandJournalSharedPtr(new CommandJournal(directory, segmentSize, syncInterval));
+}
+
+/**
+ * Starts a segment after any already in directory
+ */
+CommandJournal::CommandJournal(const std::string& directory, size_t segmentSize,
+        std::chrono::milliseconds syncInterval):
+        directory(directory),
+        segmentSize(segmentSize),
+        syncInterval(syncInterval),
+        cursor(makeCursor(0, sizeof(JournalFormat::SegmentHeader))),
+        nextSegmentIndex(findNextSegmentIndex(directory))
+{
+    mappedSegments[0].store(createSegment(nextSegmentIndex++));
+    for (size_t slotIdx = 1; slotIdx < MAPPED_SEGMENTS; ++slotIdx)
+    {
+        mappedSegments[slotIdx].store(nullptr);
+    }
+    SEGMENTS_CREATED.increment();
+
+    syncThread = std::thread(&CommandJournal::syncLoop, this);
+}
+
+/**
+ * Stops the sync thread, then flushes and unmaps the segments
+ */
+CommandJournal::~CommandJournal()
+{
+    {
+        std::lock_guard<std::mutex> lock{syncMutex};
+        stopSyncing = true;
+    }
+    syncWakeup.notify_all();
+    syncThread.join();
+
+    std::lock_guard<std::mutex> lock{rotationMutex};
+    for (std::atomic<Segment*>& mappedSegment : mappedSegments)
+    {
+        Segment* segment = mappedSegment.exchange(nullptr);
+        if (segment)
+        {
+            releaseSegment(segment);
+        }
+    }
+}
+
+/**
+ * A record which fits is written without taking any lock. The writer whose
+ * reservation first overflows a segment seals it at its start offset, so
+ * whoever later unmaps the segment knows how many bytes to wait for.
+ */
+void CommandJournal::record(const std::string& clientAddress, uint16_t clientPort,
+        const std::string& command, const std::string& param,
+        const std::string& result, bool succeeded)
+{
+    const size_t clientAddressLength = std::min(clientAddress.length(), JournalFormat::MAX_STRING_LENGTH);
+    const size_t commandLength = std::min(command.length(), JournalFormat::MAX_STRING_LENGTH);
+    const size_t paramLength = std::min(param.length(), JournalFormat::MAX_STRING_LENGTH);
+    const size_t resultLength = std::min(result.length(), JournalFormat::MAX_STRING_LENGTH);
+    const uint32_t recordLength = static_cast<uint32_t>(JournalFormat::getRecordLength(
+            clientAddressLength + commandLength + paramLength + resultLength));
+
+    const int64_t timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+
+    while (true)
+    {
+        const uint64_t reservation = cursor.fetch_add(recordLength, std::memory_order_acq_rel);
+        const uint32_t reservedGeneration = static_cast<uint32_t>(reservation >> 32);
+        const uint64_t offset = reservation & UINT32_MAX;
+        Segment* segment = mappedSegments[reservedGeneration % MAPPED_SEGMENTS].load(
+                std::memory_order_acquire);
+
+        if (offset + recordLength <= segmentSize)
+        {
+            char* recordStart = segment->base + offset;
+            JournalFormat::RecordHeader* header =
+                    reinterpret_cast<JournalFormat::RecordHeader*>(recordStart);
+            __atomic_store_n(&header->length, recordLength, __ATOMIC_RELAXED);
+            header->timestampNs = timestampNs;
+            header->clientPort = clientPort;
+            header->clientAddressLength = static_cast<uint16_t>(clientAddressLength);
+            header->commandLength = static_cast<uint16_t>(commandLength);
+            header->paramLength = static_cast<uint16_t>(paramLength);
+            header->resultLength = static_cast<uint16_t>(resultLength);
+            header->succeeded = succeeded ? 1 : 0;
+
+            char* strings = recordStart + sizeof(JournalFormat::RecordHeader);
+            std::memcpy(strings, clientAddress.data(), clientAddressLength);
+            strings += clientAddressLength;
+            std::memcpy(strings, command.data(), commandLength);
+            strings += commandLength;
+            std::memcpy(strings, param.data(), paramLength);
+            strings += paramLength;
+            std::memcpy(strings, result.data(), resultLength);
+
+            __atomic_store_n(&header->committed, JournalFormat::COMMITTED, __ATOMIC_RELEASE);
+            segment->writtenBytes.fetch_add(recordLength, std::memory_order_release);
+            RECORDS.increment();
+            return;
+        }
+
+        if (offset <= segmentSize)
+        {
+            segment->sealedOffset.store(offset, std::memory_order_release);
+        }
+
+        if (!rotate(reservedGeneration))
+        {
+            DROPPED_RECORDS.increment();
+            return;
+        }
+    }
+}
+
+/**
+ * Maps the segment after fullGeneration's, unless another writer already
+ * has. The segment it replaces in mappedSegments is unmapped once its last
+ * records are written. Returns false if the new segment couldn't be
+ * created; the cursor is then left past the end of the full segment, so
+ * the next record tries again.
+ */
+bool CommandJournal::rotate(uint32_t fullGeneration)
+{
+    std::lock_guard<std::mutex> lock{rotationMutex};
+    if (generation != fullGeneration)
+    {
+        return true;
+    }
+
+    Segment* nextSegment = nullptr;
+    try
+    {
+        nextSegment = createSegment(nextSegmentIndex);
+    }
+    catch (const std::runtime_error& err)
+    {
+        if (!rotationFailed)
+        {
+            std::cerr << "Command journal: " << err.what() << "; dropping records until"
+                    " a segment can be created" << std::endl;
+            rotationFailed = true;
+        }
+        cursor.store(makeCursor(generation, static_cast<uint32_t>(segmentSize + 1)),
+                std::memory_order_release);
+        return false;
+    }
+    ++nextSegmentIndex;
+    rotationFailed = false;
+    SEGMENTS_CREATED.increment();
+
+    const uint32_t nextGeneration = generation + 1;
+    std::atomic<Segment*>& slot = mappedSegments[nextGeneration % MAPPED_SEGMENTS];
+    Segment* retiringSegment = slot.load(std::memory_order_relaxed);
+    if (retiringSegment)
+    {
+        // Its writers don't need any lock to finish, so this can't deadlock
+        uint64_t sealedOffset;
+        while ((sealedOffset = retiringSegment->sealedOffset.load(std::memory_order_acquire)) == NOT_SEALED ||
+                retiringSegment->writtenBytes.load(std::memory_order_acquire) < sealedOffset)
+        {
+            std::this_thread::yield();
+        }
+        releaseSegment(retiringSegment);
+    }
+    slot.store(nextSegment, std::memory_order_release);
+
+    generation = nextGeneration;
+    cursor.store(makeCursor(nextGeneration, sizeof(JournalFormat::SegmentHeader)),
+            std::memory_order_release);
+    return true;
+}
+
+/**
+ * Creates and preallocates the segment file, so that writes into the
+ * mapping can't fail for lack of space, then maps it and writes its header.
+ * Throws a std::runtime_error on failure.
+ */
+CommandJournal::Segment* CommandJournal::createSegment(uint64_t segmentIndex) const
+{
+    const std::string path = directory + "/" + JournalFormat::getSegmentFileName(segmentIndex);
+
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Unable to create command journal segment: " + path +
+                "; " + std::strerror(errno));
+    }
+
+    // posix_fallocate() returns its error rather than setting errno
+    int allocateErr = posix_fallocate(fd, 0, static_cast<off_t>(segmentSize));
+    if (allocateErr != 0)
+    {
+        close(fd);
+        unlink(path.c_str());
+        throw std::runtime_error("Unable to allocate command journal segment: " + path +
+                "; " + std::strerror(allocateErr));
+    }
+
+    void* mapping = mmap(nullptr, segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        int mmapErrno = errno;
+        close(fd);
+        unlink(path.c_str());
+        throw std::runtime_error("Unable to map command journal segment: " + path +
+                "; " + std::strerror(mmapErrno));
+    }
+
+    Segment* segment = new Segment;
+    segment->index = segmentIndex;
+    segment->fd = fd;
+    segment->base = static_cast<char*>(mapping);
+    segment->sealedOffset.store(NOT_SEALED);
+    segment->writtenBytes.store(sizeof(JournalFormat::SegmentHeader));
+
+    JournalFormat::SegmentHeader* header =
+            reinterpret_cast<JournalFormat::SegmentHeader*>(segment->base);
+    header->magic = JournalFormat::MAGIC;
+    header->version = JournalFormat::VERSION;
+    header->segmentSize = segmentSize;
+    header->segmentIndex = segmentIndex;
+    header->createdNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+
+    return segment;
+}
+
+/**
+ * Flushes segment to disk, unmaps it, and frees it
+ */
+void CommandJournal::releaseSegment(Segment* segment) const
+{
+    msync(segment->base, segmentSize, MS_SYNC);
+    munmap(segment->base, segmentSize);
+    close(segment->fd);
+    delete segment;
+}
+
+/**
+ * Only the pages dirtied since the last sync are written
+ */
+void CommandJournal::syncSegmentsLocked() const
+{
+    for (const std::atomic<Segment*>& mappedSegment : mappedSegments)
+    {
+        Segment* segment = mappedSegment.load(std::memory_order_relaxed);
+        if (segment && msync(segment->base, segmentSize, MS_SYNC) != 0)
+        {
+            std::cerr << "Command journal: unable to sync segment " << segment->index << "; "
+                    << std::strerror(errno) << std::endl;
+        }
+    }
+}
+
+void CommandJournal::syncLoop()
+{
+    std::unique_lock<std::mutex> syncLock{syncMutex};
+    while (!syncWakeup.wait_for(syncLock, syncInterval, [this]() { return stopSyncing; }))
+    {
+        syncLock.unlock();
+        {
+            std::lock_guard<std::mutex> rotationLock{rotationMutex};
+            syncSegmentsLocked();
+        }
+        syncLock.lock();
+    }
+}
+
+/**
+ * Returns one past the highest segment index in directory, or 0 if it has
+ * no segments. Throws a std::runtime_error if it can't be read.
+ */
+uint64_t CommandJournal::findNextSegmentIndex(const std::string& directory)
+{
+    DIR* dir = opendir(directory.c_str());
+    if (!dir)
+    {
+        throw std::runtime_error("Unable to read command journal directory: " + directory +
+                "; " + std::strerror(errno));
+    }
+
+    uint64_t nextIndex = 0;
+    while (struct dirent* entry = readdir(dir))
+    {
+        uint64_t segmentIndex;
+        if (JournalFormat::parseSegmentFileName(entry->d_name, segmentIndex))
+        {
+            nextIndex = std::max(nextIndex, segmentIndex + 1);
+        }
+    }
+    closedir(dir);
+
+    return nextIndex;
+}
+
+uint64_t CommandJournal::makeCursor(uint32_t generation, uint32_t offset)
+{
+    return (static_cast<uint64_t>(generation) << 32) | offset;
+}
@@ -0,0 +1,157 @@
+/*
+ * CommandJournal.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+#ifndef JOURNAL_COMMANDJOURNAL_HPP_
+#define JOURNAL_COMMANDJOURNAL_HPP_
+
+// System Includes
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Project Includes
+#include "JournalFormat.hpp"
+#include "MetricsRegistry.hpp"
+
+// Forward declarations
+class CommandJournal;
+
+// Using statements
+using CommandJournalSharedPtr = std::shared_ptr<CommandJournal>;
+
+/**
+ * An append-only, binary journal of the state-mutating commands clients
+ * executed, for auditing and for working out what state the daemon was left
+ * in after a crash. See JournalFormat for the layout, and the
+ * netsysctrld-journal-dump tool for reading it back.
+ *
+ * Records are written straight into a preallocated segment file which is
+ * mapped into memory. Space is reserved with a single fetch_add on a cursor
+ * holding the current segment's generation and write offset, so concurrent
+ * clients never wait on each other while journalling. Only clients whose
+ * reservations run off the end of a segment take a lock: the first of them
+ * maps the next segment, and they all try again in it.
+ *
+ * Once a record is written it's in the page cache, so it survives the
+ * daemon crashing; a background thread msyncs the mapped segments every
+ * sync interval, so at most that much is lost to a power failure. Segments
+ * are never deleted or reused; a restarted daemon starts a new one.
+ */
+class CommandJournal
+{
+public:
+    class Builder
+    {
+    public:
+        Builder() {};
+        Builder& withDirectory(const std::string& directory);
+        Builder& withSegmentSize(size_t segmentSize);
+        Builder& withSyncInterval(std::chrono::milliseconds syncInterval);
+
+        // Creates the directory if needed, maps a new segment and starts
+        // syncing. Throws a std::invalid_argument if the segment size is
+        // out of range, or a std::runtime_error if the segment can't be
+        // created.
+        CommandJournalSharedPtr build() const;
+
+    private:
+        std::string directory;
+        size_t segmentSize = DEFAULT_SEGMENT_SIZE;
+        std::chrono::milliseconds syncInterval = DEFAULT_SYNC_INTERVAL;
+    };
+
+    // Journals a command; strings over JournalFormat::MAX_STRING_LENGTH are
+    // truncated. Records which can't be written, because a new segment
+    // couldn't be created, are dropped and counted.
+    void record(const std::string& clientAddress, uint16_t clientPort,
+            const std::string& command, const std::string& param,
+            const std::string& result, bool succeeded);
+
+    // Every record() call must have returned first
+    ~CommandJournal();
+
+    CommandJournal(const CommandJournal&) = delete;
+    CommandJournal& operator=(const CommandJournal&) = delete;
+
+    static const size_t DEFAULT_SEGMENT_SIZE;
+    static const size_t MIN_SEGMENT_SIZE;
+    static const size_t MAX_SEGMENT_SIZE;
+    static const std::chrono::milliseconds DEFAULT_SYNC_INTERVAL;
+
+private:
+    // A mapped segment file
+    struct Segment
+    {
+        uint64_t index = 0;
+        int fd = -1;
+        char* base = nullptr;
+
+        // The offset at which the first reservation which didn't fit
+        // started, i.e. where the segment's records end; NOT_SEALED until
+        // that reservation is made
+        std::atomic<uint64_t> sealedOffset;
+
+        // Bytes of the records written so far, including the header's; the
+        // segment can be unmapped once this reaches sealedOffset
+        std::atomic<uint64_t> writtenBytes;
+    };
+
+    CommandJournal(const std::string& directory, size_t segmentSize,
+            std::chrono::milliseconds syncInterval);
+
+    Segment* createSegment(uint64_t segmentIndex) const;
+    void releaseSegment(Segment* segment) const;
+    bool rotate(uint32_t fullGeneration);
+    void syncSegmentsLocked() const;
+    void syncLoop();
+
+    static uint64_t findNextSegmentIndex(const std::string& directory);
+    static uint64_t makeCursor(uint32_t generation, uint32_t offset);
+
+    // Two segments are mapped at a time: the current one, and the one
+    // before it, whose last records may still be being written. Indexed by
+    // generation.
+    static const size_t MAPPED_SEGMENTS = 2;
+
+    static const uint64_t NOT_SEALED;
+
+    static const MetricsRegistry::Counter RECORDS;
+    static const MetricsRegistry::Counter DROPPED_RECORDS;
+    static const MetricsRegistry::Counter SEGMENTS_CREATED;
+
+    const std::string directory;
+    const size_t segmentSize;
+    const std::chrono::milliseconds syncInterval;
+
+    // The generation (rotations since start) in the upper 32 bits, and the
+    // next write offset into its segment in the lower 32
+    std::atomic<uint64_t> cursor;
+
+    // Written under rotationMutex; read without it by writers, once their
+    // reservation shows the generation
+    std::atomic<Segment*> mappedSegments[MAPPED_SEGMENTS];
+
+    // Serializes rotations, syncs and unmapping. Writers which overflowed
+    // the current segment wait on it for the rotation.
+    std::mutex rotationMutex;
+    uint32_t generation = 0;
+    uint64_t nextSegmentIndex;
+    bool rotationFailed = false;
+
+    std::mutex syncMutex;
+    std::condition_variable syncWakeup;
+    bool stopSyncing = false;
+    std::thread syncThread;
+};
+
+#endif /* JOURNAL_COMMANDJOURNAL_HPP_ */
@@ -0,0 +1,67 @@
+/*
+ * JournalFormat.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+// System Includes
+#include <cctype>
+#include <cstdio>
+
+// Project Includes
+#include "JournalFormat.hpp"
+
+// Static initialization
+const uint32_t JournalFormat::MAGIC = 0x4a43534e; // "NSCJ"
+const uint32_t JournalFormat::VERSION = 1;
+const uint32_t JournalFormat::COMMITTED = 0x54494d43; // "CMIT"
+const size_t JournalFormat::MAX_STRING_LENGTH = 1024;
+const size_t JournalFormat::RECORD_ALIGNMENT = 8;
+
+static const char SEGMENT_FILE_PREFIX[] = "journal-";
+static const char SEGMENT_FILE_SUFFIX[] = ".seg";
+static const size_t SEGMENT_INDEX_DIGITS = 10;
+
+size_t JournalFormat::getRecordLength(size_t stringsLength)
+{
+    size_t unpaddedLength = sizeof(RecordHeader) + stringsLength;
+    return (unpaddedLength + RECORD_ALIGNMENT - 1) / RECORD_ALIGNMENT * RECORD_ALIGNMENT;
+}
+
+/**
+ * Indexes are zero padded, so segments sort by name in the order they were
+ * written
+ */
+std::string JournalFormat::getSegmentFileName(uint64_t segmentIndex)
+{
+    char indexStr[32];
+    std::snprintf(indexStr, sizeof(indexStr), "%0*llu", static_cast<int>(SEGMENT_INDEX_DIGITS),
+            static_cast<unsigned long long>(segmentIndex));
+    return SEGMENT_FILE_PREFIX + std::string(indexStr) + SEGMENT_FILE_SUFFIX;
+}
+
+bool JournalFormat::parseSegmentFileName(const std::string& fileName, uint64_t& segmentIndex)
+{
+    const std::string prefix = SEGMENT_FILE_PREFIX;
+    const std::string suffix = SEGMENT_FILE_SUFFIX;
+    if (fileName.length() != prefix.length() + SEGMENT_INDEX_DIGITS + suffix.length() ||
+            fileName.compare(0, prefix.length(), prefix) != 0 ||
+            fileName.compare(fileName.length() - suffix.length(), suffix.length(), suffix) != 0)
+    {
+        return false;
+    }
+
+    uint64_t index = 0;
+    for (size_t charIdx = prefix.length(); charIdx < prefix.length() + SEGMENT_INDEX_DIGITS; ++charIdx)
+    {
+        if (!std::isdigit(static_cast<unsigned char>(fileName[charIdx])))
+        {
+            return false;
+        }
+        index = index * 10 + static_cast<uint64_t>(fileName[charIdx] - '0');
+    }
+
+    segmentIndex = index;
+    return true;
+}
@@ -0,0 +1,82 @@
+/*
+ * JournalFormat.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+#ifndef JOURNAL_JOURNALFORMAT_HPP_
+#define JOURNAL_JOURNALFORMAT_HPP_
+
+// System Includes
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Project Includes
+// <none>
+
+/**
+ * The on-disk layout of the command journal, shared by CommandJournal and
+ * the offline dump tool. A journal is a directory of fixed-size segment
+ * files, named by their index, e.g. "journal-0000000003.seg". Each segment
+ * starts with a SegmentHeader and is followed by records, packed on 8 byte
+ * boundaries. A record is a RecordHeader followed by its strings, unpadded
+ * and without terminators: client address, command, parameter and result.
+ *
+ * Space for a record is reserved before anything is written to it; its
+ * length is stored next, and its committed field last. A writer which
+ * stopped after storing the length leaves a record which can be skipped by
+ * its length. One which stopped before leaves a gap of zeroes, as segments
+ * are preallocated, so a reader which finds a length of 0 must scan
+ * forward, on RECORD_ALIGNMENT boundaries, for the next committed record;
+ * if there's none, the segment's records have ended. All fields are in
+ * host byte order.
+ */
+class JournalFormat
+{
+public:
+    struct SegmentHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t segmentSize;
+        uint64_t segmentIndex;
+        int64_t createdNs;
+        uint64_t reserved[4];
+    };
+
+    struct RecordHeader
+    {
+        uint32_t length;
+        uint32_t committed;
+        int64_t timestampNs;
+        uint16_t clientPort;
+        uint16_t clientAddressLength;
+        uint16_t commandLength;
+        uint16_t paramLength;
+        uint16_t resultLength;
+        uint8_t succeeded;
+        uint8_t reserved[5];
+    };
+
+    // The length of a record with strings of the given total length
+    static size_t getRecordLength(size_t stringsLength);
+
+    static std::string getSegmentFileName(uint64_t segmentIndex);
+
+    // Returns false unless fileName is a segment's
+    static bool parseSegmentFileName(const std::string& fileName, uint64_t& segmentIndex);
+
+    static const uint32_t MAGIC;
+    static const uint32_t VERSION;
+    static const uint32_t COMMITTED;
+
+    // Longer strings are truncated
+    static const size_t MAX_STRING_LENGTH;
+
+    // Records start on multiples of this
+    static const size_t RECORD_ALIGNMENT;
+};
+
+#endif /* JOURNAL_JOURNALFORMAT_HPP_ */
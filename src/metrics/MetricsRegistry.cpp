@@ -0,0 +1,349 @@
+/*
+ * MetricsRegistry.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+// System Includes
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+
+// Project Includes
+#include "MetricsRegistry.hpp"
+
+// Static initialization
+const size_t MetricsRegistry::MAX_COUNTERS;
+const size_t MetricsRegistry::MAX_HISTOGRAMS;
+const size_t MetricsRegistry::LINEAR_BUCKET_BITS;
+const size_t MetricsRegistry::SUB_BUCKET_BITS;
+const size_t MetricsRegistry::MAX_VALUE_BITS;
+const size_t MetricsRegistry::BUCKET_COUNT;
+
+namespace
+{
+
+// An update by the owning thread; no other thread writes cell, so no
+// read-modify-write instruction is needed
+inline void addToCell(std::atomic<uint64_t>& cell, uint64_t amount)
+{
+    cell.store(cell.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+}
+
+void MetricsRegistry::Counter::increment(uint64_t amount) const
+{
+    addToCell(getThreadShard().counters[counterIdx], amount);
+}
+
+void MetricsRegistry::Histogram::record(uint64_t value) const
+{
+    HistogramCells& cells = getThreadShard().histograms[histogramIdx];
+
+    addToCell(cells.count, 1);
+    addToCell(cells.sum, value);
+    addToCell(cells.buckets[getBucketIdx(value)], 1);
+    if (value > cells.max.load(std::memory_order_relaxed))
+    {
+        cells.max.store(value, std::memory_order_relaxed);
+    }
+}
+
+MetricsRegistry::ScopedTimer::ScopedTimer(const Histogram& histogram):
+        histogram(histogram), startTime(std::chrono::steady_clock::now())
+{
+}
+
+MetricsRegistry::ScopedTimer::~ScopedTimer()
+{
+    histogram.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - startTime).count()));
+}
+
+/**
+ * Walks the buckets until fraction of the values are covered, and reports
+ * the top of that bucket
+ */
+uint64_t MetricsRegistry::HistogramSnapshot::getPercentile(double fraction) const
+{
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(std::ceil(fraction * count));
+    rank = std::max<uint64_t>(1, std::min(rank, count));
+
+    uint64_t seen = 0;
+    for (size_t bucketIdx = 0; bucketIdx < bucketCounts.size(); ++bucketIdx)
+    {
+        seen += bucketCounts[bucketIdx];
+        if (seen >= rank)
+        {
+            return std::min(getBucketUpperBound(bucketIdx) - 1, max);
+        }
+    }
+    return max;
+}
+
+/**
+ * Never destroyed, so that threads still running during exit can keep
+ * updating their shards
+ */
+MetricsRegistry& MetricsRegistry::getInstance()
+{
+    static MetricsRegistry* instance = new MetricsRegistry();
+    return *instance;
+}
+
+MetricsRegistry::Counter MetricsRegistry::registerCounter(const std::string& name,
+        const std::string& help, const std::string& labels)
+{
+    std::lock_guard<std::mutex> registryLock{registryMutex};
+
+    for (size_t counterIdx = 0; counterIdx < counterInfos.size(); ++counterIdx)
+    {
+        if (counterInfos[counterIdx].name == name && counterInfos[counterIdx].labels == labels)
+        {
+            return Counter(static_cast<uint32_t>(counterIdx));
+        }
+    }
+
+    if (counterInfos.size() == MAX_COUNTERS)
+    {
+        throw std::length_error("Unable to register counter: " + name +
+                "; the maximum of " + std::to_string(MAX_COUNTERS) + " is registered");
+    }
+
+    counterInfos.push_back(MetricInfo{name, labels, help});
+    return Counter(static_cast<uint32_t>(counterInfos.size() - 1));
+}
+
+MetricsRegistry::Histogram MetricsRegistry::registerHistogram(const std::string& name,
+        const std::string& help, const std::string& labels)
+{
+    std::lock_guard<std::mutex> registryLock{registryMutex};
+
+    for (size_t histogramIdx = 0; histogramIdx < histogramInfos.size(); ++histogramIdx)
+    {
+        if (histogramInfos[histogramIdx].name == name &&
+                histogramInfos[histogramIdx].labels == labels)
+        {
+            return Histogram(static_cast<uint32_t>(histogramIdx));
+        }
+    }
+
+    if (histogramInfos.size() == MAX_HISTOGRAMS)
+    {
+        throw std::length_error("Unable to register histogram: " + name +
+                "; the maximum of " + std::to_string(MAX_HISTOGRAMS) + " is registered");
+    }
+
+    histogramInfos.push_back(MetricInfo{name, labels, help});
+    return Histogram(static_cast<uint32_t>(histogramInfos.size() - 1));
+}
+
+/**
+ * Sums the retired totals and every live shard. Live shards are read while
+ * their threads may be updating them, so a snapshot isn't an atomic cut
+ * across metrics, but each value is one which was actually reached.
+ */
+MetricsRegistry::Snapshot MetricsRegistry::takeSnapshot()
+{
+    std::lock_guard<std::mutex> registryLock{registryMutex};
+
+    Snapshot snapshot;
+    snapshot.takenAt = std::chrono::system_clock::now();
+
+    for (const MetricInfo& info : counterInfos)
+    {
+        snapshot.counters.push_back(CounterSnapshot{info, 0});
+    }
+    for (const MetricInfo& info : histogramInfos)
+    {
+        snapshot.histograms.push_back(HistogramSnapshot{info, 0, 0, 0,
+                std::vector<uint64_t>(BUCKET_COUNT, 0)});
+    }
+
+    auto addFromShard = [&snapshot](const ThreadShard& shard)
+    {
+        for (size_t counterIdx = 0; counterIdx < snapshot.counters.size(); ++counterIdx)
+        {
+            snapshot.counters[counterIdx].value +=
+                    shard.counters[counterIdx].load(std::memory_order_relaxed);
+        }
+
+        for (size_t histogramIdx = 0; histogramIdx < snapshot.histograms.size(); ++histogramIdx)
+        {
+            const HistogramCells& cells = shard.histograms[histogramIdx];
+            HistogramSnapshot& histogram = snapshot.histograms[histogramIdx];
+
+            histogram.count += cells.count.load(std::memory_order_relaxed);
+            histogram.sum += cells.sum.load(std::memory_order_relaxed);
+            histogram.max = std::max(histogram.max, cells.max.load(std::memory_order_relaxed));
+            for (size_t bucketIdx = 0; bucketIdx < BUCKET_COUNT; ++bucketIdx)
+            {
+                histogram.bucketCounts[bucketIdx] +=
+                        cells.buckets[bucketIdx].load(std::memory_order_relaxed);
+            }
+        }
+    };
+
+    addFromShard(*retiredTotals);
+    for (const ThreadShard* shard : liveShards)
+    {
+        addFromShard(*shard);
+    }
+
+    return snapshot;
+}
+
+/**
+ * Values below 2^LINEAR_BUCKET_BITS map directly onto a bucket. Above that,
+ * the position of the highest set bit picks a power of two, and the
+ * SUB_BUCKET_BITS bits beneath it pick one of its sub buckets.
+ */
+size_t MetricsRegistry::getBucketIdx(uint64_t value)
+{
+    if (value < (1u << LINEAR_BUCKET_BITS))
+    {
+        return static_cast<size_t>(value);
+    }
+
+    size_t highestBit = 63 - static_cast<size_t>(__builtin_clzll(value));
+    if (highestBit >= MAX_VALUE_BITS)
+    {
+        return BUCKET_COUNT - 1;
+    }
+
+    size_t subBucket = static_cast<size_t>(value >> (highestBit - SUB_BUCKET_BITS)) &
+            ((1u << SUB_BUCKET_BITS) - 1);
+    return (1u << LINEAR_BUCKET_BITS) +
+            (highestBit - LINEAR_BUCKET_BITS) * (1u << SUB_BUCKET_BITS) + subBucket;
+}
+
+uint64_t MetricsRegistry::getBucketLowerBound(size_t bucketIdx)
+{
+    if (bucketIdx < (1u << LINEAR_BUCKET_BITS))
+    {
+        return bucketIdx;
+    }
+
+    size_t logIdx = bucketIdx - (1u << LINEAR_BUCKET_BITS);
+    size_t highestBit = LINEAR_BUCKET_BITS + logIdx / (1u << SUB_BUCKET_BITS);
+    uint64_t subBucket = logIdx % (1u << SUB_BUCKET_BITS);
+    return ((1ull << SUB_BUCKET_BITS) | subBucket) << (highestBit - SUB_BUCKET_BITS);
+}
+
+/**
+ * Exclusive; the last bucket's is nominal, since it also counts everything
+ * beyond it
+ */
+uint64_t MetricsRegistry::getBucketUpperBound(size_t bucketIdx)
+{
+    if (bucketIdx < (1u << LINEAR_BUCKET_BITS))
+    {
+        return bucketIdx + 1;
+    }
+
+    size_t logIdx = bucketIdx - (1u << LINEAR_BUCKET_BITS);
+    size_t highestBit = LINEAR_BUCKET_BITS + logIdx / (1u << SUB_BUCKET_BITS);
+    return getBucketLowerBound(bucketIdx) + (1ull << (highestBit - SUB_BUCKET_BITS));
+}
+
+MetricsRegistry::ShardOwner::ShardOwner(): shard(allocateShard())
+{
+    MetricsRegistry& registry = getInstance();
+    std::lock_guard<std::mutex> registryLock{registry.registryMutex};
+    registry.liveShards.push_back(shard);
+}
+
+MetricsRegistry::ShardOwner::~ShardOwner()
+{
+    getInstance().retireShard(shard);
+}
+
+MetricsRegistry::ThreadShard& MetricsRegistry::getThreadShard()
+{
+    static thread_local ShardOwner owner;
+    return *owner.shard;
+}
+
+/**
+ * Shards are over-aligned, which plain new doesn't honour before C++17
+ */
+MetricsRegistry::ThreadShard* MetricsRegistry::allocateShard()
+{
+    void* memory = nullptr;
+    if (posix_memalign(&memory, alignof(ThreadShard), sizeof(ThreadShard)) != 0)
+    {
+        throw std::bad_alloc();
+    }
+
+    ThreadShard* shard = new (memory) ThreadShard;
+    for (std::atomic<uint64_t>& counter : shard->counters)
+    {
+        counter.store(0, std::memory_order_relaxed);
+    }
+    for (HistogramCells& cells : shard->histograms)
+    {
+        cells.count.store(0, std::memory_order_relaxed);
+        cells.sum.store(0, std::memory_order_relaxed);
+        cells.max.store(0, std::memory_order_relaxed);
+        for (std::atomic<uint64_t>& bucket : cells.buckets)
+        {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+    return shard;
+}
+
+void MetricsRegistry::freeShard(ThreadShard* shard)
+{
+    shard->~ThreadShard();
+    free(shard);
+}
+
+void MetricsRegistry::addShard(ThreadShard& target, const ThreadShard& source)
+{
+    for (size_t counterIdx = 0; counterIdx < MAX_COUNTERS; ++counterIdx)
+    {
+        addToCell(target.counters[counterIdx],
+                source.counters[counterIdx].load(std::memory_order_relaxed));
+    }
+
+    for (size_t histogramIdx = 0; histogramIdx < MAX_HISTOGRAMS; ++histogramIdx)
+    {
+        HistogramCells& targetCells = target.histograms[histogramIdx];
+        const HistogramCells& sourceCells = source.histograms[histogramIdx];
+
+        addToCell(targetCells.count, sourceCells.count.load(std::memory_order_relaxed));
+        addToCell(targetCells.sum, sourceCells.sum.load(std::memory_order_relaxed));
+        targetCells.max.store(std::max(targetCells.max.load(std::memory_order_relaxed),
+                sourceCells.max.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+        for (size_t bucketIdx = 0; bucketIdx < BUCKET_COUNT; ++bucketIdx)
+        {
+            addToCell(targetCells.buckets[bucketIdx],
+                    sourceCells.buckets[bucketIdx].load(std::memory_order_relaxed));
+        }
+    }
+}
+
+/**
+ * Folds an exiting thread's shard into retiredTotals, so that its counts
+ * outlive it
+ */
+void MetricsRegistry::retireShard(ThreadShard* shard)
+{
+    {
+        std::lock_guard<std::mutex> registryLock{registryMutex};
+        addShard(*retiredTotals, *shard);
+        liveShards.erase(std::remove(liveShards.begin(), liveShards.end(), shard),
+                liveShards.end());
+    }
+    freeShard(shard);
+}
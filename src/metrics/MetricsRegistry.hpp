@@ -0,0 +1,196 @@
+/*
+ * MetricsRegistry.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+#ifndef METRICS_METRICSREGISTRY_HPP_
+#define METRICS_METRICSREGISTRY_HPP_
+
+// System Includes
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Project Includes
+// <none>
+
+/**
+ * The process-wide registry of counters and histograms.
+ *
+ * Metrics are registered once, normally during static initialization, and
+ * the returned handles are then updated from any thread. Each thread
+ * updates its own ThreadShard, a cache-line aligned block which no other
+ * thread writes, so an update is a plain load and store with no locked
+ * instruction and no cache line shared with other threads. Shards are
+ * merged when a snapshot is taken; a thread's shard is folded into the
+ * retired totals when the thread exits.
+ *
+ * Histograms are HDR-style: values below 2^LINEAR_BUCKET_BITS get a bucket
+ * each, and every power of two above that is split into 2^SUB_BUCKET_BITS
+ * equal buckets, bounding the relative error of a reported percentile by
+ * 2^-SUB_BUCKET_BITS.
+ */
+class MetricsRegistry
+{
+public:
+    class Counter
+    {
+    public:
+        void increment(uint64_t amount = 1) const;
+
+    private:
+        friend class MetricsRegistry;
+        explicit Counter(uint32_t counterIdx) : counterIdx(counterIdx) {};
+
+        uint32_t counterIdx;
+    };
+
+    class Histogram
+    {
+    public:
+        void record(uint64_t value) const;
+
+    private:
+        friend class MetricsRegistry;
+        explicit Histogram(uint32_t histogramIdx) : histogramIdx(histogramIdx) {};
+
+        uint32_t histogramIdx;
+    };
+
+    // Records the microseconds between its construction and destruction
+    // into a Histogram
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(const Histogram& histogram);
+        ~ScopedTimer();
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    private:
+        const Histogram& histogram;
+        const std::chrono::steady_clock::time_point startTime;
+    };
+
+    // Identifies a metric. labels is empty, or Prometheus style label pairs
+    // without the braces, e.g. command="VOLUME"
+    struct MetricInfo
+    {
+        std::string name;
+        std::string labels;
+        std::string help;
+    };
+
+    struct CounterSnapshot
+    {
+        MetricInfo info;
+        uint64_t value;
+    };
+
+    struct HistogramSnapshot
+    {
+        MetricInfo info;
+        uint64_t count;
+        uint64_t sum;
+        uint64_t max;
+
+        // One count per bucket; see getBucketLowerBound()
+        std::vector<uint64_t> bucketCounts;
+
+        // The smallest value which at least fraction (0-1) of the recorded
+        // values are at or below, to within a bucket's width
+        uint64_t getPercentile(double fraction) const;
+    };
+
+    struct Snapshot
+    {
+        std::chrono::system_clock::time_point takenAt;
+        std::vector<CounterSnapshot> counters;
+        std::vector<HistogramSnapshot> histograms;
+    };
+
+    static MetricsRegistry& getInstance();
+
+    // Registering a name and labels which are already registered returns
+    // the existing metric. Throws a std::length_error if MAX_COUNTERS or
+    // MAX_HISTOGRAMS metrics already exist.
+    Counter registerCounter(const std::string& name, const std::string& help,
+            const std::string& labels = "");
+    Histogram registerHistogram(const std::string& name, const std::string& help,
+            const std::string& labels = "");
+
+    // Merges every thread's values
+    Snapshot takeSnapshot();
+
+    // Histogram bucket layout
+    static size_t getBucketIdx(uint64_t value);
+    static uint64_t getBucketLowerBound(size_t bucketIdx);
+    static uint64_t getBucketUpperBound(size_t bucketIdx);
+
+    static const size_t MAX_COUNTERS = 128;
+    static const size_t MAX_HISTOGRAMS = 16;
+    static const size_t LINEAR_BUCKET_BITS = 4;
+    static const size_t SUB_BUCKET_BITS = 3;
+
+    // Values from 2^MAX_VALUE_BITS on are counted in the last bucket
+    static const size_t MAX_VALUE_BITS = 36;
+    static const size_t BUCKET_COUNT = (1u << LINEAR_BUCKET_BITS) +
+            (MAX_VALUE_BITS - LINEAR_BUCKET_BITS) * (1u << SUB_BUCKET_BITS);
+
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+private:
+    MetricsRegistry() {};
+
+    // Written only by the thread which owns it (or, once retired, under
+    // registryMutex), and read by takeSnapshot(); relaxed atomics keep those
+    // reads well defined without any locked instructions
+    struct HistogramCells
+    {
+        std::atomic<uint64_t> count;
+        std::atomic<uint64_t> sum;
+        std::atomic<uint64_t> max;
+        std::atomic<uint64_t> buckets[BUCKET_COUNT];
+    };
+    struct alignas(64) ThreadShard
+    {
+        std::atomic<uint64_t> counters[MAX_COUNTERS];
+        HistogramCells histograms[MAX_HISTOGRAMS];
+    };
+
+    // Owns the calling thread's shard, which it registers on construction
+    // and retires on destruction
+    class ShardOwner
+    {
+    public:
+        ShardOwner();
+        ~ShardOwner();
+
+        ThreadShard* const shard;
+    };
+
+    static ThreadShard& getThreadShard();
+    static ThreadShard* allocateShard();
+    static void freeShard(ThreadShard* shard);
+    static void addShard(ThreadShard& target, const ThreadShard& source);
+
+    void retireShard(ThreadShard* shard);
+
+    // Guards everything below, though not the contents of liveShards
+    std::mutex registryMutex;
+    std::vector<MetricInfo> counterInfos;
+    std::vector<MetricInfo> histogramInfos;
+    std::vector<ThreadShard*> liveShards;
+
+    // The totals of every thread which has exited
+    ThreadShard* retiredTotals = allocateShard();
+};
+
+#endif /* METRICS_METRICSREGISTRY_HPP_ */
@@ -0,0 +1,283 @@
+/*
+ * RequestTracer.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+// System Includes
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Project Includes
+#include "RequestTracer.hpp"
+
+// Static initialization
+const size_t RequestTracer::MARK_COUNT;
+const size_t RequestTracer::RING_CAPACITY;
+const size_t RequestTracer::RETIRED_RING_CAPACITY;
+
+thread_local RequestTracer::TraceRecord* RequestTracer::activeRecord = nullptr;
+
+namespace
+{
+
+int64_t getSteadyNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}
+
+/**
+ * Never destroyed, so that threads still running during exit can keep
+ * tracing
+ */
+RequestTracer& RequestTracer::getInstance()
+{
+    static RequestTracer* instance = new RequestTracer();
+    return *instance;
+}
+
+void RequestTracer::setSampleInterval(uint32_t sampleInterval)
+{
+    this->sampleInterval.store(sampleInterval, std::memory_order_relaxed);
+}
+
+uint32_t RequestTracer::getSampleInterval() const
+{
+    return sampleInterval.load(std::memory_order_relaxed);
+}
+
+/**
+ * Decides whether the request the calling thread is about to serve is
+ * traced, and if so, starts its trace
+ */
+void RequestTracer::beginRequest()
+{
+    RequestTracer& tracer = getInstance();
+    uint32_t sampleInterval = tracer.sampleInterval.load(std::memory_order_relaxed);
+
+    if (sampleInterval == 0 || !shouldSample(sampleInterval))
+    {
+        activeRecord = nullptr;
+        return;
+    }
+
+    TraceRecord& record = getRingOwner().tracedRecord;
+    record.requestId = tracer.nextRequestId.fetch_add(1, std::memory_order_relaxed);
+    record.threadId = static_cast<pid_t>(syscall(SYS_gettid));
+    record.command[0] = '\0';
+    std::fill(std::begin(record.marksNs), std::end(record.marksNs), 0);
+    activeRecord = &record;
+}
+
+void RequestTracer::mark(Mark traceMark)
+{
+    if (activeRecord)
+    {
+        activeRecord->marksNs[static_cast<size_t>(traceMark)] = getSteadyNs();
+    }
+}
+
+void RequestTracer::setCommand(const std::string& command)
+{
+    if (activeRecord)
+    {
+        size_t copiedLength = std::min(command.length(), sizeof(activeRecord->command) - 1);
+        command.copy(activeRecord->command, copiedLength);
+        activeRecord->command[copiedLength] = '\0';
+    }
+}
+
+/**
+ * Moves the finished trace into the calling thread's ring
+ */
+void RequestTracer::endRequest()
+{
+    if (!activeRecord)
+    {
+        return;
+    }
+
+    RingOwner& owner = getRingOwner();
+    {
+        std::lock_guard<std::mutex> ringLock{owner.ringMutex};
+        owner.ring.push(*activeRecord, RING_CAPACITY);
+    }
+    activeRecord = nullptr;
+}
+
+/**
+ * Each traced request is rendered as a complete ("X") event spanning from
+ * its arrival to the end of its response, named after its command, with an
+ * event for each stage nested beneath it. The receive stage precedes the
+ * request, since it includes waiting for the client to send it.
+ */
+std::string RequestTracer::renderChromeTrace()
+{
+    std::vector<TraceRecord> allRecords;
+    {
+        std::lock_guard<std::mutex> tracerLock{tracerMutex};
+
+        retiredRing.appendTo(allRecords);
+        for (RingOwner* owner : liveOwners)
+        {
+            std::lock_guard<std::mutex> ringLock{owner->ringMutex};
+            owner->ring.appendTo(allRecords);
+        }
+    }
+
+    std::string rendered = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    for (const TraceRecord& record : allRecords)
+    {
+        appendStage(rendered, record.command[0] ? record.command : "(unparsed)", record,
+                Mark::RECEIVE_END, Mark::SEND_END);
+        appendStage(rendered, "receive", record, Mark::RECEIVE_START, Mark::RECEIVE_END);
+        appendStage(rendered, "parse", record, Mark::PARSE_START, Mark::PARSE_END);
+        appendStage(rendered, "dispatch", record, Mark::PARSE_END, Mark::HANDLER_START);
+        appendStage(rendered, "handler", record, Mark::HANDLER_START, Mark::HANDLER_END);
+        appendStage(rendered, "send", record, Mark::SEND_START, Mark::SEND_END);
+    }
+
+    // Drop the trailing comma, if there are any events
+    if (rendered.back() == ',')
+    {
+        rendered.pop_back();
+    }
+    rendered.append("]}");
+
+    return rendered;
+}
+
+void RequestTracer::writeChromeTrace(const std::string& path)
+{
+    const std::string rendered = renderChromeTrace();
+    const std::string tempPath = path + ".tmp";
+
+    FILE* traceFile = std::fopen(tempPath.c_str(), "w");
+    if (!traceFile)
+    {
+        throw std::runtime_error("Unable to open trace file: " + tempPath + "; " +
+                std::strerror(errno));
+    }
+
+    bool written = std::fwrite(rendered.data(), 1, rendered.length(), traceFile) ==
+            rendered.length();
+    written = (std::fclose(traceFile) == 0) && written;
+    if (!written || std::rename(tempPath.c_str(), path.c_str()) != 0)
+    {
+        int writeErrno = errno;
+        std::remove(tempPath.c_str());
+        throw std::runtime_error("Unable to write trace file: " + path + "; " +
+                std::strerror(writeErrno));
+    }
+}
+
+void RequestTracer::TraceRing::push(const TraceRecord& record, size_t capacity)
+{
+    if (records.size() < capacity)
+    {
+        records.push_back(record);
+        return;
+    }
+
+    records[nextIdx] = record;
+    nextIdx = (nextIdx + 1) % capacity;
+}
+
+void RequestTracer::TraceRing::appendTo(std::vector<TraceRecord>& allRecords) const
+{
+    allRecords.insert(allRecords.end(), records.begin() + nextIdx, records.end());
+    allRecords.insert(allRecords.end(), records.begin(), records.begin() + nextIdx);
+}
+
+RequestTracer::RingOwner::RingOwner()
+{
+    RequestTracer& tracer = getInstance();
+    std::lock_guard<std::mutex> tracerLock{tracer.tracerMutex};
+    tracer.liveOwners.push_back(this);
+}
+
+/**
+ * Folds this thread's traces into the retired ring, so that they outlive it
+ */
+RequestTracer::RingOwner::~RingOwner()
+{
+    RequestTracer& tracer = getInstance();
+    std::lock_guard<std::mutex> tracerLock{tracer.tracerMutex};
+
+    std::vector<TraceRecord> ownRecords;
+    ring.appendTo(ownRecords);
+    for (const TraceRecord& record : ownRecords)
+    {
+        tracer.retiredRing.push(record, RETIRED_RING_CAPACITY);
+    }
+
+    tracer.liveOwners.erase(std::remove(tracer.liveOwners.begin(), tracer.liveOwners.end(), this),
+            tracer.liveOwners.end());
+}
+
+/**
+ * Constructed on a thread's first sampled request, so threads which never
+ * trace don't register a ring
+ */
+RequestTracer::RingOwner& RequestTracer::getRingOwner()
+{
+    static thread_local RingOwner owner;
+    return owner;
+}
+
+/**
+ * A per-thread xorshift generator, so that sampling needs no shared state
+ * and isn't skewed by short-lived connections
+ */
+bool RequestTracer::shouldSample(uint32_t sampleInterval)
+{
+    static thread_local uint64_t randomState = 0;
+
+    if (randomState == 0)
+    {
+        randomState = static_cast<uint64_t>(getSteadyNs()) ^
+                (static_cast<uint64_t>(syscall(SYS_gettid)) << 32) ^ 0x9e3779b97f4a7c15ull;
+    }
+
+    randomState ^= randomState << 13;
+    randomState ^= randomState >> 7;
+    randomState ^= randomState << 17;
+
+    return randomState % sampleInterval == 0;
+}
+
+/**
+ * Appends a complete event spanning startMark to endMark, unless the
+ * request didn't reach both of them
+ */
+void RequestTracer::appendStage(std::string& rendered, const char* name,
+        const TraceRecord& record, Mark startMark, Mark endMark)
+{
+    int64_t startNs = record.marksNs[static_cast<size_t>(startMark)];
+    int64_t endNs = record.marksNs[static_cast<size_t>(endMark)];
+    if (startNs == 0 || endNs < startNs)
+    {
+        return;
+    }
+
+    char event[256] = {};
+    std::snprintf(event, sizeof(event),
+            "{\"name\":\"%s\",\"cat\":\"request\",\"ph\":\"X\",\"ts\":%lld.%03lld,"
+            "\"dur\":%lld.%03lld,\"pid\":%d,\"tid\":%d,\"args\":{\"request_id\":%llu}},",
+            name, static_cast<long long>(startNs / 1000), static_cast<long long>(startNs % 1000),
+            static_cast<long long>((endNs - startNs) / 1000),
+            static_cast<long long>((endNs - startNs) % 1000),
+            static_cast<int>(getpid()), static_cast<int>(record.threadId),
+            static_cast<unsigned long long>(record.requestId));
+    rendered.append(event);
+}
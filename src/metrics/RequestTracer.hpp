@@ -0,0 +1,142 @@
+/*
+ * RequestTracer.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+#ifndef METRICS_REQUESTTRACER_HPP_
+#define METRICS_REQUESTTRACER_HPP_
+
+// System Includes
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+// Project Includes
+// <none>
+
+/**
+ * Samples client requests and records a monotonic timestamp as each passes
+ * through the stages of being served, so that a slow command can be broken
+ * down into time spent receiving, parsing, dispatching, in its handler and
+ * sending the response.
+ *
+ * A request is traced by the thread which serves it from end to end: the
+ * thread calls beginRequest(), marks each stage boundary, and endRequest()
+ * copies the finished trace into the thread's own ring buffer. Requests
+ * which aren't sampled cost a thread local check per mark. The rings of
+ * exited threads are folded into a shared ring, so their traces can still
+ * be dumped.
+ *
+ * Dumps are in the Chrome trace event format, loadable by chrome://tracing
+ * or Perfetto.
+ */
+class RequestTracer
+{
+public:
+    // The stage boundaries of a request, in the order they're reached
+    enum class Mark : size_t
+    {
+        RECEIVE_START,
+        RECEIVE_END,
+        PARSE_START,
+        PARSE_END,
+        HANDLER_START,
+        HANDLER_END,
+        SEND_START,
+        SEND_END
+    };
+
+    static RequestTracer& getInstance();
+
+    // Traces 1 in sampleInterval requests, chosen at random; 0 traces none
+    void setSampleInterval(uint32_t sampleInterval);
+    uint32_t getSampleInterval() const;
+
+    // Called by the thread serving a request. mark() and setCommand() do
+    // nothing unless beginRequest() chose to sample the request.
+    static void beginRequest();
+    static void mark(Mark traceMark);
+    static void setCommand(const std::string& command);
+    static void endRequest();
+
+    // Renders every buffered trace, oldest first per thread
+    std::string renderChromeTrace();
+
+    // Renders every buffered trace to path, replacing it atomically.
+    // Throws a std::runtime_error if the file can't be written.
+    void writeChromeTrace(const std::string& path);
+
+    static const size_t MARK_COUNT = 8;
+
+    // Traces kept per live thread, and for all exited threads together
+    static const size_t RING_CAPACITY = 512;
+    static const size_t RETIRED_RING_CAPACITY = 4096;
+
+    RequestTracer(const RequestTracer&) = delete;
+    RequestTracer& operator=(const RequestTracer&) = delete;
+
+private:
+    RequestTracer() {};
+
+    struct TraceRecord
+    {
+        uint64_t requestId;
+        pid_t threadId;
+
+        // NUL terminated, and truncated if need be
+        char command[24];
+
+        // Nanoseconds on the steady clock; 0 for marks which weren't reached
+        int64_t marksNs[MARK_COUNT];
+    };
+
+    // Overwrites its oldest record once full
+    struct TraceRing
+    {
+        void push(const TraceRecord& record, size_t capacity);
+        void appendTo(std::vector<TraceRecord>& allRecords) const;
+
+        std::vector<TraceRecord> records;
+        size_t nextIdx = 0;
+    };
+
+    // Owns the calling thread's ring, which it registers on construction
+    // and retires on destruction
+    class RingOwner
+    {
+    public:
+        RingOwner();
+        ~RingOwner();
+
+        // Guards ring against renderChromeTrace()
+        std::mutex ringMutex;
+        TraceRing ring;
+
+        // The request being traced; only accessed by the owning thread
+        TraceRecord tracedRecord;
+    };
+
+    // Points into the calling thread's RingOwner while it traces a request,
+    // and is nullptr otherwise
+    static thread_local TraceRecord* activeRecord;
+
+    static RingOwner& getRingOwner();
+    static bool shouldSample(uint32_t sampleInterval);
+    static void appendStage(std::string& rendered, const char* name, const TraceRecord& record,
+            Mark startMark, Mark endMark);
+
+    std::atomic<uint32_t> sampleInterval{0};
+    std::atomic<uint64_t> nextRequestId{1};
+
+    // Guards everything below, though not the rings of liveOwners
+    std::mutex tracerMutex;
+    std::vector<RingOwner*> liveOwners;
+    TraceRing retiredRing;
+};
+
+#endif /* METRICS_REQUESTTRACER_HPP_ */
@@ -0,0 +1,283 @@
+/*
+ * PrometheusExporter.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+// System Includes
+#include <boost/asio.hpp>
+#include <iostream>
+#include <istream>
+#include <unordered_map>
+#include <vector>
+
+// Project Includes
+#include "PrometheusExporter.hpp"
+
+// Static initialization
+const uint16_t PrometheusExporter::DEFAULT_PORT;
+const std::chrono::milliseconds PrometheusExporter::DEFAULT_REFRESH_INTERVAL = std::chrono::seconds(5);
+const size_t PrometheusExporter::MAX_REQUEST_LENGTH = 8192;
+const std::chrono::seconds PrometheusExporter::SCRAPE_TIMEOUT = std::chrono::seconds(5);
+
+const MetricsRegistry::Counter PrometheusExporter::SCRAPES =
+        MetricsRegistry::getInstance().registerCounter("netsysctrld_metrics_scrapes_total",
+        "Requests served by the Prometheus exporter");
+
+/**
+ * One HTTP request: read the request head, answer, close. Kept alive by the
+ * shared_ptrs bound into its pending handlers.
+ */
+class PrometheusExporter::ScrapeSession : public std::enable_shared_from_this<ScrapeSession>
+{
+public:
+    ScrapeSession(boost::asio::io_service& ioService, const PrometheusExporter& exporter):
+            socket(ioService), request(MAX_REQUEST_LENGTH), deadline(ioService),
+            exporter(exporter)
+    {
+    }
+
+    void start()
+    {
+        auto self = shared_from_this();
+
+        deadline.expires_from_now(SCRAPE_TIMEOUT);
+        deadline.async_wait([self](const boost::system::error_code& error)
+        {
+            if (!error)
+            {
+                boost::system::error_code ignored;
+                self->socket.close(ignored);
+            }
+        });
+
+        boost::asio::async_read_until(socket, request, "\r\n\r\n",
+                [self](const boost::system::error_code& error, size_t)
+        {
+            if (!error)
+            {
+                self->respond();
+            }
+            else
+            {
+                self->deadline.cancel();
+            }
+        });
+    }
+
+    boost::asio::ip::tcp::socket socket;
+
+private:
+    // Only "GET /metrics" is served
+    void respond()
+    {
+        std::istream requestStream(&request);
+        std::string method;
+        std::string target;
+        requestStream >> method >> target;
+
+        if (method == "GET" && (target == "/metrics" || target.compare(0, 9, "/metrics?") == 0))
+        {
+            // Held until the response has been written, so a refresh
+            // mid-write doesn't pull the text out from under it
+            renderedMetrics = exporter.renderedMetrics;
+            SCRAPES.increment();
+            response = "HTTP/1.0 200 OK\r\n"
+                    "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                    "Content-Length: " + std::to_string(renderedMetrics->length()) + "\r\n"
+                    "Connection: close\r\n\r\n" + *renderedMetrics;
+        }
+        else
+        {
+            response = "HTTP/1.0 404 Not Found\r\n"
+                    "Content-Type: text/plain\r\n"
+                    "Content-Length: 10\r\n"
+                    "Connection: close\r\n\r\nNot Found\n";
+        }
+
+        auto self = shared_from_this();
+        boost::asio::async_write(socket, boost::asio::buffer(response),
+                [self](const boost::system::error_code&, size_t)
+        {
+            boost::system::error_code ignored;
+            self->socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ignored);
+            self->socket.close(ignored);
+            self->deadline.cancel();
+        });
+    }
+
+    boost::asio::streambuf request;
+    boost::asio::steady_timer deadline;
+    const PrometheusExporter& exporter;
+    std::shared_ptr<const std::string> renderedMetrics;
+    std::string response;
+};
+
+/**
+ * Binds the port and renders the first snapshot before any scrape can be
+ * accepted, then starts exporterThread
+ */
+PrometheusExporter::PrometheusExporter(uint16_t port, std::chrono::milliseconds refreshInterval):
+        refreshInterval(refreshInterval),
+        ioService(),
+        acceptor(ioService, boost::asio::ip::tcp::endpoint(
+                boost::asio::ip::address_v4::loopback(), port), true),
+        refreshTimer(ioService)
+{
+    refresh();
+    scheduleRefresh();
+    startAccept();
+
+    exporterThread = std::thread([this]()
+    {
+        ioService.run();
+    });
+
+    std::cout << "Serving Prometheus metrics on 127.0.0.1:" << port << "/metrics" << std::endl;
+}
+
+PrometheusExporter::~PrometheusExporter()
+{
+    ioService.stop();
+    if (exporterThread.joinable())
+    {
+        exporterThread.join();
+    }
+}
+
+void PrometheusExporter::refresh()
+{
+    renderedMetrics = std::make_shared<const std::string>(
+            renderSnapshot(MetricsRegistry::getInstance().takeSnapshot()));
+}
+
+void PrometheusExporter::scheduleRefresh()
+{
+    refreshTimer.expires_from_now(refreshInterval);
+    refreshTimer.async_wait([this](const boost::system::error_code& error)
+    {
+        if (!error)
+        {
+            refresh();
+            scheduleRefresh();
+        }
+    });
+}
+
+void PrometheusExporter::startAccept()
+{
+    auto session = std::make_shared<ScrapeSession>(ioService, *this);
+    acceptor.async_accept(session->socket, [this, session](const boost::system::error_code& error)
+    {
+        if (error == boost::asio::error::operation_aborted)
+        {
+            return;
+        }
+        if (!error)
+        {
+            session->start();
+        }
+        startAccept();
+    });
+}
+
+/**
+ * Metrics sharing a name are grouped under one HELP and TYPE line, in
+ * registration order. Histograms are exposed with a cumulative bucket per
+ * power of two; since recorded values are integers, the values below 2^n
+ * are exactly those at or below le="2^n - 1".
+ */
+std::string PrometheusExporter::renderSnapshot(const MetricsRegistry::Snapshot& snapshot)
+{
+    std::string rendered;
+
+    auto addLabels = [](const std::string& labels, const std::string& extraLabel)
+    {
+        if (labels.empty() && extraLabel.empty())
+        {
+            return std::string();
+        }
+        return "{" + labels + (labels.empty() || extraLabel.empty() ? "" : ",") +
+                extraLabel + "}";
+    };
+
+    std::vector<std::string> counterNames;
+    std::unordered_map<std::string, std::vector<const MetricsRegistry::CounterSnapshot*>> countersByName;
+    for (const MetricsRegistry::CounterSnapshot& counter : snapshot.counters)
+    {
+        auto& sameName = countersByName[counter.info.name];
+        if (sameName.empty())
+        {
+            counterNames.push_back(counter.info.name);
+        }
+        sameName.push_back(&counter);
+    }
+
+    for (const std::string& name : counterNames)
+    {
+        const auto& sameName = countersByName[name];
+        rendered.append("# HELP " + name + " " + sameName.front()->info.help + "\n");
+        rendered.append("# TYPE " + name + " counter\n");
+        for (const MetricsRegistry::CounterSnapshot* counter : sameName)
+        {
+            rendered.append(name + addLabels(counter->info.labels, "") + " " +
+                    std::to_string(counter->value) + "\n");
+        }
+    }
+
+    for (const MetricsRegistry::HistogramSnapshot& histogram : snapshot.histograms)
+    {
+        const std::string& name = histogram.info.name;
+        const std::string& labels = histogram.info.labels;
+
+        rendered.append("# HELP " + name + " " + histogram.info.help + "\n");
+        rendered.append("# TYPE " + name + " histogram\n");
+
+        uint64_t cumulativeCount = 0;
+        size_t bucketIdx = 0;
+        for (size_t powerOfTwo = 0; powerOfTwo < MetricsRegistry::MAX_VALUE_BITS; ++powerOfTwo)
+        {
+            uint64_t upperBound = 1ull << powerOfTwo;
+            while (bucketIdx < histogram.bucketCounts.size() &&
+                    MetricsRegistry::getBucketUpperBound(bucketIdx) <= upperBound)
+            {
+                cumulativeCount += histogram.bucketCounts[bucketIdx++];
+            }
+
+            rendered.append(name + "_bucket" + addLabels(labels,
+                    "le=\"" + std::to_string(upperBound - 1) + "\"") + " " +
+                    std::to_string(cumulativeCount) + "\n");
+        }
+        rendered.append(name + "_bucket" + addLabels(labels, "le=\"+Inf\"") + " " +
+                std::to_string(histogram.count) + "\n");
+        rendered.append(name + "_sum" + addLabels(labels, "") + " " +
+                std::to_string(histogram.sum) + "\n");
+        rendered.append(name + "_count" + addLabels(labels, "") + " " +
+                std::to_string(histogram.count) + "\n");
+    }
+
+    return rendered;
+}
+
+PrometheusExporter::Builder& PrometheusExporter::Builder::withPort(uint16_t port)
+{
+    this->port = port;
+    return *this;
+}
+
+/**
+ * Specifies how often the registry is snapshotted; scrapes in between are
+ * served the same values
+ */
+PrometheusExporter::Builder& PrometheusExporter::Builder::withRefreshInterval(
+        std::chrono::milliseconds refreshInterval)
+{
+    this->refreshInterval = refreshInterval;
+    return *this;
+}
+
+PrometheusExporterSharedPtr PrometheusExporter::Builder::build() const
+{
+    return PrometheusExporterSharedPtr(new PrometheusExporter(port, refreshInterval));
+}
@@ -0,0 +1,96 @@
+/*
+ * PrometheusExporter.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+#ifndef NETWORK_PROMETHEUSEXPORTER_HPP_
+#define NETWORK_PROMETHEUSEXPORTER_HPP_
+
+// System Includes
+#include <boost/asio.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+// Project Includes
+#include "MetricsRegistry.hpp"
+
+// Foward declaration
+class PrometheusExporter;
+
+// Typedefs
+using PrometheusExporterSharedPtr = std::shared_ptr<PrometheusExporter>;
+
+/**
+ * Serves the MetricsRegistry in the Prometheus text exposition format over
+ * HTTP, on a port of its own bound to the loopback interface. Everything
+ * runs on the exporter's own thread and io_service: the registry is
+ * snapshotted and rendered every refresh interval, and scrapes are answered
+ * with the most recent rendering, so they never touch the registry's lock
+ * or TcpServer's threads.
+ */
+class PrometheusExporter
+{
+public:
+    class Builder
+    {
+    public:
+        Builder() {};
+        Builder& withPort(uint16_t port);
+        Builder& withRefreshInterval(std::chrono::milliseconds refreshInterval);
+
+        // Binds the port and starts serving; throws a boost::system::system_error
+        // if the port can't be bound
+        PrometheusExporterSharedPtr build() const;
+
+    private:
+        uint16_t port = DEFAULT_PORT;
+        std::chrono::milliseconds refreshInterval = DEFAULT_REFRESH_INTERVAL;
+    };
+
+    // Renders snapshot in the Prometheus text exposition format
+    static std::string renderSnapshot(const MetricsRegistry::Snapshot& snapshot);
+
+    ~PrometheusExporter();
+
+    PrometheusExporter(const PrometheusExporter&) = delete;
+    PrometheusExporter& operator=(const PrometheusExporter&) = delete;
+
+    static const uint16_t DEFAULT_PORT = 9218;
+    static const std::chrono::milliseconds DEFAULT_REFRESH_INTERVAL;
+
+private:
+    class ScrapeSession;
+
+    PrometheusExporter(uint16_t port, std::chrono::milliseconds refreshInterval);
+
+    void refresh();
+    void scheduleRefresh();
+    void startAccept();
+
+    // Requests larger than this are dropped
+    static const size_t MAX_REQUEST_LENGTH;
+
+    // Connections which haven't been answered within this are dropped
+    static const std::chrono::seconds SCRAPE_TIMEOUT;
+
+    static const MetricsRegistry::Counter SCRAPES;
+
+    const std::chrono::milliseconds refreshInterval;
+
+    boost::asio::io_service ioService;
+    boost::asio::ip::tcp::acceptor acceptor;
+    boost::asio::steady_timer refreshTimer;
+
+    // The latest rendering; only accessed on exporterThread
+    std::shared_ptr<const std::string> renderedMetrics;
+
+    std::thread exporterThread;
+};
+
+#endif /* NETWORK_PROMETHEUSEXPORTER_HPP_ */
@@ -7,48 +7,42 @@
 
 // System Includes
 #include <boost/asio.hpp>
-#include <mutex>
+#include <condition_variable>
 #include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
 
 // Project Includes
 #include "SocketWrapper.hpp"
 
+// Static initialization
+const MetricsRegistry::Counter SocketWrapper::BYTES_RECEIVED =
+        MetricsRegistry::getInstance().registerCounter("netsysctrld_received_bytes_total",
+        "Bytes received from clients");
+const MetricsRegistry::Counter SocketWrapper::BYTES_SENT =
+        MetricsRegistry::getInstance().registerCounter("netsysctrld_sent_bytes_total",
+        "Bytes sent to clients, including pushed events");
+const MetricsRegistry::Counter SocketWrapper::SLOW_CLIENT_DISCONNECTS =
+        MetricsRegistry::getInstance().registerCounter("netsysctrld_slow_client_disconnects_total",
+        "Clients disconnected for falling too far behind on pushed events");
+
+// Events are small, so this is a lot of backlog for a client which is still
+// reading
+const size_t SocketWrapper::MAX_QUEUED_MESSAGES = 4096;
+
 /**
  * Constructs a new SocketWrapper with the socketPtr parameter used
- * to instantiate the socketPtr member. writeMutex is instantiated using its
- * default constructor. The ipAddr and port members are initialized based off
- * of the socket parameter.
+ * to instantiate the socketPtr member. The ipAddr and port members are initialized based off
+ * of the socket parameter. subscriptions holds the server's topics.
  */
-SocketWrapper::SocketWrapper(TcpSocketSharedPtr& socketPtr) :
+SocketWrapper::SocketWrapper(TcpSocketSharedPtr& socketPtr,
+        const TopicSubscriptionsSharedPtr& subscriptions) :
         socketPtr(socketPtr),
         ipAddr(socketPtr->remote_endpoint().address().to_string()),
-        portNum(socketPtr->remote_endpoint().port())
-{
-}
-
-/**
- * Copy constructor for SocketWrapper. DOES NOT COPY THE MUTEX STATE!!!
- * That is, the new SocketWrapper will have a new mutex.
- */
-SocketWrapper::SocketWrapper(const SocketWrapper& toCopy)
-{
-    socketPtr = toCopy.socketPtr;
-    ipAddr = toCopy.ipAddr;
-    portNum = toCopy.portNum;
-}
-
-/**
- * Assignment operator overload for SocketWrapper. THIS DOES NOT COPY THE MUTEX
- * STATE!!!! Instead, the returned SocketWrapper instance will have ITS OWN
- * MUTEX. The socketPtr, ipAddr, and portNum members are copied using their
- * respective assignment operators.
- */
-SocketWrapper& SocketWrapper::operator=(const SocketWrapper& base)
+        portNum(socketPtr->remote_endpoint().port()),
+        subscriptions(subscriptions)
 {
-    socketPtr = base.socketPtr;
-    ipAddr = base.ipAddr;
-    portNum = base.portNum;
-    return *this;
 }
 
 /**
@@ -82,14 +76,6 @@ TcpSocket& SocketWrapper::getSocket()
     return *socketPtr;
 }
 
-/**
- * Returns a reference to the writeMutex member.
- */
-std::mutex& SocketWrapper::getWriteMutex()
-{
-    return writeMutex;
-}
-
 /**
  * Returns a const reference to this SocketWrapper's IP address
  */
@@ -108,13 +94,187 @@ uint16_t SocketWrapper::getPortNumber()
 
 /**
  * Sends the data stored in dataToSend to the client associated with this
- * socket. The call to write() is guarded with this SocketWrapper's writeMutex
+ * socket, blocking until it's been written. Nothing else is being written
+ * to the client most of the time, and then it's written directly;
+ * otherwise it's queued behind the events already waiting, so the client
+ * sees everything in the order it was sent. Throws a
+ * boost::system::system_error if the data couldn't be written.
  */
 size_t SocketWrapper::sendData(const std::string& dataToSend)
 {
-    // Lock the write operation
-    std::lock_guard<std::mutex> writeLock { writeMutex };
-    return boost::asio::write(*socketPtr, boost::asio::buffer(dataToSend));
+    std::unique_lock<std::mutex> outboundLock{outboundMutex};
+    if (outboundError)
+    {
+        throw boost::system::system_error(outboundError);
+    }
+
+    if (writeInProgress || !outboundQueue.empty())
+    {
+        outboundQueue.push_back(dataToSend);
+        const uint64_t messageNumber = ++queuedCount;
+        if (!writeInProgress)
+        {
+            startWritingQueuedLocked();
+        }
+        outboundWritten.wait(outboundLock, [this, messageNumber]()
+        {
+            return writtenCount >= messageNumber || outboundError;
+        });
+        if (writtenCount < messageNumber)
+        {
+            throw boost::system::system_error(outboundError);
+        }
+        return dataToSend.size();
+    }
+
+    writeInProgress = true;
+    outboundLock.unlock();
+    boost::system::error_code writeError;
+    size_t bytesSent = boost::asio::write(*socketPtr, boost::asio::buffer(dataToSend),
+            writeError);
+    BYTES_SENT.increment(bytesSent);
+    outboundLock.lock();
+
+    writeInProgress = false;
+    if (writeError)
+    {
+        failOutboundLocked(writeError);
+    }
+    else if (outboundError)
+    {
+        // Events overflowed the queue during the write
+        failOutboundLocked(outboundError);
+    }
+    else if (!outboundQueue.empty())
+    {
+        startWritingQueuedLocked();
+    }
+
+    if (writeError)
+    {
+        throw boost::system::system_error(writeError);
+    }
+    return bytesSent;
+}
+
+/**
+ * Queues eventMsg to be written to the client by the io_service, and
+ * returns without waiting for it, so a client which is slow to read can't
+ * hold up whoever raised the event. Events are written in the order they
+ * were queued, interleaved with responses. A client whose backlog reaches
+ * MAX_QUEUED_MESSAGES is disconnected rather than queueing without bound;
+ * its connection thread then finds the socket shut down. Events queued for
+ * a client which has failed are discarded.
+ */
+void SocketWrapper::queueEvent(const std::string& eventMsg)
+{
+    std::lock_guard<std::mutex> outboundLock{outboundMutex};
+    if (outboundError)
+    {
+        return;
+    }
+
+    if (outboundQueue.size() >= MAX_QUEUED_MESSAGES)
+    {
+        std::cout << "Disconnecting client which isn't reading its events: "
+                << getIpAddressAndPort() << std::endl;
+        SLOW_CLIENT_DISCONNECTS.increment();
+        failOutboundLocked(boost::asio::error::no_buffer_space);
+        return;
+    }
+
+    outboundQueue.push_back(eventMsg);
+    ++queuedCount;
+    if (!writeInProgress)
+    {
+        startWritingQueuedLocked();
+    }
+}
+
+/**
+ * Hands the queue to the io_service, which writes it until it's empty.
+ * Called with outboundMutex held, and nothing being written.
+ */
+void SocketWrapper::startWritingQueuedLocked()
+{
+    writeInProgress = true;
+    SocketWrapperSharedPtr self = shared_from_this();
+    boost::asio::post(socketPtr->get_executor(), [self]()
+    {
+        self->writeQueued();
+    });
+}
+
+/**
+ * Starts an asynchronous write of the front of the queue; runs on the
+ * io_service. The entry stays in the queue, and so valid, until
+ * writeQueuedHandler removes it.
+ */
+void SocketWrapper::writeQueued()
+{
+    std::unique_lock<std::mutex> outboundLock{outboundMutex};
+    if (outboundError || outboundQueue.empty())
+    {
+        writeInProgress = false;
+        if (outboundError)
+        {
+            failOutboundLocked(outboundError);
+        }
+        return;
+    }
+    const std::string& frontData = outboundQueue.front();
+    outboundLock.unlock();
+
+    SocketWrapperSharedPtr self = shared_from_this();
+    boost::asio::async_write(*socketPtr, boost::asio::buffer(frontData),
+            [self](const boost::system::error_code& error, size_t bytesSent)
+    {
+        self->writeQueuedHandler(error, bytesSent);
+    });
+}
+
+/**
+ * Removes the written entry, wakes any response waiting on it, and carries
+ * on with the next one
+ */
+void SocketWrapper::writeQueuedHandler(const boost::system::error_code& error,
+        size_t bytesSent)
+{
+    BYTES_SENT.increment(bytesSent);
+    {
+        std::lock_guard<std::mutex> outboundLock{outboundMutex};
+        if (error)
+        {
+            writeInProgress = false;
+            failOutboundLocked(error);
+            return;
+        }
+        outboundQueue.pop_front();
+        ++writtenCount;
+        outboundWritten.notify_all();
+    }
+    writeQueued();
+}
+
+/**
+ * Stops all further writes to the client after error, and shuts the socket
+ * down so its connection thread stops too. The queue can only be discarded
+ * once nothing is being written from it; otherwise whoever is writing
+ * calls this again when they finish.
+ */
+void SocketWrapper::failOutboundLocked(const boost::system::error_code& error)
+{
+    if (!outboundError)
+    {
+        outboundError = error;
+        boost::system::error_code ignoredError;
+        socketPtr->shutdown(TcpSocket::shutdown_both, ignoredError);
+    }
+    if (!writeInProgress)
+    {
+        outboundQueue.clear();
+    }
+    outboundWritten.notify_all();
 }
 
 /**
@@ -136,6 +296,7 @@ size_t SocketWrapper::receiveData(std::string& receivedData,
     // Read until charToReadUntil has been reached
     size_t bytesReceived = boost::asio::read_until(*socketPtr, readBuff,
             charToReadUntil);
+    BYTES_RECEIVED.increment(bytesReceived);
 
     // Create a stream to read data out of the buffer
     std::istream readBuffInputStream(&readBuff);
@@ -147,20 +308,6 @@ size_t SocketWrapper::receiveData(std::string& receivedData,
     return bytesReceived;
 }
 
-/*
- * Wrapper to call sendData() which doesn't return the number of bytes sent.
- * Instead, this function will throw a std::runtime_exception if
- * dataToSend.size() bytes weren't sent.
- */
-void SocketWrapper::sendDataVoidReturn(const std::string& dataToSend)
-{
-    auto bytesActuallySent = sendData(dataToSend);
-    if (bytesActuallySent != dataToSend.size())
-    {
-        throw std::runtime_error("Not all data written to socket");
-    }
-}
-
 /**
  * Returns the client's IP address and port number in the form
  * <IP Addr>:<Port>
@@ -171,3 +318,71 @@ const std::string SocketWrapper::getIpAddressAndPort()
     ipAndPort += ipAddr + ":" + std::to_string(portNum);
     return ipAndPort;
 }
+
+/**
+ * For the SUBSCRIBE command. Starts pushing topic's events to this client;
+ * see TopicSubscriptions for the topics. An invalid topic results in a
+ * std::invalid_argument being thrown.
+ */
+void SocketWrapper::subscribeHandler(const std::string& topic, std::string* updatableMessage)
+{
+    (void) updatableMessage;
+
+    subscriptions->subscribe(topic, shared_from_this());
+}
+
+/**
+ * For the UNSUBSCRIBE command. Stops pushing topic's events to this client.
+ * Unsubscribing from "gpio" doesn't affect subscriptions to single pins.
+ */
+void SocketWrapper::unsubscribeHandler(const std::string& topic, std::string* updatableMessage)
+{
+    (void) updatableMessage;
+
+    subscriptions->unsubscribe(topic, shared_from_this());
+}
+
+/**
+ * For the GPIO_EVENTS command, which predates SUBSCRIBE. enable must be "1"
+ * to subscribe to the "gpio" topic, or "0" to unsubscribe.
+ */
+void SocketWrapper::setGpioInputSubscriptionHandler(const std::string& enable,
+        std::string* updatableMessage)
+{
+    (void) updatableMessage;
+
+    setSubscription(TopicSubscriptions::GPIO_TOPIC, enable);
+}
+
+/**
+ * For the VOLUME_EVENTS command, which predates SUBSCRIBE. enable must be
+ * "1" to subscribe to the "volume" topic, or "0" to unsubscribe.
+ */
+void SocketWrapper::setVolumeSubscriptionHandler(const std::string& enable,
+        std::string* updatableMessage)
+{
+    (void) updatableMessage;
+
+    setSubscription(TopicSubscriptions::VOLUME_TOPIC, enable);
+}
+
+/**
+ * Subscribes to topic if enable is "1", and unsubscribes if it's "0". Any
+ * other value results in a std::invalid_argument being thrown.
+ */
+void SocketWrapper::setSubscription(const std::string& topic, const std::string& enable)
+{
+    if (enable == "1")
+    {
+        subscriptions->subscribe(topic, shared_from_this());
+    }
+    else if (enable == "0")
+    {
+        subscriptions->unsubscribe(topic, shared_from_this());
+    }
+    else
+    {
+        throw std::invalid_argument("Subscription value: " + enable +
+                " invalid; it must be 0(unsubscribe) or 1(subscribe)");
+    }
+}
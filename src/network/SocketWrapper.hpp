@@ -10,39 +10,90 @@
 
 // System Includes
 #include <boost/asio.hpp>
+#include <condition_variable>
+#include <deque>
+#include <memory>
 #include <mutex>
 #include <stdint.h>
 
+// Project Includes
+#include "MetricsRegistry.hpp"
+#include "TopicSubscriptions.hpp"
+
 // Typedef/using statements for convenience
 using TcpSocketSharedPtr = std::shared_ptr<boost::asio::ip::tcp::socket>;
 using TcpSocket = boost::asio::ip::tcp::socket;
 using BoostStreamBuff = boost::asio::streambuf;
 
-class SocketWrapper
+class SocketWrapper : public std::enable_shared_from_this<SocketWrapper>
 {
 public:
-    SocketWrapper(TcpSocketSharedPtr& socketPtr);
-    SocketWrapper(const SocketWrapper& toCopy);
-    SocketWrapper& operator=(const SocketWrapper& base);
+    SocketWrapper(TcpSocketSharedPtr& socketPtr, const TopicSubscriptionsSharedPtr& subscriptions);
+
+    // Wrappers are shared through SocketWrapperSharedPtrs, and are
+    // identified by their address in the topic subscriptions, so a copy
+    // would be a different client as far as those are concerned
+    SocketWrapper(const SocketWrapper&) = delete;
+    SocketWrapper& operator=(const SocketWrapper&) = delete;
+
     bool operator==(const SocketWrapper& other);
 
     TcpSocket& getSocket();
-    std::mutex& getWriteMutex();
     const std::string& getIpAddress();
     uint16_t getPortNumber();
     const std::string getIpAddressAndPort();
 
     // Functions for I/O on the socketPtr
     size_t sendData(const std::string& dataToSend);
-    void sendDataVoidReturn(const std::string& dataToSend);
+    void queueEvent(const std::string& eventMsg);
     size_t receiveData(std::string& receivedData, BoostStreamBuff& readBuff,
             const std::string& charToReadUntil);
 
+    // Interpreter-executable commands, executed on the calling client's own
+    // SocketWrapper. These require it to be owned by a SocketWrapperSharedPtr.
+    void subscribeHandler(const std::string& topic, std::string* updatableMessage);
+    void unsubscribeHandler(const std::string& topic, std::string* updatableMessage);
+    void setGpioInputSubscriptionHandler(const std::string& enable,
+            std::string* updatableMessage);
+    void setVolumeSubscriptionHandler(const std::string& enable,
+            std::string* updatableMessage);
+
 private:
     TcpSocketSharedPtr socketPtr;
-    std::mutex writeMutex;
     std::string ipAddr;
     uint16_t portNum;
+
+    // The server's push notification topics, which this client's SUBSCRIBE
+    // and UNSUBSCRIBE commands act on
+    TopicSubscriptionsSharedPtr subscriptions;
+
+    // Data waiting to be written, oldest first. writeInProgress is set
+    // while either a response is written directly by sendData, or the
+    // io_service is writing the queue; in the latter case the front entry
+    // is being written, so only writeQueuedHandler removes it. The counts
+    // let a queued response tell when it's been written.
+    std::mutex outboundMutex;
+    std::condition_variable outboundWritten;
+    std::deque<std::string> outboundQueue;
+    bool writeInProgress = false;
+    uint64_t queuedCount = 0;
+    uint64_t writtenCount = 0;
+
+    // Set by the first failed write, or when the client falls too far
+    // behind; nothing more is written after it
+    boost::system::error_code outboundError;
+
+    void setSubscription(const std::string& topic, const std::string& enable);
+    void startWritingQueuedLocked();
+    void writeQueued();
+    void writeQueuedHandler(const boost::system::error_code& error, size_t bytesSent);
+    void failOutboundLocked(const boost::system::error_code& error);
+
+    static const size_t MAX_QUEUED_MESSAGES;
+
+    static const MetricsRegistry::Counter BYTES_RECEIVED;
+    static const MetricsRegistry::Counter BYTES_SENT;
+    static const MetricsRegistry::Counter SLOW_CLIENT_DISCONNECTS;
 };
 
 #endif /* NETWORK_SOCKETWRAPPER_HPP_ */
@@ -0,0 +1,128 @@
+/*
+ * StateJournal.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+// System Includes
+#include <stdexcept>
+
+// Project Includes
+#include "StateJournal.hpp"
+
+// Static initialization
+
+/**
+ * How many deltas are kept for RESYNC by default
+ */
+const size_t StateJournal::DEFAULT_CAPACITY = 1024;
+
+/**
+ * Starts each delta's event line, which continues with its sequence number,
+ * subsystem and fields, e.g. "~DELTA 42 gpio led=1,fan=0"
+ */
+const std::string StateJournal::DELTA_STRING_PREFIX = "~DELTA ";
+
+/**
+ * Starts a RESYNC snapshot, followed by the sequence number it's current to
+ * and a line per subsystem, e.g. "~STATE volume level=40"
+ */
+const std::string StateJournal::SNAPSHOT_STRING_PREFIX = "~SNAPSHOT ";
+const std::string StateJournal::SNAPSHOT_STATE_STRING_PREFIX = "~STATE ";
+
+/**
+ * Throws a std::invalid_argument if capacity is 0
+ */
+StateJournal::StateJournal(size_t capacity) :
+        capacity(capacity),
+        lastSeq(0)
+{
+    if (capacity == 0)
+    {
+        throw std::invalid_argument("The state journal must hold at least one delta");
+    }
+}
+
+/**
+ * The oldest delta is dropped once capacity is reached. Callers which need
+ * their deltas numbered in the order their changes were made must append
+ * while holding whatever lock orders those changes.
+ */
+std::string StateJournal::append(const std::string& subsystem, const Fields& fields)
+{
+    std::lock_guard<std::mutex> lock{journalMutex};
+
+    ++lastSeq;
+    std::string eventLine = DELTA_STRING_PREFIX + std::to_string(lastSeq) + " " +
+            subsystem + " " + formatFields(fields) + "\n";
+
+    if (deltas.size() == capacity)
+    {
+        deltas.pop_front();
+    }
+    deltas.push_back(eventLine);
+
+    return eventLine;
+}
+
+void StateJournal::addSnapshotSource(const std::string& subsystem, const SnapshotSource& source)
+{
+    std::lock_guard<std::mutex> lock{journalMutex};
+    snapshotSources.emplace_back(subsystem, source);
+}
+
+/**
+ * A lastSeq ahead of the journal, such as one from before the daemon
+ * restarted, also gets a snapshot. The snapshot's sequence number is read
+ * before its sources, so it may already include some later deltas; those
+ * are safe to apply again.
+ */
+bool StateJournal::resync(uint64_t lastSeq, std::string& resyncInfo) const
+{
+    uint64_t snapshotSeq;
+    std::vector<std::pair<std::string, SnapshotSource>> sources;
+    {
+        std::lock_guard<std::mutex> lock{journalMutex};
+
+        if (lastSeq <= this->lastSeq && this->lastSeq - lastSeq <= deltas.size())
+        {
+            for (size_t deltaIdx = deltas.size() - (this->lastSeq - lastSeq);
+                    deltaIdx < deltas.size(); ++deltaIdx)
+            {
+                resyncInfo.append(deltas[deltaIdx]);
+            }
+            return false;
+        }
+
+        snapshotSeq = this->lastSeq;
+        sources = snapshotSources;
+    }
+
+    resyncInfo.append(SNAPSHOT_STRING_PREFIX + std::to_string(snapshotSeq) + "\n");
+    for (const std::pair<std::string, SnapshotSource>& source : sources)
+    {
+        resyncInfo.append(SNAPSHOT_STATE_STRING_PREFIX + source.first + " " +
+                formatFields(source.second()) + "\n");
+    }
+    return true;
+}
+
+/**
+ * Returns fields as name=value pairs, separated by commas
+ */
+std::string StateJournal::formatFields(const Fields& fields)
+{
+    std::string formatted;
+    for (const std::pair<std::string, std::string>& field : fields)
+    {
+        if (!formatted.empty())
+        {
+            formatted.push_back(',');
+        }
+        formatted.append(field.first);
+        formatted.push_back('=');
+        formatted.append(field.second);
+    }
+    return formatted;
+}
@@ -0,0 +1,81 @@
+/*
+ * StateJournal.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+#ifndef NETWORK_STATEJOURNAL_HPP_
+#define NETWORK_STATEJOURNAL_HPP_
+
+// System Includes
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Project Includes
+// <none>
+
+// Forward declarations
+class StateJournal;
+
+// Using statements
+using StateJournalSharedPtr = std::shared_ptr<StateJournal>;
+
+/**
+ * A bounded, in-memory journal of state deltas. Each delta is given the next
+ * sequence number, and names a subsystem (e.g. "volume") and the new values
+ * of the fields which changed. Values are absolute, so applying a delta more
+ * than once, or to a snapshot which already includes it, is harmless.
+ *
+ * A client which has applied everything up to some sequence number can ask
+ * for what it missed; if that's no longer journalled, or the number is from
+ * before a restart, it's given a snapshot of every subsystem instead.
+ */
+class StateJournal
+{
+public:
+    // Field names and values, in order
+    using Fields = std::vector<std::pair<std::string, std::string>>;
+
+    // Returns a subsystem's current fields, for snapshots
+    using SnapshotSource = std::function<Fields()>;
+
+    explicit StateJournal(size_t capacity=DEFAULT_CAPACITY);
+
+    // Journals a delta, and returns its event line to push to clients
+    std::string append(const std::string& subsystem, const Fields& fields);
+
+    // Snapshot sources are called without the journal locked, so they may
+    // take locks which are held while appending
+    void addSnapshotSource(const std::string& subsystem, const SnapshotSource& source);
+
+    // Appends the deltas after lastSeq to resyncInfo, or a snapshot if they
+    // aren't all journalled. Returns true if a snapshot was given.
+    bool resync(uint64_t lastSeq, std::string& resyncInfo) const;
+
+    static const size_t DEFAULT_CAPACITY;
+    static const std::string DELTA_STRING_PREFIX;
+    static const std::string SNAPSHOT_STRING_PREFIX;
+    static const std::string SNAPSHOT_STATE_STRING_PREFIX;
+
+private:
+    static std::string formatFields(const Fields& fields);
+
+    const size_t capacity;
+
+    // The event lines of the newest deltas, oldest first; the last has
+    // sequence number lastSeq
+    std::deque<std::string> deltas;
+    uint64_t lastSeq;
+
+    std::vector<std::pair<std::string, SnapshotSource>> snapshotSources;
+    mutable std::mutex journalMutex;
+};
+
+#endif /* NETWORK_STATEJOURNAL_HPP_ */
@@ -11,43 +11,90 @@
 #include <boost/phoenix/bind/bind_member_function.hpp>
 #include <boost/smart_ptr.hpp>
 #include <boost/thread.hpp>
+#include <csignal>
 #include <cstdint>
-#include <ctime>
+#include <cstdio>
+#include <functional>
 #include <ifaddrs.h>
 #include <iostream>
 #include <list>
 #include <mutex>
 #include <netdb.h>
+#include <pthread.h>
 #include <stdexcept>
 #include <string>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <system_error>
 #include <thread>
+#include <vector>
 
 // Project Includes
 #include "CommandParser.hpp"
+#include "RequestTracer.hpp"
 #include "SocketWrapper.hpp"
 #include "TcpServer.hpp"
 
 // Static Initialization
 
 /**
- * When a client has run EXECUTE, this string followed by a datestamp will be
- * sent to the client
+ * Pushed to clients which have subscribed to GPIO input events, followed by
+ * "<pinName>:<value> @<seconds>.<microseconds>"
  */
-const std::string TcpServer::UPDATED_PARAMETERS_AVAILABLE_STRING_PREFIX = "~UPDATE_AVAILABLE: ";
+const std::string TcpServer::GPIO_INPUT_EVENT_STRING_PREFIX = "~GPIO_INPUT: ";
+
+/**
+ * Pushed to clients which have subscribed to volume changes, followed by the
+ * new volume percentage
+ */
+const std::string TcpServer::VOLUME_EVENT_STRING_PREFIX = "~VOLUME: ";
+
+/**
+ * The subsystems named by state deltas and snapshots
+ */
+const std::string TcpServer::VOLUME_SUBSYSTEM = "volume";
+const std::string TcpServer::GPIO_SUBSYSTEM = "gpio";
+
+// The value of an output pin's field once its state isn't known, e.g. while
+// it's driven by PWM or after a write to it failed
+const std::string TcpServer::UNKNOWN_OUTPUT_STATE = "unknown";
+
+const MetricsRegistry::Counter TcpServer::ACCEPTED_CONNECTIONS =
+        MetricsRegistry::getInstance().registerCounter("netsysctrld_accepted_connections_total",
+        "Client connections accepted");
+const MetricsRegistry::Counter TcpServer::AUTH_SUCCESSES =
+        MetricsRegistry::getInstance().registerCounter("netsysctrld_authentications_total",
+        "Password prompts answered by clients, by result", "result=\"success\"");
+const MetricsRegistry::Counter TcpServer::AUTH_FAILURES =
+        MetricsRegistry::getInstance().registerCounter("netsysctrld_authentications_total",
+        "Password prompts answered by clients, by result", "result=\"failure\"");
+const MetricsRegistry::Counter TcpServer::DELTA_RESYNCS =
+        MetricsRegistry::getInstance().registerCounter("netsysctrld_resyncs_total",
+        "RESYNC requests, by whether deltas or a snapshot was returned", "result=\"deltas\"");
+const MetricsRegistry::Counter TcpServer::SNAPSHOT_RESYNCS =
+        MetricsRegistry::getInstance().registerCounter("netsysctrld_resyncs_total",
+        "RESYNC requests, by whether deltas or a snapshot was returned", "result=\"snapshot\"");
 
 /**
  * All responses sent from the server end with this string
  */
 const std::string TcpServer::END_OF_RESPONSE_STRING = "~EOR";
 
+/**
+ * How long the accept loop pauses after failing to accept a connection
+ */
+const std::chrono::milliseconds TcpServer::ACCEPT_RETRY_DELAY{50};
+
 /**
  * Default on-connect password for this client
  */
 const char * const TcpServer::DEFAULT_PASSWORD = "netsysctrld";
 
+/**
+ * Where request traces are written on SIGUSR1, unless another path is given
+ */
+const char * const TcpServer::DEFAULT_TRACE_FILE_PATH = "/tmp/netsysctrld-trace.json";
+
 /**
  * Each socket read operation will read up to the newline specifier
  */
@@ -75,14 +122,41 @@ const std::string TcpServer::AUTH_FAILED_STRING = "~AUTH_FAILED";
  * then the user will be required to provide a password in order to interact
  * with this server.
  */
-TcpServer::TcpServer(const uint16_t port, const char * const password) :
+TcpServer::TcpServer(const uint16_t port, const char * const password,
+        const TimerWheelSharedPtr& timerWheel, const std::string& traceFilePath) :
         port(port), requirePassword(password ? true : false),
         password(password ? password : ""),
         ioService(),
-        acceptor(ioService, BoostTcp::endpoint(BoostTcp::v4(), port), true)
+        acceptor(ioService, BoostTcp::endpoint(BoostTcp::v4(), port), true),
+        timerWheel(timerWheel),
+        tickTimer(ioService),
+        ticking(false),
+        traceFilePath(traceFilePath),
+        traceDumpSignals(ioService, SIGUSR1),
+        topicSubscriptions(std::make_shared<TopicSubscriptions>()),
+        stateJournal(std::make_shared<StateJournal>())
 {
 };
 
+/**
+ * Stops the event loop and waits for eventLoopThread to exit
+ */
+TcpServer::~TcpServer()
+{
+    ioService.stop();
+    if (eventLoopThread.joinable())
+    {
+        if (eventLoopThread.get_id() == std::this_thread::get_id())
+        {
+            eventLoopThread.detach();
+        }
+        else
+        {
+            eventLoopThread.join();
+        }
+    }
+}
+
 /**
  * Builds a string with this machine's hostname, the port this server is
  * running on, and a list of all NICs in this machine and their IP addresses
@@ -201,12 +275,14 @@ bool TcpServer::authenticate(SocketWrapper& socketWrap, BoostStreamBuff& socketR
     // The substring gets rid of the trailing newline in the from-socket data
     if (password.compare(receivedData.substr(0, receivedData.size()-1)) == 0)
     {
+        AUTH_SUCCESSES.increment();
         std::cout << socketWrap.getIpAddressAndPort() << " authenticated successfully" << std::endl;
         socketWrap.sendData(AUTH_SUCCESSFUL_STRING + "\n" + END_OF_RESPONSE_STRING + "\n");
         return true;
     }
     else
     {
+        AUTH_FAILURES.increment();
         std::cout << socketWrap.getIpAddressAndPort() << " provided the wrong password" << std::endl;
         socketWrap.sendData(AUTH_FAILED_STRING + "\n" + END_OF_RESPONSE_STRING + "\n");
         return false;
@@ -218,10 +294,11 @@ bool TcpServer::authenticate(SocketWrapper& socketWrap, BoostStreamBuff& socketR
  * a thread which is dedicated to a single client. It will receive and parse
  * strings from the client, and will return status information to it.
  * When this function terminates, the SocketWrapper parameter is removed
- * from the socketWrappersInUse list.
+ * from the socketWrappersInUse list; sockWrapPtr keeps it alive until then.
  */
-void TcpServer::connectionHandler(SocketWrapper& sockWrap, CommandParser& parser)
+void TcpServer::connectionHandler(SocketWrapperSharedPtr sockWrapPtr, CommandParser& parser)
 {
+    SocketWrapper& sockWrap = *sockWrapPtr;
     const std::string& clientIp = sockWrap.getIpAddress();
     uint16_t clientPort = sockWrap.getPortNumber();
     std::cout << "New client: " << clientIp << ":" << clientPort << std::endl;
@@ -233,30 +310,33 @@ void TcpServer::connectionHandler(SocketWrapper& sockWrap, CommandParser& parser
 
         // Request a password from the client if this instance
         // requires a password, kill the connection if their response is invalid
-        if (requirePassword && !authenticate(sockWrap, socketReadStreamBuff))
-        {
-            removeFromSocketWrappersInUse(sockWrap);
-            return;
-        }
+        bool authenticated = !requirePassword || authenticate(sockWrap, socketReadStreamBuff);
 
-        while (true)
+        while (authenticated)
         {
+            RequestTracer::beginRequest();
+
             // Receive data from the client
             std::string receivedData;
+            RequestTracer::mark(RequestTracer::Mark::RECEIVE_START);
             uint32_t bytesReceived = sockWrap.receiveData(receivedData,
                                          socketReadStreamBuff,
                                          SOCKET_READ_UNTIL_END_SPECIFIER);
+            RequestTracer::mark(RequestTracer::Mark::RECEIVE_END);
 
             std::cout << "Received " << bytesReceived << " bytes from: "
                       << clientIp << ":" << clientPort
                       << "\n\tcontent: " << receivedData << std::endl;
 
             // Parse and execute the command/data from the client
-            std::string parseResult = parser.execute(receivedData);
-            parseResult.append("\n" + END_OF_RESPONSE_STRING + "\n");
+            std::string parseResult = parser.execute(receivedData, sockWrap);
+            terminateResponse(parseResult);
 
             // Send the data back to the client
+            RequestTracer::mark(RequestTracer::Mark::SEND_START);
             size_t bytesSent = sockWrap.sendData(parseResult);
+            RequestTracer::mark(RequestTracer::Mark::SEND_END);
+            RequestTracer::endRequest();
 
             std::cout << "Wrote " << bytesSent << " bytes to: "
                       << clientIp << ":" << clientPort
@@ -268,30 +348,177 @@ void TcpServer::connectionHandler(SocketWrapper& sockWrap, CommandParser& parser
         std::cout << "Client: " << clientIp << ":" << clientPort
                 << "-> Exception: " << exception.what() << std::endl;
     }
-    removeFromSocketWrappersInUse(sockWrap);
+    removeFromSocketWrappersInUse(sockWrapPtr);
+}
+
+/**
+ * Appends the line which ends every response, piecewise, so that no
+ * temporary strings are built
+ */
+void TcpServer::terminateResponse(std::string& response)
+{
+    response.push_back('\n');
+    response.append(END_OF_RESPONSE_STRING);
+    response.push_back('\n');
 }
 
 /**
  * Allows this server to receive connections. All new connections execute
  * this->connectionHandler in a new thread, and all connected clients
  * are associated with a SocketWrapper instance which is added to
- * socketWrappersInUse.
+ * socketWrappersInUse. A connection which fails to be accepted or set up,
+ * such as one reset by its client straight away, or one refused for lack
+ * of file descriptors, is dropped without affecting the others. Returns
+ * once terminate() has closed the acceptor.
  */
 void TcpServer::run(CommandParser& parser)
 {
     std::cout << "netsysctrld server started on:" << getServerInfo() << std::endl;
 
-    while (true)
+    startEventLoop();
+
+    while (acceptor.is_open())
+    {
+        TcpSocketSharedPtr tcpSocketPtr(new TcpSocket(ioService));
+        boost::system::error_code acceptError;
+        acceptor.accept(*tcpSocketPtr, acceptError);
+        if (acceptError)
+        {
+            if (acceptor.is_open())
+            {
+                std::cout << "Failed to accept a connection; " << acceptError.message() << std::endl;
+
+                // Such as EMFILE; give connections time to close
+                std::this_thread::sleep_for(ACCEPT_RETRY_DELAY);
+            }
+            continue;
+        }
+        ACCEPTED_CONNECTIONS.increment();
+
+        try
+        {
+            // Create a new SocketWrapper for this client, add it to
+            // socketWrappersInUse, and share it with the client thread
+            boost::thread clientHandler(boost::bind(&TcpServer::connectionHandler, this,
+                    appendToSocketWrappersInUse(tcpSocketPtr), boost::ref(parser)));
+        }
+        catch (std::exception& exception)
+        {
+            std::cout << "Failed to set up a connection; " << exception.what() << std::endl;
+        }
+    }
+}
+
+/**
+ * Starts eventLoopThread, which runs ioService until terminate() is called.
+ * If this server has a TimerWheel, the loop turns it while it has pending
+ * timers; the wheel's wakeup callback restarts ticking when it goes from
+ * idle to busy.
+ */
+void TcpServer::startEventLoop()
+{
+    if (eventLoopThread.joinable())
+    {
+        return;
+    }
+
+    if (timerWheel)
     {
-      TcpSocketSharedPtr tcpSocketPtr(new TcpSocket(ioService));
-      acceptor.accept(*tcpSocketPtr);
+        timerWheel->setWakeupCallback([this]()
+        {
+            ioService.post(std::bind(&TcpServer::startTicking, this));
+        });
 
-      // Create a new SocketWrapper for this client, add it to
-      // socketWrappersInUse, and send its reference as a param to the client
-      // thread.
-      boost::thread clientHandler(boost::bind(&TcpServer::connectionHandler, this,
-              boost::ref(appendToSocketWrappersInUse(tcpSocketPtr)), boost::ref(parser)));
+        // Timers may have been scheduled before the loop existed
+        ioService.post(std::bind(&TcpServer::startTicking, this));
     }
+
+    waitForTraceDumpSignal();
+
+    eventLoopThread = std::thread([this]()
+    {
+        // The only thread which SIGUSR1 is delivered to; see main()
+        sigset_t traceDumpSignalSet;
+        sigemptyset(&traceDumpSignalSet);
+        sigaddset(&traceDumpSignalSet, SIGUSR1);
+        pthread_sigmask(SIG_UNBLOCK, &traceDumpSignalSet, nullptr);
+
+        // Keeps run() from returning while there's nothing to do
+        BoostIoService::work idleWork(ioService);
+        ioService.run();
+    });
+}
+
+/**
+ * Arms tickTimer if it isn't already armed. Executed on eventLoopThread.
+ */
+void TcpServer::startTicking()
+{
+    if (ticking)
+    {
+        return;
+    }
+    ticking = true;
+    tickTimer.expires_from_now(TimerWheel::TICK_DURATION);
+    tickTimer.async_wait(std::bind(&TcpServer::tickHandler, this, std::placeholders::_1));
+}
+
+/**
+ * Re-arms tickTimer one tick after its previous expiry, so that ticks don't
+ * drift by the time spent handling each one
+ */
+void TcpServer::scheduleNextTick()
+{
+    tickTimer.expires_at(tickTimer.expires_at() + TimerWheel::TICK_DURATION);
+    tickTimer.async_wait(std::bind(&TcpServer::tickHandler, this, std::placeholders::_1));
+}
+
+/**
+ * Turns the timer wheel, and keeps ticking only while it has pending timers
+ */
+void TcpServer::tickHandler(const boost::system::error_code& error)
+{
+    if (error)
+    {
+        ticking = false;
+        return;
+    }
+
+    if (timerWheel->advance())
+    {
+        scheduleNextTick();
+    }
+    else
+    {
+        ticking = false;
+    }
+}
+
+/**
+ * Writes the buffered request traces to traceFilePath each time SIGUSR1 is
+ * received. Executed on eventLoopThread.
+ */
+void TcpServer::waitForTraceDumpSignal()
+{
+    traceDumpSignals.async_wait([this](const boost::system::error_code& error, int)
+    {
+        if (error)
+        {
+            return;
+        }
+
+        try
+        {
+            RequestTracer::getInstance().writeChromeTrace(traceFilePath);
+            std::cout << "Wrote request traces to: " << traceFilePath << std::endl;
+        }
+        catch (std::exception& exception)
+        {
+            std::cout << "Failed to write request traces; " << exception.what() << std::endl;
+        }
+
+        waitForTraceDumpSignal();
+    });
 }
 
 /**
@@ -307,27 +534,35 @@ void TcpServer::terminate()
  * Creates a new SocketWrapper instance containing the TcpSocketSharedPointer
  * parameter as a member. Then, this new SocketWrapper is appended to the
  * socketWrappersInUse list. This access to socketWrappersInUse is locked
- * with the socketWrappersInUseMutex mutex. A reference to the newly created
- * SocketWrapper, within the list, is returned.
+ * with the socketWrappersInUseMutex mutex. The newly created SocketWrapper
+ * is returned. Throws a boost::system::system_error if the client has
+ * already disconnected.
  */
-SocketWrapper& TcpServer::appendToSocketWrappersInUse(TcpSocketSharedPtr& newSocket)
+SocketWrapperSharedPtr TcpServer::appendToSocketWrappersInUse(TcpSocketSharedPtr& newSocket)
 {
+    // Constructed before locking; it queries the socket's peer
+    SocketWrapperSharedPtr newSocketWrapper = std::make_shared<SocketWrapper>(newSocket,
+            topicSubscriptions);
+
     // Lock access to socketWrappersInUse
     std::lock_guard<std::mutex> lock{socketWrappersInUseMutex};
 
-    socketWrappersInUse.push_back(SocketWrapper(newSocket));
+    socketWrappersInUse.push_back(newSocketWrapper);
 
-    return socketWrappersInUse.back();
+    return newSocketWrapper;
 }
 
 /**
- * Removes the socketWrapper parameter from the socketWrappersInUse list.
+ * Removes the socketWrapper parameter from the socketWrappersInUse list, and
+ * from every topic it subscribed to.
  * The socketWrappersInUseMutex is used to lock this access to the list.
  * If the SocketWrapper parameter wasn't actually deleted from the list,
  * a std::runtime_error is thrown.
  */
-void TcpServer::removeFromSocketWrappersInUse(const SocketWrapper& socketWrapper)
+void TcpServer::removeFromSocketWrappersInUse(const SocketWrapperSharedPtr& socketWrapper)
 {
+    topicSubscriptions->unsubscribeFromAll(socketWrapper);
+
     // Lock access to socketWrappersInUse
     std::lock_guard<std::mutex> lock{socketWrappersInUseMutex};
 
@@ -346,26 +581,126 @@ void TcpServer::removeFromSocketWrappersInUse(const SocketWrapper& socketWrapper
 }
 
 /**
- * Iterates over the socketWrappersInUse list and writes the string contained
- * in UPDATED_PARAMETERS_AVAILABLE_STRING, with an additional timestamp, to the
- * socket corresponding to each element in the list. Each socket's write
- * operation is performed in a new thread.
+ * Sends inputEvent to every client which has subscribed to the "gpio" topic
+ * or to the event's pin's topic
  */
-void TcpServer::informAllClientsOfStateChange()
+void TcpServer::informSubscribedClientsOfGpioInput(const GpioInputEvent& inputEvent)
 {
-    std::time_t currTime = std::time(nullptr);
+    char microseconds[24] = {};
+    std::snprintf(microseconds, sizeof(microseconds), "%06ld",
+            inputEvent.timestamp.tv_nsec / 1000);
 
-    // Send out the update message string + a timestamp
-    const std::string updateMsg = UPDATED_PARAMETERS_AVAILABLE_STRING_PREFIX +
-            std::asctime(std::localtime(&currTime));
+    const std::string eventMsg = GPIO_INPUT_EVENT_STRING_PREFIX +
+            inputEvent.pinName + ":" + std::to_string(inputEvent.value) +
+            " @" + std::to_string(inputEvent.timestamp.tv_sec) + "." +
+            microseconds + "\n";
 
-    for (SocketWrapper& socketWrapper : socketWrappersInUse)
+    sendToClients(eventMsg, topicSubscriptions->getGpioSubscribers(inputEvent.pinName));
+}
+
+/**
+ * Sends the new volume to every client which has subscribed to the "volume"
+ * topic, and publishes it as a delta for "state" subscribers. Executed while
+ * volume changes are serialized; both are only queued, so this doesn't
+ * hold them up.
+ */
+void TcpServer::informSubscribedClientsOfVolumeChange(uint8_t volume)
+{
+    const std::string eventMsg = VOLUME_EVENT_STRING_PREFIX +
+            std::to_string(volume) + "\n";
+
+    sendToClients(eventMsg, topicSubscriptions->getSubscribers(TopicSubscriptions::VOLUME_TOPIC));
+
+    publishStateDelta(VOLUME_SUBSYSTEM, convertVolumeToFields(volume));
+}
+
+/**
+ * Publishes the output pins changed by one write as a delta for "state"
+ * subscribers. Pins whose state is no longer known have the value
+ * "unknown"; RESYNC snapshots leave them out. Executed while GPIO writes are
+ * held off, so it only numbers and queues the delta; the io_service writes
+ * it once the lock is dropped.
+ */
+void TcpServer::informSubscribedClientsOfOutputChange(
+        const GpioController::NamedOutputStates& changes,
+        const std::vector<std::string>& forgottenPins)
+{
+    StateJournal::Fields fields = convertOutputStatesToFields(changes);
+    for (const std::string& pinName : forgottenPins)
     {
-        boost::thread sendMsgThread(&SocketWrapper::sendDataVoidReturn,
-                socketWrapper, updateMsg);
+        fields.emplace_back(pinName, UNKNOWN_OUTPUT_STATE);
     }
+    publishStateDelta(GPIO_SUBSYSTEM, fields);
 }
 
+/**
+ * Volume and GPIO changes are each serialized by their own lock, but not
+ * with each other, so the delta's sequence number is taken and the delta
+ * queued to every subscriber under stateDeltaMutex. Each subscriber's queue
+ * then holds deltas in sequence order, and a client never sees N+1 before
+ * N. Queueing doesn't block, so neither does holding the mutex.
+ */
+void TcpServer::publishStateDelta(const std::string& subsystem,
+        const StateJournal::Fields& fields)
+{
+    std::lock_guard<std::mutex> deltaLock{stateDeltaMutex};
+    const std::string deltaMsg = stateJournal->append(subsystem, fields);
+    sendToClients(deltaMsg, topicSubscriptions->getSubscribers(TopicSubscriptions::STATE_TOPIC));
+}
+
+/**
+ * RESYNC snapshots hold the volume and the known output pin states
+ */
+void TcpServer::setStateSnapshotSources(const SystemUtilsSharedPtr& systemUtils,
+        const GpioControllerSharedPtr& gpioController)
+{
+    stateJournal->addSnapshotSource(VOLUME_SUBSYSTEM, [systemUtils]()
+    {
+        return convertVolumeToFields(systemUtils->getVolume());
+    });
+    stateJournal->addSnapshotSource(GPIO_SUBSYSTEM, [gpioController]()
+    {
+        return convertOutputStatesToFields(gpioController->getOutputStates());
+    });
+}
+
+StateJournal::Fields TcpServer::convertVolumeToFields(uint8_t volume)
+{
+    return StateJournal::Fields {{"level", std::to_string(volume)}};
+}
+
+/**
+ * Each pin's field is its name, with a value of 0 or 1
+ */
+StateJournal::Fields TcpServer::convertOutputStatesToFields(
+        const GpioController::NamedOutputStates& outputStates)
+{
+    StateJournal::Fields fields;
+    for (const std::pair<std::string, GpioController::OutputPinState>& outputState : outputStates)
+    {
+        fields.emplace_back(outputState.first,
+                outputState.second == GpioController::OutputPinState::HIGH ? "1" : "0");
+    }
+    return fields;
+}
+
+/**
+ * recipients is a snapshot, taken without holding any lock while sending,
+ * so that connections can be added and removed, and subscriptions changed,
+ * in the meantime. The event is only queued on each recipient, and written
+ * by the io_service, so this never blocks on a client which is slow to
+ * read; it's safe to call while holding the GPIO or volume locks. Each
+ * client receives its events in the order they were queued, interleaved
+ * with its responses.
+ */
+void TcpServer::sendToClients(const std::string& eventMsg,
+        const std::vector<SocketWrapperSharedPtr>& recipients)
+{
+    for (const SocketWrapperSharedPtr& socketWrapper : recipients)
+    {
+        socketWrapper->queueEvent(eventMsg);
+    }
+}
 
 /**
  * For the SVR_ADDR command, retrieve a list of this server's NICs (and their
@@ -391,10 +726,162 @@ void TcpServer::getClientsInfoHandler(const std::string& UNUSED,
     // Lock access to socketWrappersInUse
     std::lock_guard<std::mutex> lock{socketWrappersInUseMutex};
 
-    for (SocketWrapper socketWrapper : socketWrappersInUse)
+    for (const SocketWrapperSharedPtr& socketWrapper : socketWrappersInUse)
+    {
+        clientReturnableInfo->append("\nIP: " + socketWrapper->getIpAddress());
+        clientReturnableInfo->append("; Port: " + std::to_string(socketWrapper->getPortNumber()));
+    }
+}
+
+/**
+ * For the TIMER_STATS command; appends the number of pending timers and the
+ * lateness distribution of fired timers to clientReturnableInfo
+ */
+void TcpServer::getTimerStatsHandler(const std::string& UNUSED,
+        std::string* clientReturnableInfo)
+{
+    (void) UNUSED;
+
+    if (!timerWheel)
+    {
+        clientReturnableInfo->append("\nNo timer wheel in use");
+        return;
+    }
+
+    TimerWheel::JitterStats stats = timerWheel->getJitterStats();
+
+    clientReturnableInfo->append("\nPending: " + std::to_string(timerWheel->getPendingCount()));
+    clientReturnableInfo->append("\nFired: " + std::to_string(stats.timersFired));
+    clientReturnableInfo->append("\nLateness min(us): " + std::to_string(stats.minLatenessUs));
+    clientReturnableInfo->append("\nLateness max(us): " + std::to_string(stats.maxLatenessUs));
+    clientReturnableInfo->append("\nLateness mean(us): " + std::to_string(stats.meanLatenessUs));
+
+    for (size_t bucketIdx = 0; bucketIdx < stats.latenessBuckets.size(); ++bucketIdx)
+    {
+        if (bucketIdx < TimerWheel::LATENESS_BUCKET_LIMITS_US.size())
+        {
+            clientReturnableInfo->append("\nLateness <" +
+                    std::to_string(TimerWheel::LATENESS_BUCKET_LIMITS_US[bucketIdx]) + "us: ");
+        }
+        else
+        {
+            clientReturnableInfo->append("\nLateness >=" +
+                    std::to_string(TimerWheel::LATENESS_BUCKET_LIMITS_US.back()) + "us: ");
+        }
+        clientReturnableInfo->append(std::to_string(stats.latenessBuckets[bucketIdx]));
+    }
+}
+
+/**
+ * For the STATS command. Appends every counter, as "name{labels} value",
+ * and a summary of every histogram. Labelled counters which are still 0,
+ * such as those of commands which haven't been used, are left out.
+ */
+void TcpServer::getStatsHandler(const std::string& UNUSED, std::string* clientReturnableInfo)
+{
+    (void) UNUSED;
+
+    MetricsRegistry::Snapshot snapshot = MetricsRegistry::getInstance().takeSnapshot();
+
+    for (const MetricsRegistry::CounterSnapshot& counter : snapshot.counters)
+    {
+        if (!counter.info.labels.empty() && counter.value == 0)
+        {
+            continue;
+        }
+
+        clientReturnableInfo->append("\n" + counter.info.name);
+        if (!counter.info.labels.empty())
+        {
+            clientReturnableInfo->append("{" + counter.info.labels + "}");
+        }
+        clientReturnableInfo->append(" " + std::to_string(counter.value));
+    }
+
+    for (const MetricsRegistry::HistogramSnapshot& histogram : snapshot.histograms)
+    {
+        clientReturnableInfo->append("\n" + histogram.info.name);
+        if (!histogram.info.labels.empty())
+        {
+            clientReturnableInfo->append("{" + histogram.info.labels + "}");
+        }
+        clientReturnableInfo->append(" count=" + std::to_string(histogram.count));
+        if (histogram.count == 0)
+        {
+            continue;
+        }
+
+        clientReturnableInfo->append(" mean=" + std::to_string(histogram.sum / histogram.count) +
+                " p50=" + std::to_string(histogram.getPercentile(0.5)) +
+                " p90=" + std::to_string(histogram.getPercentile(0.9)) +
+                " p99=" + std::to_string(histogram.getPercentile(0.99)) +
+                " p999=" + std::to_string(histogram.getPercentile(0.999)) +
+                " max=" + std::to_string(histogram.max));
+    }
+}
+
+/**
+ * For the TRACE_DUMP command; appends every buffered request trace, in the
+ * Chrome trace event format, on a single line
+ */
+void TcpServer::getTraceDumpHandler(const std::string& UNUSED, std::string* clientReturnableInfo)
+{
+    (void) UNUSED;
+    clientReturnableInfo->append("\n" + RequestTracer::getInstance().renderChromeTrace());
+}
+
+/**
+ * For the TRACE_SAMPLE command; traces 1 in sampleIntervalAsStr requests
+ * from here on, where 0 stops tracing. Throws std::invalid_argument if the
+ * interval isn't a number.
+ */
+void TcpServer::setTraceSampleIntervalHandler(const std::string& sampleIntervalAsStr,
+        std::string* clientReturnableInfo)
+{
+    (void) clientReturnableInfo;
+
+    size_t charsParsed = 0;
+    unsigned long sampleInterval = std::stoul(sampleIntervalAsStr, &charsParsed);
+    if (charsParsed != sampleIntervalAsStr.length() || sampleInterval > UINT32_MAX)
+    {
+        throw std::invalid_argument("Sample interval: " + sampleIntervalAsStr +
+                " is invalid");
+    }
+
+    RequestTracer::getInstance().setSampleInterval(static_cast<uint32_t>(sampleInterval));
+}
+
+/**
+ * For the RESYNC command. Returns the deltas journalled after
+ * lastSeqAsStr, one "~DELTA" line each, or if they aren't all journalled, a
+ * "~SNAPSHOT <seq>" line followed by a "~STATE" line per subsystem. Clients
+ * should subscribe to "state" first, so no delta is missed in between, and
+ * skip pushed deltas which aren't newer than what they've applied. Throws
+ * std::invalid_argument if lastSeqAsStr isn't a number.
+ */
+void TcpServer::resyncHandler(const std::string& lastSeqAsStr, std::string* clientReturnableInfo)
+{
+    size_t charsParsed = 0;
+    unsigned long long lastSeq = std::stoull(lastSeqAsStr, &charsParsed);
+    if (charsParsed != lastSeqAsStr.length())
+    {
+        throw std::invalid_argument("Sequence number: " + lastSeqAsStr + " is invalid");
+    }
+
+    std::string resyncInfo;
+    if (stateJournal->resync(lastSeq, resyncInfo))
+    {
+        SNAPSHOT_RESYNCS.increment();
+    }
+    else
+    {
+        DELTA_RESYNCS.increment();
+    }
+
+    if (!resyncInfo.empty())
     {
-        clientReturnableInfo->append("\nIP: " + socketWrapper.getIpAddress());
-        clientReturnableInfo->append("; Port: " + std::to_string(socketWrapper.getPortNumber()));
+        resyncInfo.pop_back();
+        clientReturnableInfo->append("\n" + resyncInfo);
     }
 }
 
@@ -419,15 +906,34 @@ TcpServer::Builder& TcpServer::Builder::withPassword(const std::string& password
     return *this;
 }
 
+/**
+ * Specifies the TimerWheel which this instance's event loop will turn
+ */
+TcpServer::Builder& TcpServer::Builder::withTimerWheel(const TimerWheelSharedPtr& timerWheel)
+{
+    this->timerWheel = timerWheel;
+    return *this;
+}
+
+/**
+ * Specifies the file which request traces are written to on SIGUSR1
+ */
+TcpServer::Builder& TcpServer::Builder::withTraceFile(const std::string& traceFilePath)
+{
+    this->traceFilePath = traceFilePath;
+    return *this;
+}
+
 TcpServerSharedPtr TcpServer::Builder::build() const
 {
     if (usePassword)
     {
-        return TcpServerSharedPtr(new TcpServer(port, password.c_str()));
+        return TcpServerSharedPtr(new TcpServer(port, password.c_str(), timerWheel,
+                traceFilePath));
     }
     else
     {
-        return TcpServerSharedPtr(new TcpServer(port, nullptr));
+        return TcpServerSharedPtr(new TcpServer(port, nullptr, timerWheel, traceFilePath));
     }
 }
 
@@ -10,15 +10,23 @@
 
 // System Includes
 #include <boost/asio.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
 #include <cstdint>
 #include <list>
 #include <vector>
 #include <string>
 #include <memory>
+#include <thread>
 
 // Project Includes
 #include "SocketWrapper.hpp"
 #include "CommandParser.hpp"
+#include "GpioInputMonitor.hpp"
+#include "MetricsRegistry.hpp"
+#include "StateJournal.hpp"
+#include "TimerWheel.hpp"
+#include "TopicSubscriptions.hpp"
 
 // Forward declarations
 class TcpServer;
@@ -31,46 +39,92 @@ using TcpServerSharedPtr = std::shared_ptr<TcpServer>;
 
 class TcpServer
 {
+    // Benchmarks terminateResponse(), and connects its client to
+    // topicSubscriptions; see bench/HotPathBench.cpp
+    friend class HotPathBench;
+
 public:
 
     class Builder
     {
     public:
         Builder() : port(DEFAULT_PORT), usePassword(false),
-                             password(DEFAULT_PASSWORD) {};
+                             password(DEFAULT_PASSWORD),
+                             traceFilePath(DEFAULT_TRACE_FILE_PATH) {};
 
         Builder& withPort(uint16_t port);
         Builder& withPassword(const std::string& password);
         Builder& withoutPassword();
+        Builder& withTimerWheel(const TimerWheelSharedPtr& timerWheel);
+        Builder& withTraceFile(const std::string& traceFilePath);
         TcpServerSharedPtr build() const;
 
     private:
         uint16_t port;
         bool usePassword;
         std::string password;
+        TimerWheelSharedPtr timerWheel;
+        std::string traceFilePath;
     };
 
-    void informAllClientsOfStateChange();
+    ~TcpServer();
+
+    void informSubscribedClientsOfGpioInput(const GpioInputEvent& inputEvent);
+    void informSubscribedClientsOfVolumeChange(uint8_t volume);
+    void informSubscribedClientsOfOutputChange(const GpioController::NamedOutputStates& changes,
+            const std::vector<std::string>& forgottenPins);
+
+    // Where RESYNC's snapshots are read from
+    void setStateSnapshotSources(const SystemUtilsSharedPtr& systemUtils,
+            const GpioControllerSharedPtr& gpioController);
     void run(CommandParser& parser);
     void terminate();
 
     // Interpreter-executable commands
     void getAddressInfoHandler(const std::string& UNUSED, std::string* clientReturnableInfo);
     void getClientsInfoHandler(const std::string& UNUSED, std::string* clientReturnableInfo);
+    void getTimerStatsHandler(const std::string& UNUSED, std::string* clientReturnableInfo);
+    void getStatsHandler(const std::string& UNUSED, std::string* clientReturnableInfo);
+    void getTraceDumpHandler(const std::string& UNUSED, std::string* clientReturnableInfo);
+    void setTraceSampleIntervalHandler(const std::string& sampleIntervalAsStr,
+            std::string* clientReturnableInfo);
+    void resyncHandler(const std::string& lastSeqAsStr, std::string* clientReturnableInfo);
 
 private:
-    TcpServer(const uint16_t port=DEFAULT_PORT, const char * const password=DEFAULT_PASSWORD);
+    TcpServer(const uint16_t port=DEFAULT_PORT, const char * const password=DEFAULT_PASSWORD,
+            const TimerWheelSharedPtr& timerWheel=nullptr,
+            const std::string& traceFilePath=DEFAULT_TRACE_FILE_PATH);
+
+    // Event loop, run on eventLoopThread
+    void startEventLoop();
+    void startTicking();
+    void scheduleNextTick();
+    void tickHandler(const boost::system::error_code& error);
+    void waitForTraceDumpSignal();
 
     // General info retrieval and print functions
     std::string getServerInfo();
     std::vector<std::string> getLocalIpAddresses();
 
     // Thread to be executed for each client
-    void connectionHandler(SocketWrapper& sockWrap, CommandParser& parser);
+    void connectionHandler(SocketWrapperSharedPtr sockWrapPtr, CommandParser& parser);
+    static void terminateResponse(std::string& response);
 
     // Locked mutators for socketWrappersInUse
-    SocketWrapper& appendToSocketWrappersInUse(TcpSocketSharedPtr& newSocket);
-    void removeFromSocketWrappersInUse(const SocketWrapper& sockWrapper);
+    SocketWrapperSharedPtr appendToSocketWrappersInUse(TcpSocketSharedPtr& newSocket);
+    void removeFromSocketWrappersInUse(const SocketWrapperSharedPtr& sockWrapper);
+
+    // Queues eventMsg to each of recipients, without blocking
+    void sendToClients(const std::string& eventMsg,
+            const std::vector<SocketWrapperSharedPtr>& recipients);
+
+    // Journals a state change, and queues the delta to "state" subscribers
+    void publishStateDelta(const std::string& subsystem, const StateJournal::Fields& fields);
+
+    // State delta fields
+    static StateJournal::Fields convertVolumeToFields(uint8_t volume);
+    static StateJournal::Fields convertOutputStatesToFields(
+            const GpioController::NamedOutputStates& outputStates);
 
     // Authentication of clients which are trying to connect
     bool authenticate(SocketWrapper& socketWrap, BoostStreamBuff& socketReadStreamBuff);
@@ -88,19 +142,55 @@ private:
 
     BoostTcp::acceptor acceptor;
 
+    // Turned by tickTimer on the event loop while it has pending timers
+    const TimerWheelSharedPtr timerWheel;
+    boost::asio::steady_timer tickTimer;
+
+    // Whether tickTimer is currently armed; only accessed on eventLoopThread
+    bool ticking;
+
+    // Request traces are written here when SIGUSR1 is received
+    const std::string traceFilePath;
+    boost::asio::signal_set traceDumpSignals;
+
+    // Runs ioService's handlers; the accept loop stays on the caller of run()
+    std::thread eventLoopThread;
+
     // List of sockets and associated mutexes
-    std::list<SocketWrapper> socketWrappersInUse;
+    std::list<SocketWrapperSharedPtr> socketWrappersInUse;
 
     // Used to synchronize addition and deletion operations
     // on the socketWrappersInUse vector
     std::mutex socketWrappersInUseMutex;
 
-    static const std::string UPDATED_PARAMETERS_AVAILABLE_STRING_PREFIX;
+    // The clients subscribed to each push notification topic
+    const TopicSubscriptionsSharedPtr topicSubscriptions;
+
+    // Every state change, as pushed to "state" subscribers, for RESYNC
+    const StateJournalSharedPtr stateJournal;
+
+    // Held from numbering a delta until it's queued to every subscriber,
+    // so the volume and GPIO threads can't queue deltas out of order
+    std::mutex stateDeltaMutex;
+
+    static const std::string GPIO_INPUT_EVENT_STRING_PREFIX;
+    static const std::string VOLUME_EVENT_STRING_PREFIX;
+    static const std::string VOLUME_SUBSYSTEM;
+    static const std::string GPIO_SUBSYSTEM;
+    static const std::string UNKNOWN_OUTPUT_STATE;
+
+    static const MetricsRegistry::Counter ACCEPTED_CONNECTIONS;
+    static const MetricsRegistry::Counter AUTH_SUCCESSES;
+    static const MetricsRegistry::Counter AUTH_FAILURES;
+    static const MetricsRegistry::Counter DELTA_RESYNCS;
+    static const MetricsRegistry::Counter SNAPSHOT_RESYNCS;
     static const std::string REQUESTING_PASSWORD_STRING_PREFIX;
     static const std::string END_OF_RESPONSE_STRING;
+    static const std::chrono::milliseconds ACCEPT_RETRY_DELAY;
     static const std::string SOCKET_READ_UNTIL_END_SPECIFIER;
     static const uint16_t DEFAULT_PORT = 2018;
     static const char * const DEFAULT_PASSWORD;
+    static const char * const DEFAULT_TRACE_FILE_PATH;
     static const std::string AUTH_SUCCESSFUL_STRING;
     static const std::string AUTH_FAILED_STRING;
 
@@ -0,0 +1,138 @@
+/*
+ * TopicSubscriptions.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+// System Includes
+#include <stdexcept>
+
+// Project Includes
+#include "TopicSubscriptions.hpp"
+
+// Static initialization
+const std::string TopicSubscriptions::VOLUME_TOPIC = "volume";
+const std::string TopicSubscriptions::STATE_TOPIC = "state";
+const std::string TopicSubscriptions::GPIO_TOPIC = "gpio";
+const char TopicSubscriptions::PIN_SEPARATOR = ':';
+
+/**
+ * Adds client to topic's subscribers; subscribing twice has no further effect
+ */
+void TopicSubscriptions::subscribe(const std::string& topic, const SocketWrapperSharedPtr& client)
+{
+    validateTopic(topic);
+
+    std::lock_guard<std::mutex> lock{subscribersMutex};
+    subscribersByTopic[topic].insert(client);
+}
+
+/**
+ * Removes client from topic's subscribers, if it was one
+ */
+void TopicSubscriptions::unsubscribe(const std::string& topic, const SocketWrapperSharedPtr& client)
+{
+    validateTopic(topic);
+
+    std::lock_guard<std::mutex> lock{subscribersMutex};
+    auto topicIter = subscribersByTopic.find(topic);
+    if (topicIter == subscribersByTopic.end())
+    {
+        return;
+    }
+
+    topicIter->second.erase(client);
+    if (topicIter->second.empty())
+    {
+        subscribersByTopic.erase(topicIter);
+    }
+}
+
+/**
+ * Removes client from every topic's subscribers. This must be called when a
+ * client disconnects, as the subscriber sets keep their clients alive.
+ */
+void TopicSubscriptions::unsubscribeFromAll(const SocketWrapperSharedPtr& client)
+{
+    std::lock_guard<std::mutex> lock{subscribersMutex};
+    for (auto topicIter = subscribersByTopic.begin(); topicIter != subscribersByTopic.end();)
+    {
+        topicIter->second.erase(client);
+        if (topicIter->second.empty())
+        {
+            topicIter = subscribersByTopic.erase(topicIter);
+        }
+        else
+        {
+            ++topicIter;
+        }
+    }
+}
+
+/**
+ * Returns topic's subscribers. For a pin's events, use getGpioSubscribers().
+ */
+std::vector<SocketWrapperSharedPtr> TopicSubscriptions::getSubscribers(
+        const std::string& topic) const
+{
+    std::lock_guard<std::mutex> lock{subscribersMutex};
+    auto topicIter = subscribersByTopic.find(topic);
+    if (topicIter == subscribersByTopic.end())
+    {
+        return {};
+    }
+    return std::vector<SocketWrapperSharedPtr>(topicIter->second.begin(), topicIter->second.end());
+}
+
+/**
+ * Returns the clients subscribed to either all pins' events or pinName's
+ */
+std::vector<SocketWrapperSharedPtr> TopicSubscriptions::getGpioSubscribers(
+        const std::string& pinName) const
+{
+    std::lock_guard<std::mutex> lock{subscribersMutex};
+    auto allPinsIter = subscribersByTopic.find(GPIO_TOPIC);
+    auto pinIter = subscribersByTopic.find(GPIO_TOPIC + PIN_SEPARATOR + pinName);
+
+    std::vector<SocketWrapperSharedPtr> subscribers;
+    if (allPinsIter != subscribersByTopic.end())
+    {
+        subscribers.assign(allPinsIter->second.begin(), allPinsIter->second.end());
+    }
+    if (pinIter != subscribersByTopic.end())
+    {
+        for (const SocketWrapperSharedPtr& subscriber : pinIter->second)
+        {
+            if (allPinsIter == subscribersByTopic.end() || allPinsIter->second.count(subscriber) == 0)
+            {
+                subscribers.push_back(subscriber);
+            }
+        }
+    }
+    return subscribers;
+}
+
+/**
+ * Throws a std::invalid_argument unless topic is "volume", "state", "gpio",
+ * or "gpio:" followed by a pin name. Pin names aren't checked against the
+ * registered pins; a topic for an unknown pin never has events.
+ */
+void TopicSubscriptions::validateTopic(const std::string& topic)
+{
+    if (topic == VOLUME_TOPIC || topic == STATE_TOPIC || topic == GPIO_TOPIC)
+    {
+        return;
+    }
+
+    const std::string pinTopicPrefix = GPIO_TOPIC + PIN_SEPARATOR;
+    if (topic.compare(0, pinTopicPrefix.length(), pinTopicPrefix) == 0 &&
+            topic.length() > pinTopicPrefix.length() &&
+            topic.find(PIN_SEPARATOR, pinTopicPrefix.length()) == std::string::npos)
+    {
+        return;
+    }
+
+    throw std::invalid_argument("Topic: " + topic + " invalid; it must be " + VOLUME_TOPIC +
+            ", " + STATE_TOPIC + ", " + GPIO_TOPIC + ", or " + pinTopicPrefix + "PinName");
+}
@@ -0,0 +1,69 @@
+/*
+ * TopicSubscriptions.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+#ifndef NETWORK_TOPICSUBSCRIPTIONS_HPP_
+#define NETWORK_TOPICSUBSCRIPTIONS_HPP_
+
+// System Includes
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Project Includes
+// <none>
+
+// Forward declarations
+class SocketWrapper;
+class TopicSubscriptions;
+
+// Using statements
+using SocketWrapperSharedPtr = std::shared_ptr<SocketWrapper>;
+using TopicSubscriptionsSharedPtr = std::shared_ptr<TopicSubscriptions>;
+
+/**
+ * The clients subscribed to each push notification topic, so that an event
+ * is only sent to the clients which asked for it, without visiting every
+ * connected client. The topics are:
+ *   - "volume": volume changes, from any source
+ *   - "state": sequence numbered deltas of every state change; see
+ *     StateJournal
+ *   - "gpio": input edge events on every pin
+ *   - "gpio:<pinName>": input edge events on the named pin only
+ * A client subscribed to both "gpio" and "gpio:<pinName>" receives each of
+ * that pin's events once.
+ */
+class TopicSubscriptions
+{
+public:
+    // Throw a std::invalid_argument if topic isn't one of the above
+    void subscribe(const std::string& topic, const SocketWrapperSharedPtr& client);
+    void unsubscribe(const std::string& topic, const SocketWrapperSharedPtr& client);
+
+    // For disconnecting clients
+    void unsubscribeFromAll(const SocketWrapperSharedPtr& client);
+
+    std::vector<SocketWrapperSharedPtr> getSubscribers(const std::string& topic) const;
+    std::vector<SocketWrapperSharedPtr> getGpioSubscribers(const std::string& pinName) const;
+
+    static const std::string VOLUME_TOPIC;
+    static const std::string STATE_TOPIC;
+    static const std::string GPIO_TOPIC;
+    static const char PIN_SEPARATOR;
+
+private:
+    static void validateTopic(const std::string& topic);
+
+    // Subscribers by topic; topics without subscribers are removed, so that
+    // subscribing to many pin names and leaving doesn't grow this
+    std::unordered_map<std::string, std::set<SocketWrapperSharedPtr>> subscribersByTopic;
+    mutable std::mutex subscribersMutex;
+};
+
+#endif /* NETWORK_TOPICSUBSCRIPTIONS_HPP_ */
@@ -0,0 +1,405 @@
+/*
+ * TimerWheel.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+// System Includes
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Project Includes
+#include "TimerWheel.hpp"
+
+// Static initialization
+const TimerWheel::TimerId TimerWheel::INVALID_TIMER_ID;
+const uint32_t TimerWheel::LEVELS;
+const uint32_t TimerWheel::SLOT_BITS;
+const uint32_t TimerWheel::SLOTS_PER_LEVEL;
+const uint32_t TimerWheel::SLOT_MASK;
+const uint32_t TimerWheel::NIL;
+const TimerWheel::Clock::duration TimerWheel::TICK_DURATION = std::chrono::milliseconds(1);
+
+const std::vector<int64_t> TimerWheel::LATENESS_BUCKET_LIMITS_US = {100, 250, 500, 1000, 2000, 5000, 10000};
+
+/**
+ * Constructs an empty wheel whose tick 0 is the time of construction
+ */
+TimerWheel::TimerWheel() :
+        startTime(Clock::now()), currentTick(0), pendingCount(0),
+        timersFired(0), minLatenessUs(std::numeric_limits<int64_t>::max()),
+        maxLatenessUs(std::numeric_limits<int64_t>::min()), totalLatenessUs(0),
+        latenessBuckets(LATENESS_BUCKET_LIMITS_US.size() + 1, 0)
+{
+    std::fill(std::begin(slotHeads), std::end(slotHeads), NIL);
+}
+
+/**
+ * Schedules callback to be executed once delay has elapsed. The timer is
+ * rounded up to the next tick boundary, and will never fire on the tick in
+ * which it was scheduled. Returns an id which can be passed to cancel().
+ */
+TimerWheel::TimerId TimerWheel::schedule(std::chrono::milliseconds delay,
+        const TimerCallback& callback)
+{
+    if (delay.count() < 0)
+    {
+        delay = std::chrono::milliseconds(0);
+    }
+
+    bool wasIdle = false;
+    TimerId timerId;
+    WakeupCallback wakeup;
+    {
+        std::lock_guard<std::mutex> lock{wheelMutex};
+
+        uint64_t realTick = getCurrentRealTick();
+
+        // While idle, advance() doesn't turn the wheel, so catch it up here
+        if (pendingCount == 0)
+        {
+            wasIdle = true;
+            currentTick = std::max(currentTick, realTick);
+        }
+
+        // Round up, so the timer never fires before its due time
+        Clock::time_point now = Clock::now();
+        uint64_t dueTick = static_cast<uint64_t>(((now - startTime) + delay +
+                TICK_DURATION - Clock::duration(1)) / TICK_DURATION);
+
+        uint32_t nodeIdx = allocateNode();
+        TimerNode& node = nodePool[nodeIdx];
+        node.expiryTick = std::max(dueTick, currentTick + 1);
+        node.dueTime = now + delay;
+        node.callback = callback;
+
+        insertNode(nodeIdx);
+        ++pendingCount;
+
+        timerId = makeTimerId(nodeIdx, node.generation);
+
+        // Copied under the lock, as setWakeupCallback() may replace it
+        if (wasIdle)
+        {
+            wakeup = wakeupCallback;
+        }
+    }
+
+    if (wakeup)
+    {
+        wakeup();
+    }
+
+    return timerId;
+}
+
+/**
+ * Cancels the timer identified by timerId. Returns true if the timer was
+ * pending and has been removed, or false if it had already fired, had
+ * already been cancelled, or never existed.
+ */
+bool TimerWheel::cancel(TimerId timerId)
+{
+    uint32_t nodeIdx = static_cast<uint32_t>(timerId >> 32);
+    uint32_t generation = static_cast<uint32_t>(timerId);
+
+    std::lock_guard<std::mutex> lock{wheelMutex};
+
+    if (timerId == INVALID_TIMER_ID || nodeIdx >= nodePool.size())
+    {
+        return false;
+    }
+
+    TimerNode& node = nodePool[nodeIdx];
+    if (!node.inUse || node.generation != generation)
+    {
+        return false;
+    }
+
+    unlinkNode(nodeIdx);
+    releaseNode(nodeIdx);
+    --pendingCount;
+    return true;
+}
+
+/**
+ * Turns the wheel forward to the current time, executing every timer which
+ * has come due along the way. Returns true if timers remain pending
+ * afterwards, which tells the caller whether it needs to keep ticking.
+ */
+bool TimerWheel::advance()
+{
+    std::vector<std::pair<TimerCallback, Clock::time_point>> expired;
+    bool stillPending;
+    {
+        std::lock_guard<std::mutex> lock{wheelMutex};
+
+        uint64_t realTick = getCurrentRealTick();
+
+        if (pendingCount == 0)
+        {
+            currentTick = std::max(currentTick, realTick);
+        }
+
+        while (currentTick < realTick && pendingCount != 0)
+        {
+            step(expired);
+        }
+
+        stillPending = pendingCount != 0;
+    }
+
+    for (auto& expiredTimer : expired)
+    {
+        Clock::time_point firedAt = Clock::now();
+        int64_t latenessUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                firedAt - expiredTimer.second).count();
+
+        try
+        {
+            expiredTimer.first();
+        }
+        catch (const std::exception& err)
+        {
+            std::cerr << "TimerWheel: timer callback threw: " << err.what() << std::endl;
+        }
+
+        std::lock_guard<std::mutex> lock{wheelMutex};
+        recordLateness(latenessUs);
+    }
+
+    return stillPending;
+}
+
+/**
+ * Returns the number of timers which have been scheduled but have neither
+ * fired nor been cancelled
+ */
+size_t TimerWheel::getPendingCount()
+{
+    std::lock_guard<std::mutex> lock{wheelMutex};
+    return pendingCount;
+}
+
+/**
+ * Returns a copy of the lateness statistics gathered over all fired timers.
+ * Lateness is measured from the time requested in schedule() to the moment
+ * just before the callback was executed.
+ */
+TimerWheel::JitterStats TimerWheel::getJitterStats()
+{
+    std::lock_guard<std::mutex> lock{wheelMutex};
+
+    JitterStats stats;
+    stats.timersFired = timersFired;
+    stats.minLatenessUs = timersFired ? minLatenessUs : 0;
+    stats.maxLatenessUs = timersFired ? maxLatenessUs : 0;
+    stats.meanLatenessUs = timersFired ?
+            static_cast<double>(totalLatenessUs) / timersFired : 0.0;
+    stats.latenessBuckets = latenessBuckets;
+    return stats;
+}
+
+void TimerWheel::setWakeupCallback(const WakeupCallback& callback)
+{
+    std::lock_guard<std::mutex> lock{wheelMutex};
+    wakeupCallback = callback;
+}
+
+/**
+ * Processes a single tick: cascades higher levels down when level 0 wraps,
+ * then moves every timer in the current level 0 slot onto expired.
+ * Expects wheelMutex to be held.
+ */
+void TimerWheel::step(std::vector<std::pair<TimerCallback, Clock::time_point>>& expired)
+{
+    ++currentTick;
+
+    // When a level's index wraps to 0, the next slot of the level above it
+    // is redistributed
+    for (uint32_t level = 1; level < LEVELS; ++level)
+    {
+        if (((currentTick >> (SLOT_BITS * (level - 1))) & SLOT_MASK) != 0)
+        {
+            break;
+        }
+        cascade(level);
+    }
+
+    uint32_t slotIdx = static_cast<uint32_t>(currentTick & SLOT_MASK);
+    while (slotHeads[slotIdx] != NIL)
+    {
+        uint32_t nodeIdx = slotHeads[slotIdx];
+        TimerNode& node = nodePool[nodeIdx];
+
+        unlinkNode(nodeIdx);
+        expired.push_back(std::make_pair(std::move(node.callback), node.dueTime));
+        releaseNode(nodeIdx);
+        --pendingCount;
+    }
+}
+
+/**
+ * Removes every timer from the current slot of level and re-inserts it,
+ * which places it on a lower level now that it's closer to expiring.
+ * Expects wheelMutex to be held.
+ */
+void TimerWheel::cascade(uint32_t level)
+{
+    uint32_t slot = static_cast<uint32_t>((currentTick >> (SLOT_BITS * level)) & SLOT_MASK);
+    uint32_t slotIdx = level * SLOTS_PER_LEVEL + slot;
+
+    uint32_t nodeIdx = slotHeads[slotIdx];
+    slotHeads[slotIdx] = NIL;
+
+    while (nodeIdx != NIL)
+    {
+        uint32_t nextIdx = nodePool[nodeIdx].next;
+        insertNode(nodeIdx);
+        nodeIdx = nextIdx;
+    }
+}
+
+/**
+ * Links nodeIdx into the slot appropriate for its expiry relative to
+ * currentTick. Timers further out than the wheel can represent are parked in
+ * the last slot visited on the top level and get re-cascaded until they fit.
+ * Expects wheelMutex to be held.
+ */
+void TimerWheel::insertNode(uint32_t nodeIdx)
+{
+    TimerNode& node = nodePool[nodeIdx];
+    uint64_t ticksUntilExpiry = node.expiryTick - currentTick;
+
+    uint32_t level = 0;
+    while (level < LEVELS - 1 &&
+           ticksUntilExpiry >= (static_cast<uint64_t>(1) << (SLOT_BITS * (level + 1))))
+    {
+        ++level;
+    }
+
+    uint64_t expiryTick = node.expiryTick;
+    if (ticksUntilExpiry >= (static_cast<uint64_t>(1) << (SLOT_BITS * LEVELS)))
+    {
+        expiryTick = currentTick + (static_cast<uint64_t>(1) << (SLOT_BITS * LEVELS)) - 1;
+    }
+
+    uint32_t slot = static_cast<uint32_t>((expiryTick >> (SLOT_BITS * level)) & SLOT_MASK);
+    uint32_t slotIdx = level * SLOTS_PER_LEVEL + slot;
+
+    node.slotIdx = slotIdx;
+    node.prev = NIL;
+    node.next = slotHeads[slotIdx];
+    if (node.next != NIL)
+    {
+        nodePool[node.next].prev = nodeIdx;
+    }
+    slotHeads[slotIdx] = nodeIdx;
+}
+
+/**
+ * Removes nodeIdx from whichever slot list it's in.
+ * Expects wheelMutex to be held.
+ */
+void TimerWheel::unlinkNode(uint32_t nodeIdx)
+{
+    TimerNode& node = nodePool[nodeIdx];
+
+    if (node.prev != NIL)
+    {
+        nodePool[node.prev].next = node.next;
+    }
+    else
+    {
+        slotHeads[node.slotIdx] = node.next;
+    }
+
+    if (node.next != NIL)
+    {
+        nodePool[node.next].prev = node.prev;
+    }
+
+    node.prev = NIL;
+    node.next = NIL;
+}
+
+/**
+ * Takes a node from the free list, growing the pool if it's empty.
+ * Expects wheelMutex to be held.
+ */
+uint32_t TimerWheel::allocateNode()
+{
+    uint32_t nodeIdx;
+    if (!freeNodes.empty())
+    {
+        nodeIdx = freeNodes.back();
+        freeNodes.pop_back();
+    }
+    else
+    {
+        nodeIdx = static_cast<uint32_t>(nodePool.size());
+        TimerNode node = {};
+        // Start at 1 so that no id is ever equal to INVALID_TIMER_ID
+        node.generation = 1;
+        nodePool.push_back(node);
+    }
+
+    nodePool[nodeIdx].inUse = true;
+    return nodeIdx;
+}
+
+/**
+ * Returns nodeIdx to the free list and invalidates any outstanding TimerId
+ * which refers to it. Expects wheelMutex to be held.
+ */
+void TimerWheel::releaseNode(uint32_t nodeIdx)
+{
+    TimerNode& node = nodePool[nodeIdx];
+    node.inUse = false;
+    node.callback = nullptr;
+    ++node.generation;
+    if (node.generation == 0)
+    {
+        node.generation = 1;
+    }
+    freeNodes.push_back(nodeIdx);
+}
+
+/**
+ * Returns the tick which the current time falls into
+ */
+uint64_t TimerWheel::getCurrentRealTick() const
+{
+    return static_cast<uint64_t>((Clock::now() - startTime) / TICK_DURATION);
+}
+
+/**
+ * Expects wheelMutex to be held
+ */
+void TimerWheel::recordLateness(int64_t latenessUs)
+{
+    ++timersFired;
+    minLatenessUs = std::min(minLatenessUs, latenessUs);
+    maxLatenessUs = std::max(maxLatenessUs, latenessUs);
+    totalLatenessUs += latenessUs;
+
+    size_t bucketIdx = 0;
+    while (bucketIdx < LATENESS_BUCKET_LIMITS_US.size() &&
+           latenessUs >= LATENESS_BUCKET_LIMITS_US[bucketIdx])
+    {
+        ++bucketIdx;
+    }
+    ++latenessBuckets[bucketIdx];
+}
+
+TimerWheel::TimerId TimerWheel::makeTimerId(uint32_t nodeIdx, uint32_t generation)
+{
+    return (static_cast<TimerId>(nodeIdx) << 32) | generation;
+}
@@ -0,0 +1,151 @@
+/*
+ * TimerWheel.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+#ifndef SCHEDULER_TIMERWHEEL_HPP_
+#define SCHEDULER_TIMERWHEEL_HPP_
+
+// System Includes
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Project Includes
+// <none>
+
+// Forward declarations
+class TimerWheel;
+using TimerWheelSharedPtr = std::shared_ptr<TimerWheel>;
+
+/**
+ * A hierarchical timing wheel with LEVELS levels of SLOTS_PER_LEVEL slots.
+ * Each tick is TICK_DURATION long; level 0 holds timers due within the next
+ * SLOTS_PER_LEVEL ticks, and each higher level covers SLOTS_PER_LEVEL times
+ * the range of the one below it. Timers on higher levels are cascaded down
+ * as the wheel turns.
+ *
+ * Timers live in a pool and are linked into their slot with an intrusive
+ * doubly-linked list, so that schedule() and cancel() are both O(1).
+ * advance() is expected to be called roughly once per tick by some event
+ * loop; it fires every timer which has come due since the last call.
+ *
+ * All public functions are thread safe. Callbacks are executed by the thread
+ * which calls advance(), without any internal lock held, so they may freely
+ * schedule or cancel other timers.
+ */
+class TimerWheel
+{
+public:
+    // Identifies a scheduled timer: its pool slot, and a 32 bit generation
+    // which changes each time the slot is reused. Cancelling an id whose
+    // timer has already fired is harmless, unless the slot has since been
+    // reused 2^32 times and the generation has wrapped back around to it.
+    using TimerId = uint64_t;
+    using TimerCallback = std::function<void()>;
+    using Clock = std::chrono::steady_clock;
+
+    // Executed whenever the wheel goes from having no pending timers to
+    // having one, so that an idle event loop knows to start ticking again
+    using WakeupCallback = std::function<void()>;
+
+    // Lateness of fired timers relative to their requested due time
+    struct JitterStats
+    {
+        uint64_t timersFired;
+        int64_t minLatenessUs;
+        int64_t maxLatenessUs;
+        double meanLatenessUs;
+
+        // Histogram counts; bucket i counts lateness below
+        // LATENESS_BUCKET_LIMITS_US[i], and the final bucket everything else
+        std::vector<uint64_t> latenessBuckets;
+    };
+
+    static const TimerId INVALID_TIMER_ID = 0;
+    static const Clock::duration TICK_DURATION;
+    static const std::vector<int64_t> LATENESS_BUCKET_LIMITS_US;
+
+    TimerWheel();
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    TimerId schedule(std::chrono::milliseconds delay, const TimerCallback& callback);
+    bool cancel(TimerId timerId);
+
+    bool advance();
+
+    size_t getPendingCount();
+    JitterStats getJitterStats();
+
+    void setWakeupCallback(const WakeupCallback& callback);
+
+private:
+    struct TimerNode
+    {
+        uint32_t prev;
+        uint32_t next;
+
+        // Which of the slotHeads this node is linked into
+        uint32_t slotIdx;
+
+        // Incremented each time this node is released, so stale TimerIds
+        // can be detected
+        uint32_t generation;
+
+        uint64_t expiryTick;
+        Clock::time_point dueTime;
+        TimerCallback callback;
+        bool inUse;
+    };
+
+    void step(std::vector<std::pair<TimerCallback, Clock::time_point>>& expired);
+    void cascade(uint32_t level);
+    void insertNode(uint32_t nodeIdx);
+    void unlinkNode(uint32_t nodeIdx);
+    uint32_t allocateNode();
+    void releaseNode(uint32_t nodeIdx);
+    uint64_t getCurrentRealTick() const;
+    void recordLateness(int64_t latenessUs);
+
+    static TimerId makeTimerId(uint32_t nodeIdx, uint32_t generation);
+
+    static const uint32_t LEVELS = 4;
+    static const uint32_t SLOT_BITS = 8;
+    static const uint32_t SLOTS_PER_LEVEL = 1 << SLOT_BITS;
+    static const uint32_t SLOT_MASK = SLOTS_PER_LEVEL - 1;
+    static const uint32_t NIL = UINT32_MAX;
+
+    const Clock::time_point startTime;
+
+    // The last tick which has been processed by step()
+    uint64_t currentTick;
+
+    // Head node index of each slot's list, level-major
+    uint32_t slotHeads[LEVELS * SLOTS_PER_LEVEL];
+
+    std::vector<TimerNode> nodePool;
+    std::vector<uint32_t> freeNodes;
+    size_t pendingCount;
+
+    WakeupCallback wakeupCallback;
+
+    // Jitter accounting
+    uint64_t timersFired;
+    int64_t minLatenessUs;
+    int64_t maxLatenessUs;
+    int64_t totalLatenessUs;
+    std::vector<uint64_t> latenessBuckets;
+
+    // Guards everything above
+    std::mutex wheelMutex;
+};
+
+#endif /* SCHEDULER_TIMERWHEEL_HPP_ */
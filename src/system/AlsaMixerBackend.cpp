@@ -0,0 +1,257 @@
+/*
+ * AlsaMixerBackend.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+// System Includes
+#include <cerrno>
+#include <cmath>
+#include <iostream>
+#include <poll.h>
+#include <stdexcept>
+#include <sys/eventfd.h>
+#include <system_error>
+#include <unistd.h>
+#include <vector>
+
+// Project Includes
+#include "AlsaMixerBackend.hpp"
+
+// Static initialization
+const char * const AlsaMixerBackend::MIXER_DEVICE = "default";
+const long AlsaMixerBackend::MAX_LINEAR_DB_SCALE = 2400;
+
+AlsaMixerBackend::AlsaMixerBackend(const std::string& controlName):
+        controlName(controlName)
+{
+    int err = snd_mixer_open(&mixer, 0);
+    if (err == 0)
+    {
+        err = snd_mixer_attach(mixer, MIXER_DEVICE);
+    }
+    if (err == 0)
+    {
+        err = snd_mixer_selem_register(mixer, nullptr, nullptr);
+    }
+    if (err == 0)
+    {
+        err = snd_mixer_load(mixer);
+    }
+    if (err != 0)
+    {
+        if (mixer)
+        {
+            snd_mixer_close(mixer);
+        }
+        throw std::system_error(-err, std::generic_category(),
+                std::string("Unable to open ALSA mixer: ") + snd_strerror(err));
+    }
+
+    snd_mixer_selem_id_t* elementId;
+    snd_mixer_selem_id_alloca(&elementId);
+    snd_mixer_selem_id_set_index(elementId, 0);
+    snd_mixer_selem_id_set_name(elementId, controlName.c_str());
+
+    element = snd_mixer_find_selem(mixer, elementId);
+    if (element == nullptr || !snd_mixer_selem_has_playback_volume(element))
+    {
+        snd_mixer_close(mixer);
+        throw std::invalid_argument("ALSA mixer has no playback volume control named: " +
+                controlName);
+    }
+
+    interruptEventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (interruptEventFd < 0)
+    {
+        snd_mixer_close(mixer);
+        throw std::system_error(errno, std::generic_category(),
+                "Unable to create eventfd for ALSA mixer monitoring");
+    }
+}
+
+AlsaMixerBackend::~AlsaMixerBackend()
+{
+    close(interruptEventFd);
+    snd_mixer_close(mixer);
+}
+
+void AlsaMixerBackend::setVolume(uint8_t percent)
+{
+    std::lock_guard<std::mutex> mixerLock{mixerMutex};
+    setMappedVolume(percent / 100.0);
+}
+
+std::string AlsaMixerBackend::getName() const
+{
+    return "alsa";
+}
+
+uint8_t AlsaMixerBackend::getVolume()
+{
+    std::lock_guard<std::mutex> mixerLock{mixerMutex};
+    long percent = std::lround(getMappedVolume() * 100);
+    return static_cast<uint8_t>(percent < 0 ? 0 : (percent > 100 ? 100 : percent));
+}
+
+bool AlsaMixerBackend::canWatchForChanges() const
+{
+    return true;
+}
+
+/**
+ * Polls the mixer's descriptors, along with interruptEventFd, and has
+ * libasound process whatever events arrive, which refreshes the values
+ * cached in element. Any event is reported as a possible change; getVolume()
+ * tells whether it was one.
+ */
+bool AlsaMixerBackend::waitForChange()
+{
+    std::vector<pollfd> pollFds;
+    {
+        std::lock_guard<std::mutex> mixerLock{mixerMutex};
+        int count = snd_mixer_poll_descriptors_count(mixer);
+        if (count < 0)
+        {
+            throw std::system_error(-count, std::generic_category(),
+                    std::string("Unable to get ALSA mixer descriptors: ") +
+                    snd_strerror(count));
+        }
+        pollFds.resize(static_cast<size_t>(count) + 1);
+        int filled = snd_mixer_poll_descriptors(mixer, pollFds.data(),
+                static_cast<unsigned int>(count));
+        if (filled < 0)
+        {
+            throw std::system_error(-filled, std::generic_category(),
+                    std::string("Unable to get ALSA mixer descriptors: ") +
+                    snd_strerror(filled));
+        }
+
+        // Only the descriptors filled in are polled, followed by the
+        // interrupt fd
+        pollFds.resize(static_cast<size_t>(filled) + 1);
+    }
+
+    // The interrupt fd goes last
+    pollfd& interruptPollFd = pollFds.back();
+    interruptPollFd.fd = interruptEventFd;
+    interruptPollFd.events = POLLIN;
+    interruptPollFd.revents = 0;
+
+    while (poll(pollFds.data(), pollFds.size(), -1) < 0)
+    {
+        if (errno != EINTR)
+        {
+            throw std::system_error(errno, std::generic_category(),
+                    "Error polling ALSA mixer");
+        }
+    }
+
+    if (interruptPollFd.revents != 0)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> mixerLock{mixerMutex};
+    unsigned short revents = 0;
+    snd_mixer_poll_descriptors_revents(mixer, pollFds.data(),
+            static_cast<unsigned int>(pollFds.size() - 1), &revents);
+    if (revents & (POLLERR | POLLNVAL))
+    {
+        throw std::system_error(EIO, std::generic_category(),
+                "ALSA mixer descriptors reported an error");
+    }
+    snd_mixer_handle_events(mixer);
+    return true;
+}
+
+/**
+ * The eventfd is never read, so once written it stays readable and every
+ * later waitForChange() returns immediately too
+ */
+void AlsaMixerBackend::interruptWait()
+{
+    uint64_t one = 1;
+    (void) write(interruptEventFd, &one, sizeof(one));
+}
+
+/**
+ * Sets the volume to normalized (0-1) on the same perceptual scale as
+ * "amixer -M" (alsa-utils' volume_mapping.c): controls with a wide dB range
+ * are mapped logarithmically in dB, and all others linearly in raw units.
+ */
+void AlsaMixerBackend::setMappedVolume(double normalized)
+{
+    long minDb = 0;
+    long maxDb = 0;
+    int err = snd_mixer_selem_get_playback_dB_range(element, &minDb, &maxDb);
+
+    if (err < 0 || maxDb - minDb <= MAX_LINEAR_DB_SCALE)
+    {
+        long minRaw = 0;
+        long maxRaw = 0;
+        snd_mixer_selem_get_playback_volume_range(element, &minRaw, &maxRaw);
+        long raw = std::lround(normalized * (maxRaw - minRaw)) + minRaw;
+        err = snd_mixer_selem_set_playback_volume_all(element, raw);
+    }
+    else
+    {
+        if (minDb != SND_CTL_TLV_DB_GAIN_MUTE)
+        {
+            double minNormalized = std::pow(10.0, (minDb - maxDb) / 6000.0);
+            normalized = normalized * (1 - minNormalized) + minNormalized;
+        }
+        long db = normalized <= 0 ? minDb :
+                std::lround(6000.0 * std::log10(normalized)) + maxDb;
+        err = snd_mixer_selem_set_playback_dB_all(element, db, 1);
+    }
+
+    if (err < 0)
+    {
+        throw std::system_error(-err, std::generic_category(),
+                std::string("Unable to set ALSA volume: ") + snd_strerror(err));
+    }
+}
+
+/**
+ * The inverse of setMappedVolume(); reads the first channel's volume as
+ * normalized (0-1) on the "amixer -M" scale
+ */
+double AlsaMixerBackend::getMappedVolume()
+{
+    long minDb = 0;
+    long maxDb = 0;
+    int err = snd_mixer_selem_get_playback_dB_range(element, &minDb, &maxDb);
+
+    if (err < 0 || maxDb - minDb <= MAX_LINEAR_DB_SCALE)
+    {
+        long minRaw = 0;
+        long maxRaw = 0;
+        long raw = 0;
+        snd_mixer_selem_get_playback_volume_range(element, &minRaw, &maxRaw);
+        err = snd_mixer_selem_get_playback_volume(element, SND_MIXER_SCHN_FRONT_LEFT, &raw);
+        if (err < 0)
+        {
+            throw std::system_error(-err, std::generic_category(),
+                    std::string("Unable to get ALSA volume: ") + snd_strerror(err));
+        }
+        return maxRaw == minRaw ? 0 : static_cast<double>(raw - minRaw) / (maxRaw - minRaw);
+    }
+
+    long db = 0;
+    err = snd_mixer_selem_get_playback_dB(element, SND_MIXER_SCHN_FRONT_LEFT, &db);
+    if (err < 0)
+    {
+        throw std::system_error(-err, std::generic_category(),
+                std::string("Unable to get ALSA volume: ") + snd_strerror(err));
+    }
+
+    double normalized = std::pow(10.0, (db - maxDb) / 6000.0);
+    if (minDb != SND_CTL_TLV_DB_GAIN_MUTE)
+    {
+        double minNormalized = std::pow(10.0, (minDb - maxDb) / 6000.0);
+        normalized = (normalized - minNormalized) / (1 - minNormalized);
+    }
+    return normalized;
+}
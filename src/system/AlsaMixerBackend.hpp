@@ -0,0 +1,66 @@
+/*
+ * AlsaMixerBackend.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+#ifndef SYSTEM_ALSAMIXERBACKEND_HPP_
+#define SYSTEM_ALSAMIXERBACKEND_HPP_
+
+// System Includes
+#include <alsa/asoundlib.h>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// Project Includes
+#include "MixerBackend.hpp"
+
+/**
+ * Sets the volume through libasound's simple mixer interface, in process.
+ * The mixer is opened once, on the "default" card, and kept open. Changes
+ * are watched for by polling the mixer's descriptors. Only built when
+ * libasound is available (NETSYSCTRLD_HAVE_ALSA).
+ */
+class AlsaMixerBackend : public MixerBackend
+{
+public:
+    // Throws a std::system_error if the mixer can't be opened, or a
+    // std::invalid_argument if it has no playback control named controlName
+    explicit AlsaMixerBackend(const std::string& controlName);
+    ~AlsaMixerBackend();
+
+    void setVolume(uint8_t percent) override;
+    std::string getName() const override;
+    uint8_t getVolume() override;
+    bool canWatchForChanges() const override;
+    bool waitForChange() override;
+    void interruptWait() override;
+
+    AlsaMixerBackend(const AlsaMixerBackend&) = delete;
+    AlsaMixerBackend& operator=(const AlsaMixerBackend&) = delete;
+
+private:
+    void setMappedVolume(double normalized);
+    double getMappedVolume();
+
+    static const char * const MIXER_DEVICE;
+
+    // Controls whose dB range is at most this wide (in 0.01dB) are mapped
+    // linearly, as "amixer -M" does
+    static const long MAX_LINEAR_DB_SCALE;
+
+    const std::string controlName;
+    snd_mixer_t* mixer = nullptr;
+    snd_mixer_elem_t* element = nullptr;
+
+    // libasound handles aren't thread safe; guards every use of mixer and
+    // element, other than waitForChange()'s poll()
+    std::mutex mixerMutex;
+
+    // Written to by interruptWait() to wake waitForChange() out of poll()
+    int interruptEventFd = -1;
+};
+
+#endif /* SYSTEM_ALSAMIXERBACKEND_HPP_ */
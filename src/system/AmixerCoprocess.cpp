@@ -0,0 +1,326 @@
+/*
+ * AmixerCoprocess.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+// System Includes
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <fcntl.h>
+#include <iostream>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <system_error>
+#include <termios.h>
+#include <unistd.h>
+
+// Project Includes
+#include "AmixerCoprocess.hpp"
+
+extern char **environ;
+
+// Static initialization
+
+// -M: use the mapped (perceptual) volume scale, as "amixer set ... -M" did;
+// -s: read commands from stdin. Not -q, which would stop amixer printing
+// the state that confirms each command.
+const char * const AmixerCoprocess::AMIXER_ARGS[] = {"amixer", "-M", "-s", nullptr};
+// Setting a control is an ioctl or two, and amixer replies within tens of
+// microseconds of the command being sent, so this is only reached if it's
+// wedged or has silently ignored the command
+const std::chrono::milliseconds AmixerCoprocess::RESULT_TIMEOUT{250};
+
+// The first line of the state amixer prints after setting a control
+static const std::string STATE_HEADER = "Simple mixer control ";
+
+// amixer's complaint about a control which doesn't exist, e.g.
+// "amixer: Unable to find simple control 'Foo',0"
+static const std::string CONTROL_NOT_FOUND = "Unable to find simple control";
+
+/**
+ * Opens a pseudo terminal for amixer's output, in raw mode so that newlines
+ * aren't translated. The master side is non-blocking; both are close on
+ * exec. Throws a std::system_error on failure.
+ */
+static void openOutputTerminal(int& masterFd, int& slaveFd)
+{
+    masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (masterFd < 0)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                "Unable to open a pseudo terminal for amixer");
+    }
+
+    char slaveName[64];
+    slaveFd = -1;
+    if (fcntl(masterFd, F_SETFD, FD_CLOEXEC) != 0 ||
+            fcntl(masterFd, F_SETFL, O_NONBLOCK) != 0 ||
+            grantpt(masterFd) != 0 || unlockpt(masterFd) != 0 ||
+            ptsname_r(masterFd, slaveName, sizeof(slaveName)) != 0 ||
+            (slaveFd = open(slaveName, O_RDWR | O_NOCTTY | O_CLOEXEC)) < 0)
+    {
+        int openErrno = errno;
+        close(masterFd);
+        throw std::system_error(openErrno, std::generic_category(),
+                "Unable to open a pseudo terminal for amixer");
+    }
+
+    struct termios terminalAttrs;
+    if (tcgetattr(slaveFd, &terminalAttrs) == 0)
+    {
+        cfmakeraw(&terminalAttrs);
+        (void) tcsetattr(slaveFd, TCSANOW, &terminalAttrs);
+    }
+}
+
+AmixerCoprocess::~AmixerCoprocess()
+{
+    stop();
+}
+
+/**
+ * Writes commandLine to amixer's stdin, and waits for the result. A write
+ * failing with EPIPE means amixer has exited since it was last checked; it's
+ * restarted and the write is retried once. SIGPIPE is expected to be
+ * ignored by the process.
+ */
+std::string AmixerCoprocess::execute(const std::string& commandLine)
+{
+    const std::string line = commandLine + "\n";
+
+    for (int attempt = 0; attempt < 2; ++attempt)
+    {
+        start();
+        discardOutput();
+
+        if (write(amixerStdinFd, line.c_str(), line.length()) ==
+                static_cast<ssize_t>(line.length()))
+        {
+            return awaitResult();
+        }
+
+        int writeErrno = errno;
+        stop();
+        if (writeErrno != EPIPE)
+        {
+            throw std::system_error(writeErrno, std::generic_category(),
+                    "Unable to send command to amixer");
+        }
+        std::cerr << "amixer exited; restarting it" << std::endl;
+    }
+
+    throw std::system_error(EPIPE, std::generic_category(),
+            "amixer exited while being sent a command");
+}
+
+/**
+ * Reads amixer's output until it has printed a control's state, and
+ * returns that. Lines before the state's header are kept for the error
+ * message if there's no state, since that's where amixer's complaints go.
+ * A complaint that the control doesn't exist is amixer's whole reply, so
+ * that fails straight away, leaving amixer running. If amixer doesn't reply
+ * in time it's killed, so a late reply can't be taken for the next
+ * command's.
+ */
+std::string AmixerCoprocess::awaitResult()
+{
+    const std::chrono::steady_clock::time_point deadline =
+            std::chrono::steady_clock::now() + RESULT_TIMEOUT;
+    std::string state;
+    std::string otherOutput;
+
+    while (true)
+    {
+        size_t newlineIdx;
+        while ((newlineIdx = partialLine.find('\n')) != std::string::npos)
+        {
+            std::string line = partialLine.substr(0, newlineIdx);
+            partialLine.erase(0, newlineIdx + 1);
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+
+            if (line.compare(0, STATE_HEADER.length(), STATE_HEADER) == 0)
+            {
+                state = line;
+            }
+            else if (!state.empty())
+            {
+                state += "\n" + line;
+                if (line.find("%]") != std::string::npos)
+                {
+                    return state;
+                }
+            }
+            else if (line.find(CONTROL_NOT_FOUND) != std::string::npos)
+            {
+                throw std::system_error(ENOENT, std::generic_category(), line);
+            }
+            else if (!line.empty())
+            {
+                otherOutput += (otherOutput.empty() ? "" : "; ") + line;
+            }
+        }
+
+        const std::string outputSuffix = otherOutput.empty() ? "" : ": " + otherOutput;
+        std::chrono::milliseconds remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0)
+        {
+            kill(amixerPid, SIGTERM);
+            stop();
+            throw std::system_error(ETIMEDOUT, std::generic_category(),
+                    "amixer didn't confirm the command" + outputSuffix);
+        }
+
+        struct pollfd outputPollFd = {amixerOutputFd, POLLIN, 0};
+        if (poll(&outputPollFd, 1, static_cast<int>(remaining.count())) < 0 && errno != EINTR)
+        {
+            int pollErrno = errno;
+            stop();
+            throw std::system_error(pollErrno, std::generic_category(),
+                    "Unable to wait for amixer's output");
+        }
+
+        char readBuff[1024];
+        ssize_t bytesRead = read(amixerOutputFd, readBuff, sizeof(readBuff));
+        if (bytesRead > 0)
+        {
+            partialLine.append(readBuff, static_cast<size_t>(bytesRead));
+        }
+        else if (bytesRead == 0 || (errno != EAGAIN && errno != EINTR))
+        {
+            // The terminal reports EIO once amixer, its only other user, has
+            // exited
+            stop();
+            throw std::system_error(EPIPE, std::generic_category(),
+                    "amixer exited before confirming the command" + outputSuffix);
+        }
+    }
+}
+
+/**
+ * Drops anything amixer printed since the last command's result, such as
+ * the rest of that control's state, so it can't be taken for the next one's
+ */
+void AmixerCoprocess::discardOutput()
+{
+    char readBuff[1024];
+    while (read(amixerOutputFd, readBuff, sizeof(readBuff)) > 0)
+    {
+    }
+    partialLine.clear();
+}
+
+/**
+ * Spawns amixer, with a pipe as its stdin and a pseudo terminal as its
+ * stdout and stderr, unless it's already running
+ */
+void AmixerCoprocess::start()
+{
+    if (isRunning())
+    {
+        return;
+    }
+
+    int pipeFds[2];
+    if (pipe2(pipeFds, O_CLOEXEC) != 0)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                "Unable to create pipe for amixer");
+    }
+
+    int outputMasterFd = -1;
+    int outputSlaveFd = -1;
+    try
+    {
+        openOutputTerminal(outputMasterFd, outputSlaveFd);
+    }
+    catch (const std::system_error&)
+    {
+        close(pipeFds[0]);
+        close(pipeFds[1]);
+        throw;
+    }
+
+    posix_spawn_file_actions_t fileActions;
+    posix_spawn_file_actions_init(&fileActions);
+    posix_spawn_file_actions_adddup2(&fileActions, pipeFds[0], STDIN_FILENO);
+    posix_spawn_file_actions_adddup2(&fileActions, outputSlaveFd, STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&fileActions, outputSlaveFd, STDERR_FILENO);
+
+    pid_t pid = -1;
+    int spawnErr = posix_spawnp(&pid, AMIXER_ARGS[0], &fileActions, nullptr,
+            const_cast<char * const *>(AMIXER_ARGS), environ);
+    posix_spawn_file_actions_destroy(&fileActions);
+    close(pipeFds[0]);
+    close(outputSlaveFd);
+
+    if (spawnErr != 0)
+    {
+        close(pipeFds[1]);
+        close(outputMasterFd);
+        throw std::system_error(spawnErr, std::generic_category(),
+                "Unable to start amixer");
+    }
+
+    amixerPid = pid;
+    amixerStdinFd = pipeFds[1];
+    amixerOutputFd = outputMasterFd;
+    partialLine.clear();
+    std::cout << "Started amixer coprocess; pid " << amixerPid << std::endl;
+}
+
+/**
+ * Reaps amixer if it has exited, in which case its pipe and terminal are
+ * closed too
+ */
+bool AmixerCoprocess::isRunning()
+{
+    if (amixerPid < 0)
+    {
+        return false;
+    }
+
+    int status = 0;
+    if (waitpid(amixerPid, &status, WNOHANG) == 0)
+    {
+        return true;
+    }
+
+    amixerPid = -1;
+    stop();
+    return false;
+}
+
+/**
+ * Closes amixer's stdin and terminal, which makes it exit once it has
+ * executed any commands still in the pipe, and reaps it
+ */
+void AmixerCoprocess::stop()
+{
+    if (amixerStdinFd >= 0)
+    {
+        close(amixerStdinFd);
+        amixerStdinFd = -1;
+    }
+
+    // Closed before waiting, so amixer can't block writing to it
+    if (amixerOutputFd >= 0)
+    {
+        close(amixerOutputFd);
+        amixerOutputFd = -1;
+    }
+
+    if (amixerPid >= 0)
+    {
+        int status = 0;
+        (void) waitpid(amixerPid, &status, 0);
+        amixerPid = -1;
+    }
+}
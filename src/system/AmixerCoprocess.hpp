@@ -0,0 +1,78 @@
+/*
+ * AmixerCoprocess.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+#ifndef SYSTEM_AMIXERCOPROCESS_HPP_
+#define SYSTEM_AMIXERCOPROCESS_HPP_
+
+// System Includes
+#include <chrono>
+#include <string>
+#include <sys/types.h>
+
+// Project Includes
+// <none>
+
+/**
+ * A long-lived "amixer -s" process, which reads mixer commands from its
+ * stdin one line at a time. Sending a command is a single write() to a pipe,
+ * rather than a fork of /bin/sh and amixer per command. amixer is started on
+ * first use and restarted if it has died. Not thread safe; callers
+ * serialize access.
+ *
+ * After each set command amixer prints the state of the control it set,
+ * which is how success is confirmed. A control which doesn't exist is
+ * reported on stderr; should amixer instead ignore the command, the only
+ * sign of failure is that nothing is printed. amixer's stdout and stderr are a pseudo terminal
+ * rather than a pipe, so that its stdio flushes each line as it's printed
+ * instead of when its buffer fills.
+ */
+class AmixerCoprocess
+{
+public:
+    AmixerCoprocess() {};
+    ~AmixerCoprocess();
+
+    // Sends commandLine, a set command without a trailing newline, to amixer
+    // and waits for it to print the control's state. Returns that state, up
+    // to and including its first channel's line, e.g.
+    // "  Front Left: Playback 39322 [60%] [on]". Throws a std::system_error
+    // if amixer can't be started, if it dies and the command can't be
+    // delivered to its replacement either, if it reports that the control
+    // doesn't exist, or if it doesn't print the state within RESULT_TIMEOUT;
+    // anything it printed instead is in the message.
+    std::string execute(const std::string& commandLine);
+
+    // Starts amixer if it isn't running; see execute() for errors
+    void start();
+
+    AmixerCoprocess(const AmixerCoprocess&) = delete;
+    AmixerCoprocess& operator=(const AmixerCoprocess&) = delete;
+
+private:
+    bool isRunning();
+    void stop();
+    std::string awaitResult();
+    void discardOutput();
+
+    static const char * const AMIXER_ARGS[];
+
+    // How long amixer may take to print a control's state after setting it
+    static const std::chrono::milliseconds RESULT_TIMEOUT;
+
+    pid_t amixerPid = -1;
+
+    // The write end of amixer's stdin
+    int amixerStdinFd = -1;
+
+    // The master side of amixer's stdout and stderr; non-blocking
+    int amixerOutputFd = -1;
+
+    // Output read after the last complete line
+    std::string partialLine;
+};
+
+#endif /* SYSTEM_AMIXERCOPROCESS_HPP_ */
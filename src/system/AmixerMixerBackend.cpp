@@ -0,0 +1,109 @@
+/*
+ * AmixerMixerBackend.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+// System Includes
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+#include <system_error>
+
+// Project Includes
+#include "AmixerMixerBackend.hpp"
+
+// Static initialization
+const std::chrono::milliseconds AmixerMixerBackend::SGET_TIMEOUT = std::chrono::seconds(2);
+
+/**
+ * Starts amixer right away, so the first volume change doesn't pay for it.
+ * If it can't be started, that's logged and retried on each setVolume().
+ */
+AmixerMixerBackend::AmixerMixerBackend(const std::string& controlName,
+        const ExecServiceSharedPtr& execService):
+        controlName(controlName), execService(execService)
+{
+    try
+    {
+        amixer.start();
+    }
+    catch (const std::system_error& err)
+    {
+        std::cerr << "Volume control unavailable until amixer can be started: "
+                << err.what() << std::endl;
+    }
+}
+
+/**
+ * Returns once amixer has printed the control's new state. A control which
+ * doesn't exist, or a mixer which can't be opened, shows up as a
+ * std::system_error from the coprocess, so the volume is never reported as
+ * applied unless amixer applied it.
+ */
+void AmixerMixerBackend::setVolume(uint8_t percent)
+{
+    // The control name is quoted, since names such as "PCM Playback"
+    // contain spaces
+    const std::string volumeSetCommand = "set \"" + controlName + "\" " +
+            std::to_string(percent) + "%";
+
+    std::cout << "Executing volume set command: " << volumeSetCommand << std::endl;
+
+    amixer.execute(volumeSetCommand);
+}
+
+std::string AmixerMixerBackend::getName() const
+{
+    return "amixer";
+}
+
+/**
+ * Parses the first channel's "[NN%]" out of "amixer -M sget" output. Throws a
+ * std::system_error if amixer couldn't be run, or timed out, or its output
+ * has no volume.
+ */
+uint8_t AmixerMixerBackend::getVolume()
+{
+    if (!execService)
+    {
+        throw std::system_error(ENOTSUP, std::generic_category(),
+                "Reading the volume through amixer needs an ExecService");
+    }
+
+    ExecService::ExecResult result = execService->executeAndWait(
+            {"amixer", "-M", "sget", controlName}, SGET_TIMEOUT);
+    if (result.timedOut)
+    {
+        throw std::system_error(ETIMEDOUT, std::generic_category(),
+                "amixer sget timed out");
+    }
+    const std::string& output = result.output;
+
+    size_t percentIdx = output.find("%]");
+    size_t openIdx = percentIdx == std::string::npos ? std::string::npos :
+            output.rfind('[', percentIdx);
+    if (openIdx == std::string::npos)
+    {
+        throw std::system_error(EPROTO, std::generic_category(),
+                "amixer reported no volume for control: " + controlName);
+    }
+
+    unsigned long percent = std::strtoul(output.c_str() + openIdx + 1, nullptr, 10);
+    return static_cast<uint8_t>(percent > 100 ? 100 : percent);
+}
+
+bool AmixerMixerBackend::canWatchForChanges() const
+{
+    return false;
+}
+
+bool AmixerMixerBackend::waitForChange()
+{
+    return false;
+}
+
+void AmixerMixerBackend::interruptWait()
+{
+}
@@ -0,0 +1,52 @@
+/*
+ * AmixerMixerBackend.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+#ifndef SYSTEM_AMIXERMIXERBACKEND_HPP_
+#define SYSTEM_AMIXERMIXERBACKEND_HPP_
+
+// System Includes
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// Project Includes
+#include "AmixerCoprocess.hpp"
+#include "ExecService.hpp"
+#include "MixerBackend.hpp"
+
+/**
+ * Sets the volume by shelling out to amixer, through a persistent
+ * AmixerCoprocess, which waits for amixer to confirm each change. Works
+ * wherever alsa-utils is installed, including builds without libasound.
+ * Reading the volume runs a separate "amixer sget" through the ExecService,
+ * and changes can't be watched for.
+ */
+class AmixerMixerBackend : public MixerBackend
+{
+public:
+    // execService is needed to read the volume; without one, getVolume()
+    // fails with ENOTSUP
+    AmixerMixerBackend(const std::string& controlName,
+            const ExecServiceSharedPtr& execService);
+
+    void setVolume(uint8_t percent) override;
+    std::string getName() const override;
+    uint8_t getVolume() override;
+    bool canWatchForChanges() const override;
+    bool waitForChange() override;
+    void interruptWait() override;
+
+private:
+    // How long "amixer sget" may take before it's killed
+    static const std::chrono::milliseconds SGET_TIMEOUT;
+
+    const std::string controlName;
+    const ExecServiceSharedPtr execService;
+    AmixerCoprocess amixer;
+};
+
+#endif /* SYSTEM_AMIXERMIXERBACKEND_HPP_ */
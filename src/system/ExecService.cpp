@@ -0,0 +1,502 @@
+/*
+ * ExecService.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+// System Includes
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <future>
+#include <iostream>
+#include <list>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <system_error>
+#include <unistd.h>
+
+// Project Includes
+#include "ExecService.hpp"
+
+extern char **environ;
+
+namespace
+{
+
+// A request is a RequestHeader followed by argCount NUL terminated
+// arguments; a result is a ResultHeader followed by outputLength bytes of
+// output
+struct RequestHeader
+{
+    uint64_t requestId;
+    uint32_t timeoutMs;
+    uint32_t argCount;
+};
+
+struct ResultHeader
+{
+    uint64_t requestId;
+    int32_t error;
+    int32_t exitStatus;
+    uint8_t timedOut;
+    uint8_t reserved[3];
+    uint32_t outputLength;
+};
+
+const size_t MAX_REQUEST_LENGTH = 32 * 1024;
+
+// How often the helper checks whether programs which have closed their
+// stdout have exited
+const int REAP_POLL_INTERVAL_MS = 10;
+
+}
+
+// Static Initialization
+const size_t ExecService::MAX_OUTPUT_LENGTH = 32 * 1024;
+
+/**
+ * Creates the socket pair and forks the helper. Nothing but the helper's
+ * loop runs in the child, so the usual hazards of forking a process (locks
+ * held by other threads, duplicated buffers) don't arise as long as this
+ * is called before any other thread exists.
+ */
+ExecServiceSharedPtr ExecService::start()
+{
+    int socketFds[2];
+    if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, socketFds) != 0)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                "Unable to create socket pair for exec helper");
+    }
+
+    // Anything still buffered would otherwise be printed by both processes
+    std::cout.flush();
+    std::cerr.flush();
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        int forkErrno = errno;
+        close(socketFds[0]);
+        close(socketFds[1]);
+        throw std::system_error(forkErrno, std::generic_category(),
+                "Unable to fork exec helper");
+    }
+    if (pid == 0)
+    {
+        close(socketFds[0]);
+        helperMain(socketFds[1]);
+    }
+
+    close(socketFds[1]);
+    std::cout << "Started exec helper; pid " << pid << std::endl;
+    return ExecServiceSharedPtr(new ExecService(socketFds[0], pid));
+}
+
+ExecService::ExecService(int socketFd, pid_t helperPid):
+        socketFd(socketFd), helperPid(helperPid)
+{
+    readerThread = std::thread(&ExecService::readerLoop, this);
+}
+
+/**
+ * Shutting down the socket's write side tells the helper to stop; the
+ * reader thread sees it close its end once it has
+ */
+ExecService::~ExecService()
+{
+    shutdown(socketFd, SHUT_WR);
+    readerThread.join();
+
+    int status = 0;
+    (void) waitpid(helperPid, &status, 0);
+    close(socketFd);
+}
+
+/**
+ * Sends the request to the helper. Requests whose arguments don't fit in
+ * MAX_REQUEST_LENGTH fail with E2BIG, and an empty args with EINVAL.
+ * Timeouts are capped at about 49 days.
+ */
+void ExecService::execute(const std::vector<std::string>& args,
+        std::chrono::milliseconds timeout, const ExecCallback& callback)
+{
+    ExecResult failure{0, 0, false, ""};
+
+    RequestHeader header = {};
+    header.timeoutMs = static_cast<uint32_t>(std::min<int64_t>(
+            std::max<int64_t>(timeout.count(), 0), UINT32_MAX));
+    header.argCount = static_cast<uint32_t>(args.size());
+
+    std::string message(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const std::string& arg : args)
+    {
+        message.append(arg.c_str(), arg.length() + 1);
+    }
+
+    if (args.empty())
+    {
+        failure.error = EINVAL;
+    }
+    else if (message.length() > MAX_REQUEST_LENGTH)
+    {
+        failure.error = E2BIG;
+    }
+    else
+    {
+        std::lock_guard<std::mutex> pendingLock{pendingMutex};
+        if (helperGone)
+        {
+            failure.error = EPIPE;
+        }
+        else
+        {
+            header.requestId = ++lastRequestId;
+            std::memcpy(&message[0], &header, sizeof(header));
+            pendingCallbacks.emplace(header.requestId, callback);
+
+            if (send(socketFd, message.data(), message.length(), MSG_NOSIGNAL) ==
+                    static_cast<ssize_t>(message.length()))
+            {
+                return;
+            }
+
+            failure.error = errno;
+            pendingCallbacks.erase(header.requestId);
+        }
+    }
+
+    callback(failure);
+}
+
+/**
+ * Must not be called from another request's callback, since the reader
+ * thread which would deliver its result would be the one waiting for it
+ */
+ExecService::ExecResult ExecService::executeAndWait(const std::vector<std::string>& args,
+        std::chrono::milliseconds timeout)
+{
+    auto resultPromise = std::make_shared<std::promise<ExecResult>>();
+    std::future<ExecResult> resultFuture = resultPromise->get_future();
+
+    execute(args, timeout, [resultPromise](const ExecResult& result)
+    {
+        resultPromise->set_value(result);
+    });
+
+    ExecResult result = resultFuture.get();
+    if (result.error != 0)
+    {
+        throw std::system_error(result.error, std::generic_category(),
+                "Unable to run " + (args.empty() ? std::string("nothing") : args[0]));
+    }
+    return result;
+}
+
+/**
+ * Run on readerThread; delivers results until the helper closes its end of
+ * the socket, then fails whatever is still outstanding
+ */
+void ExecService::readerLoop()
+{
+    std::vector<char> buffer(sizeof(ResultHeader) + MAX_OUTPUT_LENGTH);
+
+    while (true)
+    {
+        ssize_t messageLength = recv(socketFd, buffer.data(), buffer.size(), 0);
+        if (messageLength < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (messageLength < static_cast<ssize_t>(sizeof(ResultHeader)))
+        {
+            break;
+        }
+
+        ResultHeader header;
+        std::memcpy(&header, buffer.data(), sizeof(header));
+        size_t outputLength = std::min<size_t>(header.outputLength,
+                static_cast<size_t>(messageLength) - sizeof(header));
+
+        ExecCallback callback;
+        {
+            std::lock_guard<std::mutex> pendingLock{pendingMutex};
+            auto callbackIter = pendingCallbacks.find(header.requestId);
+            if (callbackIter == pendingCallbacks.end())
+            {
+                continue;
+            }
+            callback = std::move(callbackIter->second);
+            pendingCallbacks.erase(callbackIter);
+        }
+
+        ExecResult result{header.error, header.exitStatus, header.timedOut != 0,
+                std::string(buffer.data() + sizeof(header), outputLength)};
+        try
+        {
+            callback(result);
+        }
+        catch (const std::exception& err)
+        {
+            std::cerr << "Exec callback threw: " << err.what() << std::endl;
+        }
+    }
+
+    failAllPending(EPIPE);
+}
+
+/**
+ * Marks the helper as gone, and executes every pending callback with error
+ */
+void ExecService::failAllPending(int error)
+{
+    std::unordered_map<uint64_t, ExecCallback> callbacks;
+    {
+        std::lock_guard<std::mutex> pendingLock{pendingMutex};
+        helperGone = true;
+        callbacks.swap(pendingCallbacks);
+    }
+
+    for (auto& idAndCallback : callbacks)
+    {
+        try
+        {
+            idAndCallback.second(ExecResult{error, 0, false, ""});
+        }
+        catch (const std::exception& err)
+        {
+            std::cerr << "Exec callback threw: " << err.what() << std::endl;
+        }
+    }
+}
+
+/**
+ * The helper: a single threaded poll() loop over the socket and the stdout
+ * pipes of the programs it has spawned. A program's result is sent once
+ * its stdout has closed and it has been reaped. Exits, killing any programs
+ * still running, once the daemon shuts down or closes its end of the
+ * socket, or dies.
+ */
+void ExecService::helperMain(int socketFd)
+{
+    // The daemon's handlers, if any were installed before the fork, refer
+    // to state which doesn't exist in this process
+    signal(SIGTERM, SIG_DFL);
+    signal(SIGINT, SIG_DFL);
+    signal(SIGABRT, SIG_DFL);
+    signal(SIGPIPE, SIG_IGN);
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+
+    // Nor should the signals the daemon blocks stay blocked in the programs
+    // spawned from here
+    sigset_t noSignals;
+    sigemptyset(&noSignals);
+    sigprocmask(SIG_SETMASK, &noSignals, nullptr);
+
+    struct RunningProgram
+    {
+        uint64_t requestId;
+        pid_t pid;
+        int outputFd;
+        std::string output;
+        std::chrono::steady_clock::time_point deadline;
+        bool timedOut;
+    };
+    std::list<RunningProgram> programs;
+
+    auto sendResult = [socketFd](uint64_t requestId, int error, int exitStatus,
+            bool timedOut, const std::string& output)
+    {
+        ResultHeader header = {};
+        header.requestId = requestId;
+        header.error = error;
+        header.exitStatus = exitStatus;
+        header.timedOut = timedOut ? 1 : 0;
+        header.outputLength = static_cast<uint32_t>(output.length());
+
+        std::string message(reinterpret_cast<const char*>(&header), sizeof(header));
+        message.append(output);
+        (void) send(socketFd, message.data(), message.length(), MSG_NOSIGNAL);
+    };
+
+    // Spawns the program described by request, or reports why it couldn't be
+    auto spawnProgram = [&](const char* request, size_t requestLength)
+    {
+        RequestHeader header;
+        std::memcpy(&header, request, sizeof(header));
+
+        std::vector<char*> argv;
+        const char* argsEnd = request + requestLength;
+        const char* arg = request + sizeof(header);
+        for (uint32_t argIdx = 0; argIdx < header.argCount && arg < argsEnd; ++argIdx)
+        {
+            argv.push_back(const_cast<char*>(arg));
+            arg += strnlen(arg, static_cast<size_t>(argsEnd - arg)) + 1;
+        }
+        if (argv.empty() || argv.size() != header.argCount || arg > argsEnd)
+        {
+            sendResult(header.requestId, EINVAL, 0, false, "");
+            return;
+        }
+        argv.push_back(nullptr);
+
+        int pipeFds[2];
+        if (pipe2(pipeFds, O_CLOEXEC) != 0)
+        {
+            sendResult(header.requestId, errno, 0, false, "");
+            return;
+        }
+
+        posix_spawn_file_actions_t fileActions;
+        posix_spawn_file_actions_init(&fileActions);
+        posix_spawn_file_actions_addopen(&fileActions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+        posix_spawn_file_actions_adddup2(&fileActions, pipeFds[1], STDOUT_FILENO);
+
+        pid_t pid = -1;
+        int spawnErr = posix_spawnp(&pid, argv[0], &fileActions, nullptr,
+                argv.data(), environ);
+        posix_spawn_file_actions_destroy(&fileActions);
+        close(pipeFds[1]);
+
+        if (spawnErr != 0)
+        {
+            close(pipeFds[0]);
+            sendResult(header.requestId, spawnErr, 0, false, "");
+            return;
+        }
+
+        programs.push_back(RunningProgram{header.requestId, pid, pipeFds[0], "",
+                std::chrono::steady_clock::now() +
+                std::chrono::milliseconds(header.timeoutMs), false});
+    };
+
+    std::vector<char> request(MAX_REQUEST_LENGTH);
+    std::vector<char> readBuffer(4096);
+    bool daemonGone = false;
+
+    while (!daemonGone)
+    {
+        // The socket goes first, followed by every open stdout pipe
+        std::vector<pollfd> pollFds{pollfd{socketFd, POLLIN, 0}};
+        int pollTimeoutMs = -1;
+        auto now = std::chrono::steady_clock::now();
+
+        for (RunningProgram& program : programs)
+        {
+            if (program.outputFd >= 0)
+            {
+                pollFds.push_back(pollfd{program.outputFd, POLLIN, 0});
+            }
+
+            if (program.outputFd < 0 || program.timedOut)
+            {
+                pollTimeoutMs = pollTimeoutMs < 0 ? REAP_POLL_INTERVAL_MS :
+                        std::min(pollTimeoutMs, REAP_POLL_INTERVAL_MS);
+            }
+            else
+            {
+                auto untilDeadline = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        program.deadline - now).count() + 1;
+                int deadlineTimeoutMs = static_cast<int>(std::min<int64_t>(
+                        std::max<int64_t>(untilDeadline, 0), INT32_MAX));
+                pollTimeoutMs = pollTimeoutMs < 0 ? deadlineTimeoutMs :
+                        std::min(pollTimeoutMs, deadlineTimeoutMs);
+            }
+        }
+
+        if (poll(pollFds.data(), pollFds.size(), pollTimeoutMs) < 0 && errno != EINTR)
+        {
+            break;
+        }
+
+        if (pollFds[0].revents != 0)
+        {
+            ssize_t requestLength = recv(socketFd, request.data(), request.size(), 0);
+            if (requestLength == 0 || (requestLength < 0 && errno != EINTR && errno != EAGAIN))
+            {
+                daemonGone = true;
+            }
+            else if (requestLength >= static_cast<ssize_t>(sizeof(RequestHeader)))
+            {
+                spawnProgram(request.data(), static_cast<size_t>(requestLength));
+            }
+        }
+
+        // Collect output; anything past MAX_OUTPUT_LENGTH is read but dropped,
+        // so that the program never blocks on a full pipe
+        size_t pollFdIdx = 1;
+        for (RunningProgram& program : programs)
+        {
+            if (program.outputFd < 0 || pollFdIdx >= pollFds.size() ||
+                    pollFds[pollFdIdx].fd != program.outputFd)
+            {
+                continue;
+            }
+            if (pollFds[pollFdIdx++].revents == 0)
+            {
+                continue;
+            }
+
+            ssize_t bytesRead = read(program.outputFd, readBuffer.data(), readBuffer.size());
+            if (bytesRead > 0)
+            {
+                size_t room = MAX_OUTPUT_LENGTH - program.output.length();
+                program.output.append(readBuffer.data(),
+                        std::min(room, static_cast<size_t>(bytesRead)));
+            }
+            else if (bytesRead == 0 || errno != EINTR)
+            {
+                close(program.outputFd);
+                program.outputFd = -1;
+            }
+        }
+
+        now = std::chrono::steady_clock::now();
+        for (auto programIter = programs.begin(); programIter != programs.end();)
+        {
+            RunningProgram& program = *programIter;
+
+            if (!program.timedOut && now >= program.deadline)
+            {
+                kill(program.pid, SIGKILL);
+                program.timedOut = true;
+            }
+
+            // A killed program's stdout may have been inherited by its own
+            // children, so its result isn't held up waiting for EOF
+            int status = 0;
+            if ((program.outputFd < 0 || program.timedOut) &&
+                    waitpid(program.pid, &status, WNOHANG) == program.pid)
+            {
+                int exitStatus = WIFEXITED(status) ? WEXITSTATUS(status) :
+                        (WIFSIGNALED(status) ? -WTERMSIG(status) : 0);
+                sendResult(program.requestId, 0, exitStatus, program.timedOut,
+                        program.output);
+                if (program.outputFd >= 0)
+                {
+                    close(program.outputFd);
+                }
+                programIter = programs.erase(programIter);
+                continue;
+            }
+            ++programIter;
+        }
+    }
+
+    for (RunningProgram& program : programs)
+    {
+        int status = 0;
+        kill(program.pid, SIGKILL);
+        (void) waitpid(program.pid, &status, 0);
+    }
+    _exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,110 @@
+/*
+ * ExecService.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+#ifndef SYSTEM_EXECSERVICE_HPP_
+#define SYSTEM_EXECSERVICE_HPP_
+
+// System Includes
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Project Includes
+// <none>
+
+// Foward declaration
+class ExecService;
+
+// Typedefs
+using ExecServiceSharedPtr = std::shared_ptr<ExecService>;
+
+/**
+ * Runs external programs without the daemon itself ever forking. start()
+ * forks a small, single threaded helper process, which must happen before
+ * the daemon creates any other thread. Each execute() call is sent to the
+ * helper over a socket; the helper posix_spawn()s the program, collects its
+ * stdout, kills it if it outlives its timeout, and sends the result back,
+ * where it's passed to the request's callback on this class's reader
+ * thread. Programs are run directly, never through /bin/sh.
+ *
+ * If the helper dies it isn't restarted, since forking again would no
+ * longer be safe; every outstanding and later request fails with EPIPE.
+ */
+class ExecService
+{
+public:
+    struct ExecResult
+    {
+        // 0, or the errno of a failure to spawn the program or reach the
+        // helper; the remaining fields are only meaningful if 0
+        int error;
+
+        // The exit code, or the negated number of the killing signal
+        int exitStatus;
+        bool timedOut;
+
+        // The program's stdout, cut off at MAX_OUTPUT_LENGTH bytes
+        std::string output;
+    };
+    using ExecCallback = std::function<void(const ExecResult& result)>;
+
+    // Forks the helper; throws a std::system_error on failure
+    static ExecServiceSharedPtr start();
+
+    // Runs args[0], found on PATH, with args as its argv. callback is
+    // executed once the program has exited or been killed for exceeding
+    // timeout, or immediately, on the calling thread, if the helper is gone.
+    void execute(const std::vector<std::string>& args, std::chrono::milliseconds timeout,
+            const ExecCallback& callback);
+
+    // execute(), waiting for the result; throws a std::system_error if the
+    // result's error isn't 0
+    ExecResult executeAndWait(const std::vector<std::string>& args,
+            std::chrono::milliseconds timeout);
+
+    // Stops the helper, which kills any programs still running; their
+    // callbacks, like those of any other outstanding requests, get EPIPE
+    ~ExecService();
+
+    ExecService(const ExecService&) = delete;
+    ExecService& operator=(const ExecService&) = delete;
+
+    static const size_t MAX_OUTPUT_LENGTH;
+
+private:
+    ExecService(int socketFd, pid_t helperPid);
+
+    void readerLoop();
+    void failAllPending(int error);
+
+    // Executed in the helper process, which never returns
+    [[noreturn]] static void helperMain(int socketFd);
+
+    // The daemon's end of the SOCK_SEQPACKET socket pair shared with the
+    // helper; each message is one request or one result
+    const int socketFd;
+    const pid_t helperPid;
+
+    // Callbacks of requests whose results haven't come back, by request id.
+    // helperGone is set once the reader thread has seen the helper exit.
+    uint64_t lastRequestId = 0;
+    std::unordered_map<uint64_t, ExecCallback> pendingCallbacks;
+    bool helperGone = false;
+    std::mutex pendingMutex;
+
+    // Receives results, and executes their callbacks
+    std::thread readerThread;
+};
+
+#endif /* SYSTEM_EXECSERVICE_HPP_ */
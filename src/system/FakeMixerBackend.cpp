@@ -0,0 +1,74 @@
+/*
+ * FakeMixerBackend.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+// System Includes
+// <none>
+
+// Project Includes
+#include "FakeMixerBackend.hpp"
+
+void FakeMixerBackend::setVolume(uint8_t percent)
+{
+    ++setCount;
+    changeVolume(percent);
+}
+
+std::string FakeMixerBackend::getName() const
+{
+    return "fake";
+}
+
+uint8_t FakeMixerBackend::getVolume()
+{
+    return volume;
+}
+
+bool FakeMixerBackend::canWatchForChanges() const
+{
+    return true;
+}
+
+bool FakeMixerBackend::waitForChange()
+{
+    std::unique_lock<std::mutex> changeLock{changeMutex};
+    changeCondition.wait(changeLock, [this]()
+    {
+        return interrupted || changeCount != lastSeenChangeCount;
+    });
+
+    lastSeenChangeCount = changeCount;
+    return !interrupted;
+}
+
+void FakeMixerBackend::interruptWait()
+{
+    std::lock_guard<std::mutex> changeLock{changeMutex};
+    interrupted = true;
+    changeCondition.notify_all();
+}
+
+void FakeMixerBackend::setExternalVolume(uint8_t percent)
+{
+    changeVolume(percent);
+}
+
+uint64_t FakeMixerBackend::getSetCount() const
+{
+    return setCount;
+}
+
+/**
+ * Like a real mixer, reports changes made through this backend as well as
+ * external ones
+ */
+void FakeMixerBackend::changeVolume(uint8_t percent)
+{
+    std::lock_guard<std::mutex> changeLock{changeMutex};
+    volume = percent;
+    ++changeCount;
+    changeCondition.notify_all();
+}
@@ -0,0 +1,57 @@
+/*
+ * FakeMixerBackend.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+#ifndef SYSTEM_FAKEMIXERBACKEND_HPP_
+#define SYSTEM_FAKEMIXERBACKEND_HPP_
+
+// System Includes
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+// Project Includes
+#include "MixerBackend.hpp"
+
+/**
+ * Keeps the volume in memory. For tests and benchmarks on machines without
+ * a sound card. Changes made by "other programs" are simulated with
+ * setExternalVolume().
+ */
+class FakeMixerBackend : public MixerBackend
+{
+public:
+    void setVolume(uint8_t percent) override;
+    std::string getName() const override;
+    uint8_t getVolume() override;
+    bool canWatchForChanges() const override;
+    bool waitForChange() override;
+    void interruptWait() override;
+
+    // Changes the volume as another program would, waking waitForChange()
+    void setExternalVolume(uint8_t percent);
+
+    // Number of setVolume() calls
+    uint64_t getSetCount() const;
+
+private:
+    void changeVolume(uint8_t percent);
+
+    std::atomic<uint8_t> volume{0};
+    std::atomic<uint64_t> setCount{0};
+
+    // Incremented on every change; waitForChange() returns once it differs
+    // from the value seen by the previous call. Guarded by changeMutex.
+    uint64_t changeCount = 0;
+    uint64_t lastSeenChangeCount = 0;
+    bool interrupted = false;
+    std::mutex changeMutex;
+    std::condition_variable changeCondition;
+};
+
+#endif /* SYSTEM_FAKEMIXERBACKEND_HPP_ */
@@ -0,0 +1,62 @@
+/*
+ * MixerBackend.hpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ */
+
+#ifndef SYSTEM_MIXERBACKEND_HPP_
+#define SYSTEM_MIXERBACKEND_HPP_
+
+// System Includes
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Project Includes
+// <none>
+
+// Foward declaration
+class MixerBackend;
+
+// Typedefs
+using MixerBackendSharedPtr = std::shared_ptr<MixerBackend>;
+
+/**
+ * Sets and reads the volume of the single mixer control which SystemUtils
+ * manages, and optionally watches it for changes made by other programs.
+ * Volumes are percentages on the mapped (perceptual) scale used by
+ * "amixer -M". setVolume() and getVolume() calls are serialized by
+ * SystemUtils, but may run concurrently with waitForChange(), which is only
+ * ever called from one thread.
+ */
+class MixerBackend
+{
+public:
+    virtual ~MixerBackend() {}
+
+    // Sets the control's playback volume, on all channels, to percent
+    // (0-100). Throws a std::system_error on failure.
+    virtual void setVolume(uint8_t percent) = 0;
+
+    // Reads the control's playback volume (of its first channel). Throws a
+    // std::system_error on failure.
+    virtual uint8_t getVolume() = 0;
+
+    // Whether waitForChange() can report changes; if not, it must not be
+    // called
+    virtual bool canWatchForChanges() const = 0;
+
+    // Blocks until the control may have changed, whether through this
+    // backend or any other program, returning true; or until
+    // interruptWait() has been called, returning false
+    virtual bool waitForChange() = 0;
+
+    // Makes the current and every later waitForChange() call return false
+    virtual void interruptWait() = 0;
+
+    // Identifies the backend in logs, e.g. "alsa"
+    virtual std::string getName() const = 0;
+};
+
+#endif /* SYSTEM_MIXERBACKEND_HPP_ */
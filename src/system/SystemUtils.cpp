@@ -6,6 +6,8 @@
  */
 
 // System Includes
+#include <algorithm>
+#include <cerrno>
 #include <cstring>
 #include <exception>
 #include <iostream>
@@ -14,22 +16,41 @@
 #include <system_error>
 
 // Project Includes
+#include "AmixerMixerBackend.hpp"
+#include "FakeMixerBackend.hpp"
 #include "SystemUtils.hpp"
+#ifdef NETSYSCTRLD_HAVE_ALSA
+#include "AlsaMixerBackend.hpp"
+#endif
 
 // Static Initialization
 
-// %s refers to the audio control (audioControlName), and %u is the percentage
-// to set
-const char SystemUtils::VOLUME_SETTER_FORMAT[] = "amixer set %s %u%% -M";
-
 // Use "Master" as the default control
 const std::string SystemUtils::DEFAULT_AUDIO_CONTROL_NAME = "Master";
 
+const char * const SystemUtils::ALSA_MIXER_TYPE = "alsa";
+const char * const SystemUtils::AMIXER_MIXER_TYPE = "amixer";
+const char * const SystemUtils::FAKE_MIXER_TYPE = "fake";
+
+const std::chrono::milliseconds SystemUtils::FADE_STEP_INTERVAL = std::chrono::milliseconds(20);
+const std::chrono::milliseconds SystemUtils::MAX_FADE_DURATION = std::chrono::minutes(10);
+
 // The user specifies "VOLUME=newvol" to set the volume
-const std::string SystemUtils::VOLUME_SETTER_COMMAND = "VOLUME";
+const char * const SystemUtils::VOLUME_SETTER_COMMAND = "VOLUME";
+
+const MetricsRegistry::Counter SystemUtils::MIXER_CALLS =
+        MetricsRegistry::getInstance().registerCounter("netsysctrld_mixer_calls_total",
+        "Volume changes made through the mixer backend");
+const MetricsRegistry::Counter SystemUtils::MIXER_CALL_FAILURES =
+        MetricsRegistry::getInstance().registerCounter("netsysctrld_mixer_call_failures_total",
+        "Volume changes which the mixer backend failed to make");
+const MetricsRegistry::Histogram SystemUtils::MIXER_CALL_DURATION =
+        MetricsRegistry::getInstance().registerHistogram("netsysctrld_mixer_call_duration_us",
+        "Time taken by the mixer backend to change the volume, in microseconds");
 
 /**
- * Sets the system volume to the percentage specified by the volume parameter.
+ * Sets the system volume to the percentage specified by the volume parameter,
+ * through the mixer backend.
  * std::system_error is thrown if an error occurred.
  * systemVolume member is updated if the volume is set properly.
  * Concurrent access to this function is protected using the volumeSetterMutex.
@@ -43,59 +64,355 @@ void SystemUtils::setVolume(const uint8_t vol)
         throw std::out_of_range("System volume cannot be greater than 100%");
     }
 
-    // The 3 accounts for the int value to be substituted
-    static char * volumeSetCommandBuff = new char[sizeof(VOLUME_SETTER_FORMAT) + audioControlName.length() + 3];
+    MIXER_CALLS.increment();
+    try
+    {
+        MetricsRegistry::ScopedTimer mixerCallTimer{MIXER_CALL_DURATION};
+        mixer->setVolume(vol);
+    }
+    catch (const std::system_error& err)
+    {
+        MIXER_CALL_FAILURES.increment();
+        throw;
+    }
 
-    // Substitute the new volume into the volume set command
-    (void) std::sprintf(volumeSetCommandBuff, VOLUME_SETTER_FORMAT, audioControlName.c_str(), vol);
+    // Update the sysVol variable to reflect the new system volume settings
+    updateSystemVolume(vol);
+}
 
-    std::cout << "Executing volume set command: " << volumeSetCommandBuff << std::endl;
+/**
+ * Hands vol to the applier thread and waits only until it's either applied
+ * or replaced by a newer request, so a burst of requests (e.g. a slider
+ * being dragged) costs one mixer call for the newest of them, rather than
+ * one queued call each. A std::out_of_range is thrown if vol is above 100,
+ * and the mixer's std::system_error is rethrown if applying vol failed.
+ */
+SystemUtils::VolumeOutcome SystemUtils::requestVolume(const uint8_t vol)
+{
+    if (vol > 100)
+    {
+        throw std::out_of_range("System volume cannot be greater than 100%");
+    }
 
-    int systemRetVal = system(volumeSetCommandBuff);
+    std::unique_lock<std::mutex> targetLock{targetMutex};
+    uint64_t sequence = submitVolumeLocked(vol);
+    awaitedVolumes[sequence];
 
-    if (systemRetVal != 0)
+    targetCondition.wait(targetLock, [this, sequence]()
     {
-        throw std::system_error(systemRetVal, std::generic_category(),
-                "Error when setting system volume using system()");
+        return awaitedVolumes[sequence].done;
+    });
+
+    AwaitedVolume awaited = awaitedVolumes[sequence];
+    awaitedVolumes.erase(sequence);
+    targetLock.unlock();
+
+    if (!awaited.error.empty())
+    {
+        throw std::system_error(EIO, std::generic_category(), awaited.error);
     }
+    return awaited.outcome;
+}
 
-    // Update the sysVol variable to reflect the new system volume settings
-    systemVolume = vol;
+/**
+ * Hands vol to the applier thread without waiting for it to be applied. If
+ * another volume is submitted before the applier picks this one up, this one
+ * is dropped. A std::out_of_range is thrown if vol is above 100.
+ */
+void SystemUtils::submitVolume(const uint8_t vol)
+{
+    if (vol > 100)
+    {
+        throw std::out_of_range("System volume cannot be greater than 100%");
+    }
+
+    std::lock_guard<std::mutex> targetLock{targetMutex};
+    submitVolumeLocked(vol);
+}
+
+/**
+ * Makes vol the pending volume, superseding the previous pending volume if
+ * there is one, and returns its sequence number. Expects targetMutex to be
+ * held.
+ */
+uint64_t SystemUtils::submitVolumeLocked(const uint8_t vol)
+{
+    if (pendingSequence != 0)
+    {
+        supersedeLocked(pendingSequence);
+    }
+
+    pendingSequence = ++lastSequence;
+    pendingVolume = vol;
+    targetCondition.notify_all();
+
+    return pendingSequence;
+}
+
+/**
+ * Completes the request with the given sequence number, if it's awaited, as
+ * superseded. Expects targetMutex to be held.
+ */
+void SystemUtils::supersedeLocked(uint64_t sequence)
+{
+    auto awaitedIter = awaitedVolumes.find(sequence);
+    if (awaitedIter != awaitedVolumes.end())
+    {
+        awaitedIter->second.done = true;
+        awaitedIter->second.outcome = VolumeOutcome::SUPERSEDED;
+    }
+}
+
+/**
+ * Executed by applierThread. Repeatedly takes the pending volume, if any,
+ * applies it, and completes its request. Volumes which were replaced while
+ * the previous one was being applied are never seen here.
+ */
+void SystemUtils::applierLoop()
+{
+    std::unique_lock<std::mutex> targetLock{targetMutex};
+
+    while (true)
+    {
+        targetCondition.wait(targetLock, [this]()
+        {
+            return stopping || pendingSequence != 0;
+        });
+        if (stopping)
+        {
+            return;
+        }
+
+        uint64_t sequence = pendingSequence;
+        uint8_t vol = pendingVolume;
+        pendingSequence = 0;
+
+        targetLock.unlock();
+        std::string error;
+        try
+        {
+            setVolume(vol);
+        }
+        catch (const std::exception& err)
+        {
+            error = err.what();
+            std::cerr << "Unable to apply volume: " << static_cast<unsigned>(vol)
+                    << "%; " << error << std::endl;
+        }
+        targetLock.lock();
+
+        auto awaitedIter = awaitedVolumes.find(sequence);
+        if (awaitedIter != awaitedVolumes.end())
+        {
+            awaitedIter->second.done = true;
+            awaitedIter->second.outcome = VolumeOutcome::APPLIED;
+            awaitedIter->second.error = error;
+        }
+        targetCondition.notify_all();
+    }
 }
 
 /**
- * Wrapper for setVolume(). Intended to be called by the command interpreter.
- * The vol param should be a percentage representing the new system volume.
- * After the volume is set, if there were no errors, all clients are informed
- * of the state change. If there was an error, it's propagated to the caller.
+ * Wrapper for requestVolume(). Intended to be called by the command
+ * interpreter. The vol param should be a percentage representing the new
+ * system volume. The response says whether the volume was APPLIED, or
+ * SUPERSEDED by a newer request before it could be. If there was an error,
+ * it's propagated to the caller.
  */
 void SystemUtils::setVolumeCommandHandler(const std::string& vol, std::string* updatableMessage)
 {
-    (void) updatableMessage;
+    size_t charsParsed = 0;
+    unsigned long volAsUl = std::stoul(vol, &charsParsed);
+
+    if (charsParsed != vol.length() || volAsUl > 100)
+    {
+        throw std::out_of_range("Volume: " + vol + " must be a percentage between 0 and 100");
+    }
 
+    // An explicitly requested volume supersedes any fade in progress
+    cancelFade();
+
+    VolumeOutcome outcome = requestVolume(static_cast<uint8_t>(volAsUl));
+
+    updatableMessage->append(outcome == VolumeOutcome::APPLIED ? "\nAPPLIED" : "\nSUPERSEDED");
+}
+
+/**
+ * For the FADE command. fadeInfo is expected to take the form
+ * <target volume>:<duration ms>. Ramps the volume linearly from its current
+ * value to the target over the duration, in FADE_STEP_INTERVAL steps run on
+ * the timer wheel, each of which submits its volume to the applier thread.
+ * Returns immediately; any fade already running is cancelled. Deviations
+ * from this format, a target above 100, or a duration outside 1ms to
+ * MAX_FADE_DURATION result in a std::invalid_argument being thrown.
+ */
+void SystemUtils::fadeVolumeCommandHandler(const std::string& fadeInfo, std::string* updatableMessage)
+{
+    auto colonIdx = fadeInfo.find(':');
+    if (colonIdx == std::string::npos || colonIdx == 0 || colonIdx == fadeInfo.length()-1)
+    {
+        throw std::invalid_argument("Syntax err: " + fadeInfo + "; It must have"
+                " the form \"targetVolume:durationMs\"");
+    }
+
+    unsigned long targetVolume;
+    unsigned long durationMs;
     try
     {
-        setVolume(static_cast<uint8_t>(std::stoul(vol)));
+        size_t targetChars = 0;
+        size_t durationChars = 0;
+        std::string targetString = fadeInfo.substr(0, colonIdx);
+        std::string durationString = fadeInfo.substr(colonIdx+1);
+        targetVolume = std::stoul(targetString, &targetChars);
+        durationMs = std::stoul(durationString, &durationChars);
+        if (targetChars != targetString.length() || durationChars != durationString.length())
+        {
+            throw std::invalid_argument("trailing characters");
+        }
     }
-    // Allow the exception to be propagated up while ensuring that the clients
-    // aren't updated in this error case
-    catch (const std::system_error& err)
+    catch (std::logic_error& except)
     {
-        throw err;
+        throw std::invalid_argument("Syntax err: " + fadeInfo + "; the target"
+                " volume and duration must be decimal numbers");
+    }
+
+    if (targetVolume > 100)
+    {
+        throw std::invalid_argument("Target volume: " + std::to_string(targetVolume) +
+                " must be a percentage between 0 and 100");
+    }
+    if (durationMs == 0 || durationMs > static_cast<unsigned long>(MAX_FADE_DURATION.count()))
+    {
+        throw std::invalid_argument("Fade duration: " + std::to_string(durationMs) +
+                "ms must be between 1 and " + std::to_string(MAX_FADE_DURATION.count()) + "ms");
+    }
+    if (!timerWheel)
+    {
+        throw std::logic_error("FADE is unavailable; no timer wheel in use");
+    }
+
+    uint8_t startVolume = getVolume();
+    uint32_t numSteps = static_cast<uint32_t>(std::max<unsigned long>(1,
+            durationMs / FADE_STEP_INTERVAL.count()));
+
+    std::lock_guard<std::mutex> fadeLock{fadeMutex};
+    if (fadeTimer != TimerWheel::INVALID_TIMER_ID)
+    {
+        timerWheel->cancel(fadeTimer);
+    }
+    scheduleFadeStep(++fadeGeneration, std::chrono::steady_clock::now(), startVolume,
+            static_cast<uint8_t>(targetVolume), 1, numSteps);
+
+    updatableMessage->append("\nFading from " + std::to_string(startVolume) + " to " +
+            std::to_string(targetVolume) + " over " + std::to_string(durationMs) +
+            "ms in " + std::to_string(numSteps) + " steps");
+}
+
+/**
+ * Schedules step stepIdx (1 to numSteps) of the fade with the given
+ * generation. Steps are timed from startTime rather than from the previous
+ * step, so timer lateness doesn't accumulate over the fade. Each step
+ * submits its volume without waiting, so a slow mixer drops intermediate
+ * steps rather than stretching the fade. Expects fadeMutex to be held.
+ */
+void SystemUtils::scheduleFadeStep(uint64_t generation,
+        std::chrono::steady_clock::time_point startTime, uint8_t startVolume,
+        uint8_t targetVolume, uint32_t stepIdx, uint32_t numSteps)
+{
+    auto stepTime = startTime + FADE_STEP_INTERVAL * stepIdx;
+    auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(
+            stepTime - std::chrono::steady_clock::now());
+
+    fadeTimer = timerWheel->schedule(std::max(delay, std::chrono::milliseconds(0)),
+            [this, generation, startTime, startVolume, targetVolume, stepIdx, numSteps]()
+    {
+        std::lock_guard<std::mutex> fadeLock{fadeMutex};
+        if (generation != fadeGeneration)
+        {
+            return;
+        }
+
+        int volumeDelta = static_cast<int>(targetVolume) - startVolume;
+        int stepVolume = startVolume + (volumeDelta * static_cast<int>(stepIdx) +
+                (volumeDelta >= 0 ? 1 : -1) * static_cast<int>(numSteps) / 2) /
+                static_cast<int>(numSteps);
+        submitVolume(static_cast<uint8_t>(stepVolume));
+
+        if (stepIdx < numSteps)
+        {
+            scheduleFadeStep(generation, startTime, startVolume, targetVolume,
+                    stepIdx+1, numSteps);
+        }
+        else
+        {
+            fadeTimer = TimerWheel::INVALID_TIMER_ID;
+        }
+    });
+}
+
+/**
+ * Stops the running fade, if any, leaving the volume wherever it has reached
+ */
+void SystemUtils::cancelFade()
+{
+    std::lock_guard<std::mutex> fadeLock{fadeMutex};
+    ++fadeGeneration;
+    if (fadeTimer != TimerWheel::INVALID_TIMER_ID)
+    {
+        timerWheel->cancel(fadeTimer);
+        fadeTimer = TimerWheel::INVALID_TIMER_ID;
     }
 }
 
 /*
  * Constructs a SystemUtils
  * Sets the audio control name to be used when changing the output volume
- * through the daemon.
- * The systemVolume is initialized to 0, but isn't accurate until the user
- * first sets it.
+ * through the daemon, and the mixer backend which applies the changes.
+ * The systemVolume is read from the mixer; if that fails it's left at 0
+ * until the volume is first set or a change is seen.
  */
-SystemUtils::SystemUtils(const std::string& audioControlName):
-        audioControlName(audioControlName), systemVolume(0)
+SystemUtils::SystemUtils(const std::string& audioControlName,
+        const MixerBackendSharedPtr& mixer, const TimerWheelSharedPtr& timerWheel):
+        audioControlName(audioControlName), systemVolume(0), mixer(mixer),
+        timerWheel(timerWheel)
 {
+    std::cout << "Using " << mixer->getName() << " mixer for control: "
+            << audioControlName << std::endl;
 
+    try
+    {
+        systemVolume = mixer->getVolume();
+        std::cout << "Initial volume: " << static_cast<int>(systemVolume) << "%" << std::endl;
+    }
+    catch (const std::system_error& err)
+    {
+        std::cerr << "Unable to read the initial volume: " << err.what() << std::endl;
+    }
+
+    applierThread = std::thread(&SystemUtils::applierLoop, this);
+}
+
+/**
+ * Cancels any fade, stops the monitor thread, and stops the applier thread
+ * once it has finished applying the volume it's working on, if any. Pending
+ * volumes are dropped.
+ */
+SystemUtils::~SystemUtils()
+{
+    cancelFade();
+
+    if (monitorThread.joinable())
+    {
+        mixer->interruptWait();
+        monitorThread.join();
+    }
+
+    {
+        std::lock_guard<std::mutex> targetLock{targetMutex};
+        stopping = true;
+        targetCondition.notify_all();
+    }
+    applierThread.join();
 }
 
 /**
@@ -106,6 +423,76 @@ uint8_t SystemUtils::getVolume()
     return systemVolume;
 }
 
+/**
+ * Stores callback, and starts monitorThread if the mixer backend can watch
+ * for changes. Changes made through setVolume() are reported either way.
+ * Only the first call starts the monitor; later calls replace the callback.
+ */
+void SystemUtils::startVolumeMonitor(const VolumeChangeCallback& callback)
+{
+    {
+        std::lock_guard<std::mutex> callbackLock{volumeChangeCallbackMutex};
+        volumeChangeCallback = callback;
+    }
+
+    if (!monitorThread.joinable() && mixer->canWatchForChanges())
+    {
+        monitorThread = std::thread(&SystemUtils::monitorLoop, this);
+        std::cout << "Watching the " << mixer->getName() << " mixer for volume changes"
+                << std::endl;
+    }
+}
+
+/**
+ * Stores vol as the system volume, executing the change callback if it
+ * differs from the previous value. Both setVolume() and monitorThread come
+ * through here, so a change made through this class and then reported by
+ * the mixer is only announced once. Executed with volumeSetterMutex held,
+ * which keeps the callbacks in the order the changes were made; the
+ * callback must hand anything slow, like socket writes, off to another
+ * thread.
+ */
+void SystemUtils::updateSystemVolume(uint8_t vol)
+{
+    if (systemVolume.exchange(vol) == vol)
+    {
+        return;
+    }
+
+    VolumeChangeCallback callback;
+    {
+        std::lock_guard<std::mutex> callbackLock{volumeChangeCallbackMutex};
+        callback = volumeChangeCallback;
+    }
+    if (callback)
+    {
+        callback(vol);
+    }
+}
+
+/**
+ * Run on monitorThread; rereads the volume each time the mixer reports a
+ * possible change, until the destructor interrupts the wait. Errors end
+ * monitoring, leaving systemVolume as last read.
+ */
+void SystemUtils::monitorLoop()
+{
+    try
+    {
+        while (mixer->waitForChange())
+        {
+            // Serialized with setVolume(), so a stale read can't overwrite
+            // a newer volume set in between
+            std::lock_guard<std::mutex> volumeSetterGuard{volumeSetterMutex};
+            updateSystemVolume(mixer->getVolume());
+        }
+    }
+    catch (const std::system_error& err)
+    {
+        std::cerr << "Stopped watching for volume changes: " << err.what() << std::endl;
+    }
+}
+
 SystemUtils::Builder& SystemUtils::Builder::withAudioControlName(const char* audioControlName)
 {
     if (audioControlName == nullptr)
@@ -118,7 +505,89 @@ SystemUtils::Builder& SystemUtils::Builder::withAudioControlName(const char* aud
     return *this;
 }
 
+/**
+ * Selects the mixer backend by type: ALSA_MIXER_TYPE, AMIXER_MIXER_TYPE or
+ * FAKE_MIXER_TYPE. Any other type, or ALSA_MIXER_TYPE in a build without
+ * libasound, results in a std::invalid_argument being thrown.
+ */
+SystemUtils::Builder& SystemUtils::Builder::withMixerType(const std::string& mixerType)
+{
+    if (mixerType != ALSA_MIXER_TYPE && mixerType != AMIXER_MIXER_TYPE &&
+        mixerType != FAKE_MIXER_TYPE)
+    {
+        throw std::invalid_argument("Unknown mixer type: " + mixerType + "; it must be one"
+                " of " + ALSA_MIXER_TYPE + ", " + AMIXER_MIXER_TYPE + " or " + FAKE_MIXER_TYPE);
+    }
+
+#ifndef NETSYSCTRLD_HAVE_ALSA
+    if (mixerType == ALSA_MIXER_TYPE)
+    {
+        throw std::invalid_argument("This build doesn't support the alsa mixer;"
+                " libasound wasn't found");
+    }
+#endif
+
+    this->mixerType = mixerType;
+    return *this;
+}
+
+/**
+ * Specifies the mixer backend instance to use; takes precedence over
+ * withMixerType()
+ */
+SystemUtils::Builder& SystemUtils::Builder::withMixerBackend(const MixerBackendSharedPtr& mixerBackend)
+{
+    this->mixerBackend = mixerBackend;
+    return *this;
+}
+
 SystemUtilsSharedPtr SystemUtils::Builder::build()
 {
-    return SystemUtilsSharedPtr(new SystemUtils(audioControlName));
+    return SystemUtilsSharedPtr(new SystemUtils(audioControlName,
+            mixerBackend ? mixerBackend : createMixerBackend(), timerWheel));
+}
+
+/**
+ * Specifies the TimerWheel on which FADE steps are scheduled
+ */
+SystemUtils::Builder& SystemUtils::Builder::withTimerWheel(const TimerWheelSharedPtr& timerWheel)
+{
+    this->timerWheel = timerWheel;
+    return *this;
+}
+
+/**
+ * Specifies the ExecService through which external programs, such as
+ * amixer's volume queries, are run
+ */
+SystemUtils::Builder& SystemUtils::Builder::withExecService(const ExecServiceSharedPtr& execService)
+{
+    this->execService = execService;
+    return *this;
+}
+
+/**
+ * Creates the backend selected with withMixerType(). If no type was given,
+ * the amixer backend is used; the alsa backend has to be asked for, as it
+ * hasn't yet been proven on real devices.
+ */
+MixerBackendSharedPtr SystemUtils::Builder::createMixerBackend() const
+{
+    if (mixerType == FAKE_MIXER_TYPE)
+    {
+        return std::make_shared<FakeMixerBackend>();
+    }
+    else if (mixerType == AMIXER_MIXER_TYPE)
+    {
+        return std::make_shared<AmixerMixerBackend>(audioControlName, execService);
+    }
+
+#ifdef NETSYSCTRLD_HAVE_ALSA
+    if (mixerType == ALSA_MIXER_TYPE)
+    {
+        return std::make_shared<AlsaMixerBackend>(audioControlName);
+    }
+#endif
+
+    return std::make_shared<AmixerMixerBackend>(audioControlName, execService);
 }
@@ -10,13 +10,21 @@
 
 // System Includes
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
 #include <mutex>
 #include <string>
 #include <stdint.h>
 #include <memory>
+#include <thread>
+#include <unordered_map>
 
 // Project Includes
-// <none>
+#include "ExecService.hpp"
+#include "MetricsRegistry.hpp"
+#include "MixerBackend.hpp"
+#include "TimerWheel.hpp"
 
 
 class SystemUtils;
@@ -25,44 +33,144 @@ using SystemUtilsSharedPtr = std::shared_ptr<SystemUtils>;
 class SystemUtils
 {
 public:
+    // What became of a volume handed to requestVolume()
+    enum class VolumeOutcome
+    {
+        APPLIED, SUPERSEDED
+    };
+
     void setVolume(const uint8_t vol);
 
+    // Latest-wins volume changes, applied on the applier thread
+    VolumeOutcome requestVolume(const uint8_t vol);
+    void submitVolume(const uint8_t vol);
+
     uint8_t getVolume();
 
+    // Executed with the new volume whenever it changes, whether through this
+    // class or another program. Runs on the applier or monitor thread,
+    // with volume changes held off so that changes are reported in order,
+    // so it mustn't block; TcpServer only queues the events it sends.
+    using VolumeChangeCallback = std::function<void(uint8_t volume)>;
+
+    // Starts watching the mixer for changes made by other programs, if the
+    // backend supports it, and reports every change to callback
+    void startVolumeMonitor(const VolumeChangeCallback& callback);
+
+    ~SystemUtils();
+
     // Meant only to be called by the command parser
     void setVolumeCommandHandler(const std::string& vol, std::string* updatableMessage);
+    void fadeVolumeCommandHandler(const std::string& fadeInfo, std::string* updatableMessage);
 
-    // The user specifies "VOLUME=newvol" to set the volume
-    static const std::string VOLUME_SETTER_COMMAND;
+    // The user specifies "VOLUME=newvol" to set the volume. A constant
+    // pointer rather than a std::string, so that it's initialized before
+    // the command tables of other translation units are built from it.
+    static const char * const VOLUME_SETTER_COMMAND;
 
     class Builder
     {
     public:
         Builder() {};
         Builder& withAudioControlName(const char* audioControlName);
+        Builder& withMixerType(const std::string& mixerType);
+        Builder& withMixerBackend(const MixerBackendSharedPtr& mixerBackend);
+        Builder& withTimerWheel(const TimerWheelSharedPtr& timerWheel);
+        Builder& withExecService(const ExecServiceSharedPtr& execService);
         SystemUtilsSharedPtr build();
     private:
+        MixerBackendSharedPtr createMixerBackend() const;
+
         std::string audioControlName = DEFAULT_AUDIO_CONTROL_NAME;
+        std::string mixerType;
+        MixerBackendSharedPtr mixerBackend;
+        TimerWheelSharedPtr timerWheel;
+        ExecServiceSharedPtr execService;
     };
 
+    // The mixer types accepted by Builder::withMixerType()
+    static const char * const ALSA_MIXER_TYPE;
+    static const char * const AMIXER_MIXER_TYPE;
+    static const char * const FAKE_MIXER_TYPE;
+
 private:
 
-    SystemUtils(const std::string& audioControlName = DEFAULT_AUDIO_CONTROL_NAME);
+    SystemUtils(const std::string& audioControlName, const MixerBackendSharedPtr& mixer,
+            const TimerWheelSharedPtr& timerWheel);
 
-    static const char VOLUME_SETTER_FORMAT[];
+    // The state of a requestVolume() call which is waiting for its outcome
+    struct AwaitedVolume
+    {
+        bool done = false;
+        VolumeOutcome outcome = VolumeOutcome::SUPERSEDED;
+        std::string error;
+    };
+
+    uint64_t submitVolumeLocked(const uint8_t vol);
+    void supersedeLocked(uint64_t sequence);
+    void applierLoop();
+
+    // Change monitoring
+    void updateSystemVolume(uint8_t vol);
+    void monitorLoop();
+
+    // Fades
+    void scheduleFadeStep(uint64_t generation, std::chrono::steady_clock::time_point startTime,
+            uint8_t startVolume, uint8_t targetVolume, uint32_t stepIdx, uint32_t numSteps);
+    void cancelFade();
+
+    // Fades are applied in steps of this length
+    static const std::chrono::milliseconds FADE_STEP_INTERVAL;
+    static const std::chrono::milliseconds MAX_FADE_DURATION;
 
     static const std::string DEFAULT_AUDIO_CONTROL_NAME;
 
+    static const MetricsRegistry::Counter MIXER_CALLS;
+    static const MetricsRegistry::Counter MIXER_CALL_FAILURES;
+    static const MetricsRegistry::Histogram MIXER_CALL_DURATION;
+
     // The name of the audio control to be used when changing the volume
     const std::string audioControlName;
 
-    // The system volume. Uninitialized to a valid value until the first call
-    // to setVolume()
+    // The system volume. Read from the mixer at construction, and kept
+    // current by setVolume() and monitorThread.
     std::atomic<uint8_t> systemVolume;
 
+    // Applies volume changes to the system
+    const MixerBackendSharedPtr mixer;
+
     // Used to prevent clients from trying to change the volume simultaneously
     std::mutex volumeSetterMutex;
 
+    // The newest volume which has been requested but not yet picked up by
+    // applierThread. Each request gets the next sequence number; 0 means no
+    // volume is pending. A request replaced before being picked up is
+    // superseded. All guarded by targetMutex.
+    uint64_t lastSequence = 0;
+    uint64_t pendingSequence = 0;
+    uint8_t pendingVolume = 0;
+    std::unordered_map<uint64_t, AwaitedVolume> awaitedVolumes;
+    bool stopping = false;
+    std::mutex targetMutex;
+    std::condition_variable targetCondition;
+
+    // Applies pending volumes, one at a time, through setVolume()
+    std::thread applierThread;
+
+    // Executes fade steps. At most one fade runs at a time; starting a fade
+    // or setting the volume cancels the running one. A step whose generation
+    // isn't fadeGeneration belongs to a cancelled fade and does nothing.
+    const TimerWheelSharedPtr timerWheel;
+    uint64_t fadeGeneration = 0;
+    TimerWheel::TimerId fadeTimer = TimerWheel::INVALID_TIMER_ID;
+    std::mutex fadeMutex;
+
+    // Watches the mixer for changes made by other programs; only started if
+    // the mixer backend can do so
+    std::thread monitorThread;
+    VolumeChangeCallback volumeChangeCallback;
+    std::mutex volumeChangeCallbackMutex;
+
 };
 
 #endif /* SYSTEM_SYSTEMUTILS_HPP_ */
@@ -0,0 +1,267 @@
+/*
+ * JournalDump.cpp
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: bensherman
+ *
+ * Prints the records of a command journal written by netsysctrld -j, one
+ * line per command, oldest first:
+ *
+ *   2026-10-19T17:02:11.482913067Z 192.168.1.20:51034 OUTPUT_STATE=led:1 ok ~OK
+ *
+ * Arguments are journal directories, whose segments are dumped in index
+ * order, or individual segment files. Records left half written by a crash,
+ * and any gaps where a record's length wasn't written, are reported on
+ * stderr and skipped. Control characters in results are
+ * escaped, so multi-line results stay on one line.
+ */
+
+// System Includes
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <dirent.h>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <sys/stat.h>
+#include <utility>
+#include <vector>
+
+// Project Includes
+#include "JournalFormat.hpp"
+
+static void printUsage(const char* programName)
+{
+    std::cerr << "Usage: " << programName << " JOURNAL_DIRECTORY|SEGMENT_FILE..." << std::endl;
+}
+
+static std::string formatTimestamp(int64_t timestampNs)
+{
+    time_t seconds = static_cast<time_t>(timestampNs / 1000000000);
+    long nanoseconds = static_cast<long>(timestampNs % 1000000000);
+    struct tm utcTime;
+    gmtime_r(&seconds, &utcTime);
+
+    char dateTime[32];
+    std::strftime(dateTime, sizeof(dateTime), "%Y-%m-%dT%H:%M:%S", &utcTime);
+    char formatted[48];
+    std::snprintf(formatted, sizeof(formatted), "%s.%09ldZ", dateTime, nanoseconds);
+    return formatted;
+}
+
+static std::string escapeControlChars(const std::string& str)
+{
+    std::string escaped;
+    for (char strChar : str)
+    {
+        if (strChar == '\n')
+        {
+            escaped.append("\\n");
+        }
+        else if (strChar == '\r')
+        {
+            escaped.append("\\r");
+        }
+        else if (static_cast<unsigned char>(strChar) < 0x20)
+        {
+            char hexEscape[8];
+            std::snprintf(hexEscape, sizeof(hexEscape), "\\x%02x", static_cast<unsigned char>(strChar));
+            escaped.append(hexEscape);
+        }
+        else
+        {
+            escaped.push_back(strChar);
+        }
+    }
+    return escaped;
+}
+
+/**
+ * Whether record, at offset, has a length which keeps it within the segment
+ */
+static bool isValidLength(const JournalFormat::RecordHeader& record, size_t offset,
+        size_t segmentSize)
+{
+    return record.length >= sizeof(record) &&
+            record.length % JournalFormat::RECORD_ALIGNMENT == 0 &&
+            record.length <= segmentSize - offset;
+}
+
+/**
+ * Whether record was completely written, with strings which fit in it
+ */
+static bool isCommitted(const JournalFormat::RecordHeader& record)
+{
+    const size_t stringsLength = static_cast<size_t>(record.clientAddressLength) +
+            record.commandLength + record.paramLength + record.resultLength;
+    return record.committed == JournalFormat::COMMITTED &&
+            sizeof(record) + stringsLength <= record.length;
+}
+
+/**
+ * Returns the offset of the first committed record after offset, or 0 if
+ * there are none. Records are only ever written at aligned offsets, so only
+ * those are tried.
+ */
+static size_t findNextCommittedRecord(const std::vector<char>& segment, size_t offset,
+        size_t segmentSize)
+{
+    for (size_t candidateOffset = offset + JournalFormat::RECORD_ALIGNMENT;
+            candidateOffset + sizeof(JournalFormat::RecordHeader) <= segmentSize;
+            candidateOffset += JournalFormat::RECORD_ALIGNMENT)
+    {
+        JournalFormat::RecordHeader candidate;
+        std::memcpy(&candidate, segment.data() + candidateOffset, sizeof(candidate));
+        if (isValidLength(candidate, candidateOffset, segmentSize) && isCommitted(candidate))
+        {
+            return candidateOffset;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Returns false if path couldn't be read or isn't a valid segment. Where a
+ * record can't be read, the segment is scanned for the next committed one,
+ * so a writer which died mid-record doesn't hide the records after it.
+ */
+static bool dumpSegment(const std::string& path)
+{
+    std::ifstream segmentFile(path, std::ios::binary);
+    if (!segmentFile)
+    {
+        std::cerr << path << ": unable to open: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    std::vector<char> segment((std::istreambuf_iterator<char>(segmentFile)),
+            std::istreambuf_iterator<char>());
+
+    JournalFormat::SegmentHeader header;
+    if (segment.size() < sizeof(header))
+    {
+        std::cerr << path << ": too short to be a journal segment" << std::endl;
+        return false;
+    }
+    std::memcpy(&header, segment.data(), sizeof(header));
+    if (header.magic != JournalFormat::MAGIC || header.version != JournalFormat::VERSION ||
+            header.segmentSize > segment.size())
+    {
+        std::cerr << path << ": not a version " << JournalFormat::VERSION
+                << " journal segment" << std::endl;
+        return false;
+    }
+
+    size_t offset = sizeof(header);
+    while (offset + sizeof(JournalFormat::RecordHeader) <= header.segmentSize)
+    {
+        JournalFormat::RecordHeader record;
+        std::memcpy(&record, segment.data() + offset, sizeof(record));
+        if (!isValidLength(record, offset, header.segmentSize))
+        {
+            size_t nextOffset = findNextCommittedRecord(segment, offset, header.segmentSize);
+            if (nextOffset == 0)
+            {
+                break;
+            }
+            std::cerr << path << ": skipped " << nextOffset - offset << " bytes at offset "
+                    << offset << " which hold no readable record" << std::endl;
+            offset = nextOffset;
+            continue;
+        }
+
+        if (!isCommitted(record))
+        {
+            std::cerr << path << ": record at offset " << offset
+                    << " wasn't completely written; skipping it" << std::endl;
+            offset += record.length;
+            continue;
+        }
+
+        const char* strings = segment.data() + offset + sizeof(record);
+        std::string clientAddress(strings, record.clientAddressLength);
+        strings += record.clientAddressLength;
+        std::string command(strings, record.commandLength);
+        strings += record.commandLength;
+        std::string param(strings, record.paramLength);
+        strings += record.paramLength;
+        std::string result(strings, record.resultLength);
+
+        std::cout << formatTimestamp(record.timestampNs) << " " << clientAddress << ":"
+                << record.clientPort << " " << command << "=" << param << " "
+                << (record.succeeded ? "ok" : "failed") << " " << escapeControlChars(result)
+                << "\n";
+
+        offset += record.length;
+    }
+
+    return true;
+}
+
+/**
+ * Returns false if directoryPath couldn't be read, or any of its segments
+ * couldn't be dumped
+ */
+static bool dumpDirectory(const std::string& directoryPath)
+{
+    DIR* dir = opendir(directoryPath.c_str());
+    if (!dir)
+    {
+        std::cerr << directoryPath << ": unable to open: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    std::vector<std::pair<uint64_t, std::string>> segmentFiles;
+    while (struct dirent* entry = readdir(dir))
+    {
+        uint64_t segmentIndex;
+        if (JournalFormat::parseSegmentFileName(entry->d_name, segmentIndex))
+        {
+            segmentFiles.emplace_back(segmentIndex, directoryPath + "/" + entry->d_name);
+        }
+    }
+    closedir(dir);
+    std::sort(segmentFiles.begin(), segmentFiles.end());
+
+    bool dumped = true;
+    for (const std::pair<uint64_t, std::string>& segmentFile : segmentFiles)
+    {
+        dumped = dumpSegment(segmentFile.second) && dumped;
+    }
+    return dumped;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || std::strcmp(argv[1], "-h") == 0)
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    bool dumped = true;
+    for (int argIdx = 1; argIdx < argc; ++argIdx)
+    {
+        struct stat pathStat;
+        if (stat(argv[argIdx], &pathStat) != 0)
+        {
+            std::cerr << argv[argIdx] << ": " << std::strerror(errno) << std::endl;
+            dumped = false;
+        }
+        else if (S_ISDIR(pathStat.st_mode))
+        {
+            dumped = dumpDirectory(argv[argIdx]) && dumped;
+        }
+        else
+        {
+            dumped = dumpSegment(argv[argIdx]) && dumped;
+        }
+    }
+
+    std::cout.flush();
+    return dumped ? 0 : 1;
+}